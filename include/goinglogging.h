@@ -3,7 +3,7 @@
  *
  * \section section_description Description
  *
- * \e goinglogging is an open source, lightweight, multiplatform, single header
+ * \e goinglogging is an open source, lightweight, multiplatform, header-only
  * C++11 library that logs information to command line or file. This is useful
  * when debugging realtime systems where compiling with debug symbols and/or a
  * low optimization level will slow down the program too much. This library is
@@ -59,11 +59,62 @@
  * int i[][] = {{0, 11}, {22, 33}};
  * l_mat(i, 2, 2);
  * \endcode
- * \sa l_mat()
+ * Matrices in flat buffers, e.g. of BLAS, with a stride between rows or
+ * columns:
+ * \code
+ * l_mat_flat(p, cols, rows, stride, gl::layout::COLUMN_MAJOR);
+ * \endcode
+ * Output one line per row, without index of each value, with
+ * gl::set_matrix_format(gl::matrix_format::GRID).
+ * \sa l_mat() \sa l_mat_flat() \sa set_matrix_format()
+ *
+ * \subsection section_bytes Bytes
+ * \code
+ * l_hex(packet, len);
+ * l_bytes(packet, len);
+ * \endcode
+ * \sa l_hex() \sa l_bytes() \sa set_hex_width() \sa set_max_bytes()
+ *
+ * \subsection section_large Large containers
+ * Limit the number of elements output of containers, arrays and matrices
+ * with:
+ * \code
+ * gl::set_max_elements(4);
+ * std::vector<int> v(100);
+ * std::iota(v.begin(), v.end(), 0);
+ * l(v);
+ * l_arr_n(v, 100, 2);
+ * \endcode
+ * Which outputs:
+ * \code
+ * v = {0, 1, ... (96 more), 98, 99}
+ * v = {0, ... (98 more), 99}
+ * \endcode
+ * Output number of elements, minimum, maximum and mean of numbers instead
+ * with gl::set_truncation(gl::truncation::SUMMARIZE).
+ * \sa set_max_elements() \sa set_truncation() \sa l_arr_n() \sa l_mat_n()
+ *
+ * \subsection section_floating Floating point values
+ * Are output like \c std::ostream does by default. To instead output the
+ * fewest digits that read back to the same value:
+ * \code
+ * gl::set_float_format(gl::float_format::ROUND_TRIP);
+ * double d = 0.1;
+ * l(d);
+ * \endcode
+ * Which outputs:
+ * \code
+ * d = 0.1
+ * \endcode
+ * \sa set_float_format()
  *
  * \subsection section_custom_objects Custom objects
  * Can output any object with an overloaded << operator.
  *
+ * Each message starts with the default formatting of \c std::ostream.
+ * Manipulators, such as \c std::hex, used by an operator apply to the rest
+ * of its message only, and formatting set on \c std::cout is not used.
+ *
  * \subsection section_prefixes Prefixes
  * Output file, line, and other information by using:
  * \code
@@ -83,19 +134,130 @@
  * \endcode
  * \sa set_output_enabled()
  *
- * \subsection section_flush_output Flush output
- * goinglogging will not flush output by default. To ensure it flushes, use:
+ * \subsection section_levels Levels
+ * Log at a severity level with e.g. \ref l_debug(), \ref l_arr_debug() and
+ * \ref l_mat_debug(). Filter at runtime:
  * \code
- * #define GL_NEWLINE std::endl
+ * gl::set_level(gl::level::L_INFO);
+ * \endcode
+ * Remove lower levels from the binary altogether:
+ * \code
+ * #define GL_ACTIVE_LEVEL GL_LEVEL_INFO
  * #include "goinglogging.h"
  * \endcode
+ * \sa set_level() \sa GL_ACTIVE_LEVEL
+ *
+ * \subsection section_filter Filter
+ * Only output messages of some files and functions, without recompiling:
+ * \code
+ * gl::set_filter("motor_*.cpp, main.cpp:run");
+ * \endcode
+ * \sa set_filter()
+ *
+ * \subsection section_rate Rate limiting
+ * Log from hot loops without flooding the output:
+ * \code
+ * l_every_n(1000, i);
+ * l_every_ms(100, i);
+ * l_once(i);
+ * l_when(i == 5, i);
+ * \endcode
+ * \sa set_suppressed_summary_enabled()
+ *
+ * \subsection section_changed Log changes only
+ * Log variables only when they changed since the previous call:
+ * \code
+ * l_changed(state);
+ * \endcode
+ * \sa l_changed() \sa set_previous_values_enabled()
+ *
+ * \subsection section_scope Time a scope
+ * Log the time spent in a scope when it ends, or a summary of the times every
+ * 1000 calls:
+ * \code
+ * l_scope("parse");
+ * l_timer("handle", 1000);
+ * \endcode
+ * \sa l_scope() \sa l_timer() \sa log_timers()
+ *
+ * \subsection section_flush_output Flush output
+ * goinglogging will not flush output by default. To flush when 4 KiB are
+ * pending or 100 ms after the first unflushed message, use:
+ * \code
+ * gl::set_flush_bytes(4096);
+ * gl::set_flush_interval(100);
+ * \endcode
+ * Flush explicitly, e.g. before forking, with gl::flush(). Output is also
+ * flushed at exit and, if enabled, on crash.
+ * \sa set_flush_bytes() \sa set_flush_interval() \sa flush()
+ * \sa set_crash_flush_enabled()
  *
  * \subsection section_redirect Redirect
- * Redirect output to file:
+ * Redirect output to file, without affecting std::cout:
+ * \code
+ * gl::set_sink(std::make_shared<gl::BufferedFileSink>("f.txt"));
+ * \endcode
+ * Built-in sinks are OstreamSink, FdSink, BufferedFileSink, NullSink and, on
+ * POSIX systems, RingFileSink, which keeps the latest output even if the
+ * process crashes.
+ * \sa set_sink()
+ *
+ * \subsection section_add_sink Multiple sinks
+ * Also write to further sinks, each with its own prefixes and color:
+ * \code
+ * gl::add_sink(std::make_shared<gl::BufferedFileSink>("f.txt"),
+ *     gl::prefix::TIME | gl::prefix::FILE | gl::prefix::LINE);
+ * \endcode
+ * A message is formatted once, and an own thread per added sink writes it.
+ * \sa add_sink() \sa remove_sink()
+ *
+ * \subsection section_async Asynchronous output
+ * Move formatted output off the calling thread:
+ * \code
+ * gl::set_async_overflow(gl::overflow::DROP_NEWEST);
+ * gl::set_async_enabled(true);
+ * \endcode
+ * A background thread then writes logging messages in batches.
+ * \sa set_async_enabled() \sa set_async_overflow() \sa get_dropped_count()
+ *
+ * \subsection section_deferred Deferred formatting
+ * Also move formatting of l() variables to the background thread:
+ * \code
+ * gl::set_deferred_enabled(true);
+ * \endcode
+ * Variables are copied and formatted later. Specialize gl::is_deferrable for
+ * other copyable types.
+ * \sa set_deferred_enabled() \sa is_deferrable
+ *
+ * \subsection section_binary Binary output
+ * Skip formatting on the hot path altogether:
+ * \code
+ * gl::set_sink(std::make_shared<gl::BufferedFileSink>("log.bin"));
+ * gl::set_format(gl::format::BINARY);
+ * \endcode
+ * Each logging message is then written as a call site id, a timestamp and
+ * the raw bytes of its arguments. Render it as text later with the gl_decode
+ * tool, or with \ref decode_binary().
+ * \sa set_format()
+ *
+ * \subsection section_structured JSON and CSV output
+ * Output one JSON object or CSV row per message, for parsing by other
+ * programs:
  * \code
- * std::ofstream f("f.txt");
- * std::cout.rdbuf(f.rdbuf());
+ * gl::set_format(gl::format::JSON);
  * \endcode
+ * \sa set_format()
+ *
+ * \subsection section_stats Statistics
+ * Find out how much time is spent logging, and where:
+ * \code
+ * gl::set_stats_enabled(true);
+ * ...
+ * gl::write_stats(std::cerr, 5);
+ * \endcode
+ * Which outputs the number of logging messages, bytes of output and time
+ * spent logging, followed by the five most called call sites.
+ * \sa set_stats_enabled() \sa get_stats() \sa write_stats()
  *
  * \subsection section_color Color
  * Enable colored output in terminals that support ANSI control sequences:
@@ -104,6 +266,17 @@
  * \endcode
  * \sa set_color_enabled()
  *
+ * \subsection section_compile_time Compile time
+ * Include less by only including the core and the formatting that is used:
+ * \code
+ * #define GL_CORE_ONLY
+ * #include "goinglogging.h"
+ * #include "goinglogging_containers.h"
+ * \endcode
+ * Instantiate the logging of commonly logged types once, in the library
+ * built from src/goinglogging.cpp, by defining GL_EXTERN_TEMPLATES.
+ * \sa GL_CORE_ONLY \sa GL_EXTERN_TEMPLATES
+ *
  */
 
 /** \file
@@ -115,37 +288,157 @@
 #ifndef INCLUDE_GOINGLOGGING_H_
 #define INCLUDE_GOINGLOGGING_H_
 
-#include <array>
+#include <algorithm>
+#include <atomic>
 #include <chrono>
-#include <codecvt>
-#include <complex>
+#include <cmath>
+#include <condition_variable>
+#include <csignal>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
 #include <cstring>
 #include <ctime>
-#include <deque>
-#include <forward_list>
-#include <iomanip>
 #include <ios>
 #include <iostream>
-#include <list>
-#include <map>
+#include <iterator>
+#include <limits>
+#include <locale>
 #include <memory>
+#include <new>
+#include <mutex>
 #include <ostream>
-#include <queue>
 #include <ratio>
-#include <set>
 #include <sstream>
-#include <stack>
 #include <string>
 #include <thread>
+#include <tuple>
+#include <type_traits>
+#include <typeinfo>
 #include <unordered_map>
-#include <unordered_set>
-#include <valarray>
+#include <utility>
 #include <vector>
 
+#include <cerrno>
+#include <fcntl.h>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif // _WIN32
+
 #ifdef __GNUC__
 #include <cxxabi.h>
 #endif // __GNUC__
 
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#ifndef DOXYGEN_HIDDEN
+#define GL_INTERNAL_SSE2
+#endif // DOXYGEN_HIDDEN
+#endif // __SSE2__
+
+#ifndef DOXYGEN_HIDDEN
+#ifdef __GNUC__
+#define GL_UNLIKELY(x) __builtin_expect(!!(x), 0)
+#else
+#define GL_UNLIKELY(x) (x)
+#endif // __GNUC__
+#endif // DOXYGEN_HIDDEN
+
+/**
+ * \brief Numeric value of level::L_TRACE, for use in the preprocessor.
+ */
+#define GL_LEVEL_TRACE 0
+/**
+ * \brief Numeric value of level::L_DEBUG, for use in the preprocessor.
+ */
+#define GL_LEVEL_DEBUG 1
+/**
+ * \brief Numeric value of level::L_INFO, for use in the preprocessor.
+ */
+#define GL_LEVEL_INFO 2
+/**
+ * \brief Numeric value of level::L_WARNING, for use in the preprocessor.
+ */
+#define GL_LEVEL_WARNING 3
+/**
+ * \brief Numeric value of level::L_ERROR, for use in the preprocessor.
+ */
+#define GL_LEVEL_ERROR 4
+/**
+ * \brief Numeric value of level::L_OFF, for use in the preprocessor.
+ */
+#define GL_LEVEL_OFF 5
+
+#ifndef GL_ACTIVE_LEVEL
+/**
+ * \brief Lowest level compiled into the program.
+ *
+ * Logging macros of a lower level expand to nothing, so neither their
+ * arguments nor their formatting code end up in the binary:
+ * \code
+ * #define GL_ACTIVE_LEVEL GL_LEVEL_INFO
+ * #include "goinglogging.h"
+ * \endcode
+ * GL_LEVEL_OFF also removes \ref l(), \ref l_arr() and \ref l_mat().
+ *
+ * \note Defaults to GL_LEVEL_TRACE, i.e. everything is compiled.
+ *
+ * \sa set_level()
+ *
+ */
+#define GL_ACTIVE_LEVEL GL_LEVEL_TRACE
+#endif // GL_ACTIVE_LEVEL
+
+#ifdef DOXYGEN_HIDDEN
+/**
+ * \brief Define before including goinglogging.h to only include the core.
+ *
+ * The core formats numbers, characters, C strings, std::string, smart
+ * pointers, std::pair, std::tuple, Array, Matrix and types with an
+ * operator<<. Include what else is logged:
+ * - goinglogging_containers.h: Standard containers, std::complex and
+ *   std::valarray.
+ * - goinglogging_streams.h: String buffers, string streams and std::locale.
+ * - goinglogging_wide.h: std::u16string, std::u32string and std::wstring.
+ *
+ * \code
+ * #define GL_CORE_ONLY
+ * #include "goinglogging.h"
+ * #include "goinglogging_containers.h"
+ * \endcode
+ *
+ * \note Translation units of a program may differ in this setting.
+ *
+ * \sa GL_EXTERN_TEMPLATES
+ *
+ */
+#define GL_CORE_ONLY
+
+/**
+ * \brief Define to use the logging of commonly logged types instantiated by
+ * the library built from src/goinglogging.cpp, instead of instantiating it
+ * in each translation unit.
+ *
+ * Covers bool, char, int, long, long long, their unsigned variants, float,
+ * double, std::string and const char*, logged alone as in l(v), or as one
+ * of several variables.
+ *
+ * \note The library must be built with the same \c GL_ macros as the
+ * translation units that define this.
+ *
+ * \sa GL_CORE_ONLY
+ *
+ */
+#define GL_EXTERN_TEMPLATES
+#endif // DOXYGEN_HIDDEN
+
 /**
  * \brief Log variables.
  *
@@ -161,28 +454,22 @@
  * i = 1, s = "s"
  * \endcode
  *
- * \note Supports up to 16 variables as parameters.
+ * \note Supports any number of variables as parameters. Variables may be
+ * expressions, e.g. l(f(x)).
+ * \note Variables are only evaluated if the message is output.
  * \note Uses prefix information set with \ref set_prefixes().
+ * \note Isn't affected by \ref set_level(). Use e.g. \ref l_debug() for that.
  *
  * \sa l_arr() \sa l_mat() \sa set_prefixes()
  *
  */
-#define l(...)                                                                 \
-    do {                                                                       \
-        if (::gl::internal::outputEnabled) {                                   \
-            std::cout << gl::internal::color_start                             \
-                      << gl::internal::PrefixFormatter(                        \
-                             __FILE__, __LINE__, __func__)                     \
-                      << GL_INTERNAL_L_DISPATCH(__VA_ARGS__, GL_INTERNAL_L16,  \
-                             GL_INTERNAL_L15, GL_INTERNAL_L14,                 \
-                             GL_INTERNAL_L13, GL_INTERNAL_L12,                 \
-                             GL_INTERNAL_L11, GL_INTERNAL_L10, GL_INTERNAL_L9, \
-                             GL_INTERNAL_L8, GL_INTERNAL_L7, GL_INTERNAL_L6,   \
-                             GL_INTERNAL_L5, GL_INTERNAL_L4, GL_INTERNAL_L3,   \
-                             GL_INTERNAL_L2, GL_INTERNAL_L1, )(__VA_ARGS__)    \
-                      << gl::internal::color_end << (GL_NEWLINE);              \
-        }                                                                      \
+#if GL_ACTIVE_LEVEL <= GL_LEVEL_ERROR
+#define l(...) GL_INTERNAL_L(GL_INTERNAL_LEVEL_ALWAYS, __VA_ARGS__)
+#else
+#define l(...) \
+    do {       \
     } while (false)
+#endif // GL_ACTIVE_LEVEL
 
 /**
  * \brief Log array.
@@ -204,6 +491,7 @@
  * \note Uses prefix information set with \ref set_prefixes().
  * \note Unlike \ref l(), this does not support multiple varaibles as
  * parameters.
+ * \note Parameters are only evaluated if the message is output.
  *
  * \warning Behaviour is undefined if \p len is larger than the
  * allocated array.
@@ -211,11 +499,13 @@
  * \sa l() \sa l_mat() \sa set_prefixes()
  *
  */
-#define l_arr(v, len)                                                       \
-    do {                                                                    \
-        std::cout << ::gl::internal::make_array((#v), (v), (len),           \
-            ::gl::internal::PrefixFormatter(__FILE__, __LINE__, __func__)); \
+#if GL_ACTIVE_LEVEL <= GL_LEVEL_ERROR
+#define l_arr(v, len) GL_INTERNAL_L_ARR(GL_INTERNAL_LEVEL_ALWAYS, v, len)
+#else
+#define l_arr(v, len) \
+    do {              \
     } while (false)
+#endif // GL_ACTIVE_LEVEL
 
 /**
  * \brief Log matrix.
@@ -238,6 +528,7 @@
  * \note Uses prefix information set with \ref set_prefixes().
  * \note Unlike \ref l(), this does not support multiple variables
  * as parameters.
+ * \note Parameters are only evaluated if the message is output.
  *
  * \warning Behaviour is undefined if \p c or \p r is larger than
  * the allocated matrix.
@@ -245,1708 +536,9869 @@
  * \sa l() \sa l_arr() \sa set_prefixes()
  *
  */
-#define l_mat(m, cols, rows)                                                \
-    do {                                                                    \
-        std::cout << ::gl::internal::make_matrix((#m), (m), (cols), (rows), \
-            ::gl::internal::PrefixFormatter(__FILE__, __LINE__, __func__)); \
+#if GL_ACTIVE_LEVEL <= GL_LEVEL_ERROR
+#define l_mat(m, cols, rows) \
+    GL_INTERNAL_L_MAT(GL_INTERNAL_LEVEL_ALWAYS, m, cols, rows)
+#else
+#define l_mat(m, cols, rows) \
+    do {                     \
     } while (false)
+#endif // GL_ACTIVE_LEVEL
 
-#ifndef GL_NEWLINE
 /**
- * \brief Newline character to use after each logging message.
+ * \brief Log matrix in a flat buffer, such as BLAS and Eigen use.
  *
- * May e.g. be changed to std::endl to enable flush after each
- * logging message:
+ * \param p      Pointer to first element.
+ * \param cols   Number of columns in matrix.
+ * \param rows   Number of rows in matrix.
+ * \param stride Number of elements from the start of one row to the start
+ * of the next if \p lay is gl::layout::ROW_MAJOR, otherwise from one column
+ * to the next. At least \p cols, or \p rows respectively.
+ * \param lay    Layout, gl::layout::ROW_MAJOR or gl::layout::COLUMN_MAJOR.
+ *
+ * Used as:
  * \code
- * #define GL_NEWLINE std::endl
- * #include "goinglogging.h"
+ * float m[] = {11, 21, 12, 22};
+ * l_mat_flat(m, 2, 2, 2, gl::layout::COLUMN_MAJOR);
+ * \endcode
+ *
+ * Which outputs:
+ * \code
+ * m: [0,0] = 11, [0,1] = 12, [1,0] = 21, [1,1] = 22
  * \endcode
  *
- * \note Defaults to \\n, i.e. no flushing.
+ * \note Output is the same as of \ref l_mat() on the matrix as array of
+ * arrays, also with set_matrix_format().
+ * \note Parameters are only evaluated if the message is output.
  *
- * \sa l() \sa l_arr() \sa l_mat()
+ * \warning Behaviour is undefined if the matrix exceeds the buffer.
+ *
+ * \sa l_mat() \sa set_matrix_format()
  *
  */
-#define GL_NEWLINE '\n'
-#endif // GL_NEWLINE
-
-/**
- * \brief goinglogging namespace. */
-namespace gl {
+#if GL_ACTIVE_LEVEL <= GL_LEVEL_ERROR
+#define l_mat_flat(p, cols, rows, stride, lay) \
+    GL_INTERNAL_L_MAT_FLAT(GL_INTERNAL_LEVEL_ALWAYS, p, cols, rows, stride, lay)
+#else
+#define l_mat_flat(p, cols, rows, stride, lay) \
+    do {                                       \
+    } while (false)
+#endif // GL_ACTIVE_LEVEL
 
 /**
- * \brief Prefix of logging output.
+ * \brief Log at most \p max elements of array.
  *
- * Use bitwise \c or for multiple prefixes at the same time:
+ * \param v   Array to print.
+ * \param len Number of elements.
+ * \param max Maximum number of elements to output, or 0 for all. Overrides
+ * \ref set_max_elements().
+ *
+ * Used as:
  * \code
- * gl::set_prefixes(gl::prefix::FILE | gl::prefix::LINE);
+ * int a[100];
+ * std::iota(a, a + 100, 0);
+ * l_arr_n(a, 100, 4);
  * \endcode
- * Bitwise \c and as well as \c xor are also supported.
  *
- * \sa set_prefixes() \sa get_prefixes()
+ * Which outputs:
+ * \code
+ * a = {0, 1, ... (96 more), 98, 99}
+ * \endcode
+ *
+ * \sa l_arr() \sa set_max_elements()
  *
  */
-enum class prefix : uint32_t {
-    NONE = 0,          /**< No prefix. */
-    FILE = 1 << 0,     /**< File name. For example 'main.cpp'. */
-    LINE = 1 << 1,     /**< Line number in file. For example 'Line:
-                          16'. */
-    FUNCTION = 1 << 2, /**< Function name. For example 'calculate()'. */
-    TIME     = 1 << 3, /**< Current local time as
-                        * hour:minute:second.millisecond.
-                        *  For example '10:02:13.057'. */
-    THREAD = 1 << 4,   /**< ID of current thread. For example
-                          'TID:   12'. */
-    TYPE_NAME = 1 << 5 /**< Name of type. For example 'int'. */
-};
+#if GL_ACTIVE_LEVEL <= GL_LEVEL_ERROR
+#define l_arr_n(v, len, max) \
+    GL_INTERNAL_L_ARR_N(GL_INTERNAL_LEVEL_ALWAYS, v, len, max)
+#else
+#define l_arr_n(v, len, max) \
+    do {                     \
+    } while (false)
+#endif // GL_ACTIVE_LEVEL
 
 /**
- * \brief Bitwise \c and of logging prefix settings.
+ * \brief Log at most \p max elements of matrix.
  *
- * \param lhs First element.
- * \param rhs Second element.
- * \return Bitwise \c and of \p lhs and \p rhs.
+ * \param m    Matrix to print [\p rows x \p cols].
+ * \param cols Number of columns in matrix.
+ * \param rows Number of rows in matrix.
+ * \param max  Maximum number of elements to output, or 0 for all. Overrides
+ * \ref set_max_elements().
  *
- * \sa prefix \sa set_prefixes()
+ * \sa l_mat() \sa set_max_elements()
  *
  */
-inline prefix operator&(prefix lhs, prefix rhs) noexcept {
-    return static_cast<prefix>(
-        static_cast<uint32_t>(lhs) & static_cast<uint32_t>(rhs));
-}
+#if GL_ACTIVE_LEVEL <= GL_LEVEL_ERROR
+#define l_mat_n(m, cols, rows, max) \
+    GL_INTERNAL_L_MAT_N(GL_INTERNAL_LEVEL_ALWAYS, m, cols, rows, max)
+#else
+#define l_mat_n(m, cols, rows, max) \
+    do {                            \
+    } while (false)
+#endif // GL_ACTIVE_LEVEL
 
 /**
- * \brief Bitwise \c and of logging prefix settings.
+ * \brief Log bytes of memory as lines of offset, hex and ASCII, like
+ * "hexdump -C".
  *
- * \param lhs First element.
- * \param rhs Second element.
- * \return Bitwise \c and of \p lhs and \p rhs.
+ * \param p   Pointer to bytes [\p len].
+ * \param len Number of bytes.
  *
- * \sa prefix \sa set_prefixes()
+ * Used as:
+ * \code
+ * const char buf[] = "Hello, world";
+ * l_hex(buf, sizeof(buf));
+ * \endcode
+ *
+ * Which outputs:
+ * \code
+ * buf = 13 bytes
+ * 00000000  48 65 6c 6c 6f 2c 20 77  6f 72 6c 64 00           |Hello, world.|
+ * \endcode
+ *
+ * \note Parameters are only evaluated if the message is output.
+ *
+ * \sa l_bytes() \sa set_hex_width() \sa set_max_bytes()
  *
  */
-inline prefix& operator&=(prefix& lhs, prefix rhs) noexcept {
-    return lhs = lhs & rhs;
-}
+#if GL_ACTIVE_LEVEL <= GL_LEVEL_ERROR
+#define l_hex(p, len) GL_INTERNAL_L_BYTES(p, len, true)
+#else
+#define l_hex(p, len) \
+    do {              \
+    } while (false)
+#endif // GL_ACTIVE_LEVEL
 
 /**
- * \brief Bitwise \c or of logging prefix settings.
+ * \brief Log bytes of memory as hex on one line.
  *
- * \param lhs First element.
- * \param rhs Second element.
- * \return Bitwise \c or of \p lhs and \p rhs.
+ * \param p   Pointer to bytes [\p len].
+ * \param len Number of bytes.
  *
- * \sa prefix \sa set_prefixes()
+ * Used as:
+ * \code
+ * const unsigned char id[] = {0xde, 0xad, 0xbe, 0xef};
+ * l_bytes(id, 4);
+ * \endcode
+ *
+ * Which outputs:
+ * \code
+ * id = deadbeef
+ * \endcode
+ *
+ * \note Parameters are only evaluated if the message is output.
+ *
+ * \sa l_hex() \sa set_max_bytes()
  *
  */
-inline prefix operator|(prefix lhs, prefix rhs) noexcept {
-    return static_cast<prefix>(
-        static_cast<uint32_t>(lhs) | static_cast<uint32_t>(rhs));
-}
+#if GL_ACTIVE_LEVEL <= GL_LEVEL_ERROR
+#define l_bytes(p, len) GL_INTERNAL_L_BYTES(p, len, false)
+#else
+#define l_bytes(p, len) \
+    do {                \
+    } while (false)
+#endif // GL_ACTIVE_LEVEL
 
 /**
- * \brief Bitwise \c or of logging prefix settings.
+ * \brief Log variables every \p n th time.
  *
- * \param lhs First element.
- * \param rhs Second element.
- * \return Bitwise \c or of \p lhs and \p rhs.
+ * Use as:
+ * \code
+ * for (int i = 0; i < 1000; ++i) {
+ *     l_every_n(100, i);
+ * }
+ * \endcode
+ * Which outputs i = 0, i = 100, i = 200 and so on.
  *
- * \sa prefix \sa set_prefixes()
+ * \param n Interval. 0 is treated as 1.
+ *
+ * \note Skipped calls cost an atomic increment, and neither arguments nor
+ * formatting are evaluated.
+ * \note Supports any number of variables as parameters, like \ref l().
+ *
+ * \sa l_every_ms() \sa l_once() \sa l_when()
+ * \sa set_suppressed_summary_enabled()
  *
  */
-inline prefix& operator|=(prefix& lhs, prefix rhs) noexcept {
-    return lhs = lhs | rhs;
-}
+#if GL_ACTIVE_LEVEL <= GL_LEVEL_ERROR
+#define l_every_n(n, ...) \
+    GL_INTERNAL_L_RATE(::gl::internal::EveryN, ((n)), __VA_ARGS__)
+#else
+#define l_every_n(n, ...) \
+    do {                  \
+    } while (false)
+#endif // GL_ACTIVE_LEVEL
 
 /**
- * \brief Bitwise \c xor of logging prefix settings.
+ * \brief Log variables at most once per \p ms milliseconds.
  *
- * \param lhs First element.
- * \param rhs Second element.
- * \return Bitwise \c xor of \p lhs and \p rhs.
+ * \param ms Minimum interval in milliseconds.
  *
- * \sa prefix \sa set_prefixes()
+ * \note Skipped calls cost a read of a monotonic clock, and neither
+ * arguments nor formatting are evaluated.
+ * \note Supports any number of variables as parameters, like \ref l().
+ *
+ * \sa l_every_n() \sa l_once() \sa l_when()
+ * \sa set_suppressed_summary_enabled()
  *
  */
-inline prefix operator^(prefix lhs, prefix rhs) noexcept {
-    return static_cast<prefix>(
-        static_cast<uint32_t>(lhs) ^ static_cast<uint32_t>(rhs));
-}
+#if GL_ACTIVE_LEVEL <= GL_LEVEL_ERROR
+#define l_every_ms(ms, ...) \
+    GL_INTERNAL_L_RATE(::gl::internal::EveryMs, ((ms)), __VA_ARGS__)
+#else
+#define l_every_ms(ms, ...) \
+    do {                    \
+    } while (false)
+#endif // GL_ACTIVE_LEVEL
 
 /**
- * \brief Bitwise \c xor of logging prefix settings.
+ * \brief Log variables the first time only.
  *
- * \param lhs First element.
- * \param rhs Second element.
- * \return Bitwise \c xor of \p lhs and \p rhs.
+ * \note Supports any number of variables as parameters, like \ref l().
  *
- * \sa prefix \sa set_prefixes()
+ * \sa l_every_n() \sa l_every_ms() \sa l_when()
  *
  */
-inline prefix& operator^=(prefix& lhs, prefix rhs) noexcept {
-    return lhs = lhs ^ rhs;
-}
-
+#if GL_ACTIVE_LEVEL <= GL_LEVEL_ERROR
+#define l_once(...) GL_INTERNAL_L_RATE(::gl::internal::Once, (), __VA_ARGS__)
+#else
+#define l_once(...) \
+    do {            \
+    } while (false)
+#endif // GL_ACTIVE_LEVEL
+
+/**
+ * \brief Log variables if a condition holds.
+ *
+ * \param cond Condition. Not evaluated if output is disabled.
+ *
+ * \note Supports any number of variables as parameters, like \ref l().
+ *
+ * \sa l_every_n() \sa l_every_ms() \sa l_once()
+ * \sa set_suppressed_summary_enabled()
+ *
+ */
+#if GL_ACTIVE_LEVEL <= GL_LEVEL_ERROR
+#define l_when(cond, ...) \
+    GL_INTERNAL_L_RATE(   \
+        ::gl::internal::When, (static_cast<bool>(cond)), __VA_ARGS__)
+#else
+#define l_when(cond, ...) \
+    do {                  \
+    } while (false)
+#endif // GL_ACTIVE_LEVEL
+
+/**
+ * \brief Log variables if any of them changed since the previous message of
+ * the call site.
+ *
+ * Use as:
+ * \code
+ * for (;;) {
+ *     l_changed(state);
+ *     state = step(state);
+ * }
+ * \endcode
+ * Which outputs state only on transitions. Values are compared by a hash, so
+ * containers aren't copied. Numbers, strings and the elements of containers
+ * are hashed directly, and other values by their formatted form.
+ *
+ * \note Arguments are evaluated on every call, but only once.
+ * \note Supports any number of variables as parameters, like \ref l().
+ *
+ * \sa set_previous_values_enabled() \sa l_when()
+ * \sa set_suppressed_summary_enabled()
+ *
+ */
+#if GL_ACTIVE_LEVEL <= GL_LEVEL_ERROR
+#define l_changed(...) GL_INTERNAL_L_CHANGED(__VA_ARGS__)
+#else
+#define l_changed(...) \
+    do {               \
+    } while (false)
+#endif // GL_ACTIVE_LEVEL
+
+/**
+ * \brief Log the time spent in the enclosing scope when it ends.
+ *
+ * Use as:
+ * \code
+ * void parse() {
+ *     l_scope("parse");
+ *     ...
+ * }
+ * \endcode
+ * Which outputs e.g. parse = 12.345 us, with the prefixes of \ref l().
+ *
+ * \param name Name of scope. A string literal without commas.
+ *
+ * \note Measured with std::chrono::steady_clock. Nothing is measured if
+ * output is disabled when entering the scope.
+ *
+ * \sa l_timer()
+ *
+ */
+#if GL_ACTIVE_LEVEL <= GL_LEVEL_ERROR
+#define l_scope(name) GL_INTERNAL_L_SCOPE(name, nullptr, 0)
+#else
+#define l_scope(name) \
+    do {              \
+    } while (false)
+#endif // GL_ACTIVE_LEVEL
+
+/**
+ * \brief Measure the time spent in the enclosing scope, and log a summary of
+ * the times every \p n calls.
+ *
+ * Use as:
+ * \code
+ * void parse() {
+ *     l_timer("parse", 1000);
+ *     ...
+ * }
+ * \endcode
+ * Which outputs e.g.
+ * \code
+ * parse = 1000 calls, min 812 ns, mean 1.311 us, p99 4.863 us, max 9.100 us
+ * \endcode
+ * A summary covers the calls since the previous summary of the call site.
+ *
+ * \param name Name of scope. A string literal without commas.
+ * \param n    Calls per summary. 0 to only log summaries by log_timers().
+ *
+ * \note Calls that aren't summarized cost two reads of
+ * std::chrono::steady_clock and a few atomic operations, and write nothing.
+ * The 99th percentile is read from a histogram, and exceeds the exact value
+ * by at most 1/16.
+ *
+ * \sa l_scope() \sa log_timers()
+ *
+ */
+#if GL_ACTIVE_LEVEL <= GL_LEVEL_ERROR
+#define l_timer(name, n) GL_INTERNAL_L_TIMER(name, n)
+#else
+#define l_timer(name, n) \
+    do {                 \
+    } while (false)
+#endif // GL_ACTIVE_LEVEL
+
+#ifndef GL_NEWLINE
+/**
+ * \brief Newline character to use after each logging message.
+ *
+ * May e.g. be changed to std::endl to enable flush after each
+ * logging message:
+ * \code
+ * #define GL_NEWLINE std::endl
+ * #include "goinglogging.h"
+ * \endcode
+ *
+ * \note Defaults to \\n, i.e. no flushing. Prefer set_flush_bytes() and
+ * set_flush_interval(), which flush less often than once per message.
+ *
+ * \sa l() \sa l_arr() \sa l_mat()
+ *
+ */
+#define GL_NEWLINE '\n'
+#endif // GL_NEWLINE
+
+/**
+ * \brief Log variables at level::L_TRACE.
+ *
+ * \note Expands to nothing if GL_ACTIVE_LEVEL is higher than GL_LEVEL_TRACE.
+ *
+ * \sa l() \sa set_level()
+ *
+ */
+#if GL_ACTIVE_LEVEL <= GL_LEVEL_TRACE
+#define l_trace(...) GL_INTERNAL_L(GL_LEVEL_TRACE, __VA_ARGS__)
+#else
+#define l_trace(...) \
+    do {             \
+    } while (false)
+#endif // GL_ACTIVE_LEVEL
+
+/**
+ * \brief Log array at level::L_TRACE.
+ *
+ * \note Expands to nothing if GL_ACTIVE_LEVEL is higher than GL_LEVEL_TRACE.
+ *
+ * \sa l_arr() \sa set_level()
+ *
+ */
+#if GL_ACTIVE_LEVEL <= GL_LEVEL_TRACE
+#define l_arr_trace(v, len) GL_INTERNAL_L_ARR(GL_LEVEL_TRACE, v, len)
+#else
+#define l_arr_trace(v, len) \
+    do {                    \
+    } while (false)
+#endif // GL_ACTIVE_LEVEL
+
+/**
+ * \brief Log matrix at level::L_TRACE.
+ *
+ * \note Expands to nothing if GL_ACTIVE_LEVEL is higher than GL_LEVEL_TRACE.
+ *
+ * \sa l_mat() \sa set_level()
+ *
+ */
+#if GL_ACTIVE_LEVEL <= GL_LEVEL_TRACE
+#define l_mat_trace(m, cols, rows) \
+    GL_INTERNAL_L_MAT(GL_LEVEL_TRACE, m, cols, rows)
+#else
+#define l_mat_trace(m, cols, rows) \
+    do {                           \
+    } while (false)
+#endif // GL_ACTIVE_LEVEL
+
+/**
+ * \brief Log variables at level::L_DEBUG.
+ *
+ * \note Expands to nothing if GL_ACTIVE_LEVEL is higher than GL_LEVEL_DEBUG.
+ *
+ * \sa l() \sa set_level()
+ *
+ */
+#if GL_ACTIVE_LEVEL <= GL_LEVEL_DEBUG
+#define l_debug(...) GL_INTERNAL_L(GL_LEVEL_DEBUG, __VA_ARGS__)
+#else
+#define l_debug(...) \
+    do {             \
+    } while (false)
+#endif // GL_ACTIVE_LEVEL
+
+/**
+ * \brief Log array at level::L_DEBUG.
+ *
+ * \note Expands to nothing if GL_ACTIVE_LEVEL is higher than GL_LEVEL_DEBUG.
+ *
+ * \sa l_arr() \sa set_level()
+ *
+ */
+#if GL_ACTIVE_LEVEL <= GL_LEVEL_DEBUG
+#define l_arr_debug(v, len) GL_INTERNAL_L_ARR(GL_LEVEL_DEBUG, v, len)
+#else
+#define l_arr_debug(v, len) \
+    do {                    \
+    } while (false)
+#endif // GL_ACTIVE_LEVEL
+
+/**
+ * \brief Log matrix at level::L_DEBUG.
+ *
+ * \note Expands to nothing if GL_ACTIVE_LEVEL is higher than GL_LEVEL_DEBUG.
+ *
+ * \sa l_mat() \sa set_level()
+ *
+ */
+#if GL_ACTIVE_LEVEL <= GL_LEVEL_DEBUG
+#define l_mat_debug(m, cols, rows) \
+    GL_INTERNAL_L_MAT(GL_LEVEL_DEBUG, m, cols, rows)
+#else
+#define l_mat_debug(m, cols, rows) \
+    do {                           \
+    } while (false)
+#endif // GL_ACTIVE_LEVEL
+
+/**
+ * \brief Log variables at level::L_INFO.
+ *
+ * \note Expands to nothing if GL_ACTIVE_LEVEL is higher than GL_LEVEL_INFO.
+ *
+ * \sa l() \sa set_level()
+ *
+ */
+#if GL_ACTIVE_LEVEL <= GL_LEVEL_INFO
+#define l_info(...) GL_INTERNAL_L(GL_LEVEL_INFO, __VA_ARGS__)
+#else
+#define l_info(...) \
+    do {            \
+    } while (false)
+#endif // GL_ACTIVE_LEVEL
+
+/**
+ * \brief Log array at level::L_INFO.
+ *
+ * \note Expands to nothing if GL_ACTIVE_LEVEL is higher than GL_LEVEL_INFO.
+ *
+ * \sa l_arr() \sa set_level()
+ *
+ */
+#if GL_ACTIVE_LEVEL <= GL_LEVEL_INFO
+#define l_arr_info(v, len) GL_INTERNAL_L_ARR(GL_LEVEL_INFO, v, len)
+#else
+#define l_arr_info(v, len) \
+    do {                   \
+    } while (false)
+#endif // GL_ACTIVE_LEVEL
+
+/**
+ * \brief Log matrix at level::L_INFO.
+ *
+ * \note Expands to nothing if GL_ACTIVE_LEVEL is higher than GL_LEVEL_INFO.
+ *
+ * \sa l_mat() \sa set_level()
+ *
+ */
+#if GL_ACTIVE_LEVEL <= GL_LEVEL_INFO
+#define l_mat_info(m, cols, rows) \
+    GL_INTERNAL_L_MAT(GL_LEVEL_INFO, m, cols, rows)
+#else
+#define l_mat_info(m, cols, rows) \
+    do {                          \
+    } while (false)
+#endif // GL_ACTIVE_LEVEL
+
+/**
+ * \brief Log variables at level::L_WARNING.
+ *
+ * \note Expands to nothing if GL_ACTIVE_LEVEL is higher than GL_LEVEL_WARNING.
+ *
+ * \sa l() \sa set_level()
+ *
+ */
+#if GL_ACTIVE_LEVEL <= GL_LEVEL_WARNING
+#define l_warning(...) GL_INTERNAL_L(GL_LEVEL_WARNING, __VA_ARGS__)
+#else
+#define l_warning(...) \
+    do {               \
+    } while (false)
+#endif // GL_ACTIVE_LEVEL
+
+/**
+ * \brief Log array at level::L_WARNING.
+ *
+ * \note Expands to nothing if GL_ACTIVE_LEVEL is higher than GL_LEVEL_WARNING.
+ *
+ * \sa l_arr() \sa set_level()
+ *
+ */
+#if GL_ACTIVE_LEVEL <= GL_LEVEL_WARNING
+#define l_arr_warning(v, len) GL_INTERNAL_L_ARR(GL_LEVEL_WARNING, v, len)
+#else
+#define l_arr_warning(v, len) \
+    do {                      \
+    } while (false)
+#endif // GL_ACTIVE_LEVEL
+
+/**
+ * \brief Log matrix at level::L_WARNING.
+ *
+ * \note Expands to nothing if GL_ACTIVE_LEVEL is higher than GL_LEVEL_WARNING.
+ *
+ * \sa l_mat() \sa set_level()
+ *
+ */
+#if GL_ACTIVE_LEVEL <= GL_LEVEL_WARNING
+#define l_mat_warning(m, cols, rows) \
+    GL_INTERNAL_L_MAT(GL_LEVEL_WARNING, m, cols, rows)
+#else
+#define l_mat_warning(m, cols, rows) \
+    do {                             \
+    } while (false)
+#endif // GL_ACTIVE_LEVEL
+
+/**
+ * \brief Log variables at level::L_ERROR.
+ *
+ * \note Expands to nothing if GL_ACTIVE_LEVEL is higher than GL_LEVEL_ERROR.
+ *
+ * \sa l() \sa set_level()
+ *
+ */
+#if GL_ACTIVE_LEVEL <= GL_LEVEL_ERROR
+#define l_error(...) GL_INTERNAL_L(GL_LEVEL_ERROR, __VA_ARGS__)
+#else
+#define l_error(...) \
+    do {             \
+    } while (false)
+#endif // GL_ACTIVE_LEVEL
+
+/**
+ * \brief Log array at level::L_ERROR.
+ *
+ * \note Expands to nothing if GL_ACTIVE_LEVEL is higher than GL_LEVEL_ERROR.
+ *
+ * \sa l_arr() \sa set_level()
+ *
+ */
+#if GL_ACTIVE_LEVEL <= GL_LEVEL_ERROR
+#define l_arr_error(v, len) GL_INTERNAL_L_ARR(GL_LEVEL_ERROR, v, len)
+#else
+#define l_arr_error(v, len) \
+    do {                    \
+    } while (false)
+#endif // GL_ACTIVE_LEVEL
+
+/**
+ * \brief Log matrix at level::L_ERROR.
+ *
+ * \note Expands to nothing if GL_ACTIVE_LEVEL is higher than GL_LEVEL_ERROR.
+ *
+ * \sa l_mat() \sa set_level()
+ *
+ */
+#if GL_ACTIVE_LEVEL <= GL_LEVEL_ERROR
+#define l_mat_error(m, cols, rows) \
+    GL_INTERNAL_L_MAT(GL_LEVEL_ERROR, m, cols, rows)
+#else
+#define l_mat_error(m, cols, rows) \
+    do {                           \
+    } while (false)
+#endif // GL_ACTIVE_LEVEL
+
+/**
+ * \brief goinglogging namespace. */
+namespace gl {
+
+/**
+ * \brief Prefix of logging output.
+ *
+ * Use bitwise \c or for multiple prefixes at the same time:
+ * \code
+ * gl::set_prefixes(gl::prefix::FILE | gl::prefix::LINE);
+ * \endcode
+ * Bitwise \c and as well as \c xor are also supported.
+ *
+ * \sa set_prefixes() \sa get_prefixes()
+ *
+ */
+enum class prefix : uint32_t {
+    NONE = 0,          /**< No prefix. */
+    FILE = 1 << 0,     /**< File name. For example 'main.cpp'. */
+    LINE = 1 << 1,     /**< Line number in file. For example 'Line:
+                          16'. */
+    FUNCTION = 1 << 2, /**< Function name. For example 'calculate()'. */
+    TIME     = 1 << 3, /**< Current local time as
+                        * hour:minute:second.millisecond.
+                        *  For example '10:02:13.057'.
+                        *  \sa set_time_format() */
+    THREAD = 1 << 4,   /**< ID of current thread. For example
+                          'TID:   12'. */
+    TYPE_NAME = 1 << 5 /**< Name of type. For example 'int'. */
+};
+
+/**
+ * \brief Severity level of logging output.
+ *
+ * Names are prefixed with L_, since DEBUG and ERROR are commonly defined as
+ * macros, for example by -DDEBUG or <windows.h>.
+ *
+ * \sa set_level() \sa GL_ACTIVE_LEVEL
+ *
+ */
+enum class level : uint32_t {
+    L_TRACE   = GL_LEVEL_TRACE,   /**< Very detailed tracing. */
+    L_DEBUG   = GL_LEVEL_DEBUG,   /**< Debugging. */
+    L_INFO    = GL_LEVEL_INFO,    /**< Information. */
+    L_WARNING = GL_LEVEL_WARNING, /**< Warnings. */
+    L_ERROR   = GL_LEVEL_ERROR,   /**< Errors. */
+    L_OFF     = GL_LEVEL_OFF      /**< Nothing. */
+};
+
+/**
+ * \brief Format of prefix::TIME.
+ *
+ * \sa set_time_format()
+ *
+ */
+enum class time_format : uint32_t {
+    LOCAL_MILLISECONDS, /**< Local time with milliseconds. For example
+                           '10:02:13.057'. */
+    LOCAL_MICROSECONDS, /**< Local time with microseconds. For example
+                           '10:02:13.057123'. */
+    MONOTONIC /**< Seconds and nanoseconds of a monotonic clock, unaffected by
+                 changes of system time. For example '8012.057123456'. */
+};
+
+/**
+ * \brief What to do with a logging message when the asynchronous queue is
+ * full.
+ *
+ * Binary records that announce a call site are never dropped, since later
+ * records of the site refer to them. They wait like BLOCK instead.
+ *
+ * \sa set_async_overflow() \sa get_dropped_count()
+ *
+ */
+enum class overflow : uint32_t {
+    BLOCK,       /**< Wait until there is room in the queue. */
+    DROP_NEWEST, /**< Drop the new message. */
+    DROP_OLDEST  /**< Drop the oldest message in the queue. */
+};
+
+/**
+ * \brief Format of logging output.
+ *
+ * \sa set_format() \sa decode_binary()
+ *
+ */
+enum class format : uint32_t {
+    TEXT,   /**< Formatted text. */
+    BINARY, /**< Compact binary records, formatted later by decode_binary(). */
+    JSON,   /**< One JSON object per message. */
+    CSV     /**< One comma separated row per message. */
+};
+
+/**
+ * \brief How to shorten containers, arrays and matrices with more elements
+ * than set_max_elements().
+ *
+ * \sa set_truncation()
+ *
+ */
+enum class truncation : uint32_t {
+    ELIDE,    /**< Leading and trailing elements, and the number left out. */
+    SUMMARIZE /**< Number of elements, minimum, maximum and mean. Only for
+                 integers, float and double. Others are elided. */
+};
+
+/**
+ * \brief Formatting of matrices.
+ *
+ * \sa set_matrix_format()
+ *
+ */
+enum class matrix_format : uint32_t {
+    INDEXED, /**< One line, with the index of each value. For example
+                'm: [0,0] = 1, [0,1] = 2, [1,0] = 3, [1,1] = 4'. */
+    GRID     /**< Number of rows and columns, then one line per row. For
+                example 'm: 2 x 2', '1 2', '3 4'. */
+};
+
+/**
+ * \brief Order of values of a matrix in a flat buffer.
+ *
+ * \sa l_mat_flat()
+ *
+ */
+enum class layout : uint32_t {
+    ROW_MAJOR,   /**< Rows one after another, as in C arrays. */
+    COLUMN_MAJOR /**< Columns one after another, as in Fortran and BLAS. */
+};
+
+/**
+ * \brief Formatting of float and double values.
+ *
+ * \sa set_float_format()
+ *
+ */
+enum class float_format : uint32_t {
+    DEFAULT,   /**< Stream precision, like operator<<. */
+    ROUND_TRIP /**< Fewest digits that read back to the same value. */
+};
+
+/**
+ * \brief Counters of one call site.
+ *
+ * \sa Stats \sa get_stats()
+ *
+ */
+struct SiteStats {
+    const char* file;     /**< File name without path. */
+    long        line;     /**< Line number in file. */
+    const char* function; /**< Function name. */
+    uint64_t    calls;    /**< Number of logging messages. */
+    uint64_t    bytes;    /**< Bytes of logging output. */
+};
+
+/**
+ * \brief Counters of logging, summed over all threads.
+ *
+ * \sa set_stats_enabled() \sa get_stats()
+ *
+ */
+struct Stats {
+    /**
+     * \brief Constructor. All counters zero.
+     */
+    Stats() :
+        calls(0), bytes(0), dropped(0), suppressed(0), nanoseconds(0),
+        maxNanoseconds(0), sites() {
+    }
+
+    uint64_t calls;          /**< Number of logging messages. */
+    uint64_t bytes;          /**< Bytes of logging output. */
+    uint64_t dropped;        /**< Dropped since the asynchronous queue was
+                                full. See get_dropped_count(). */
+    uint64_t suppressed;     /**< Suppressed by l_every_n(), l_every_ms(),
+                                l_once() and l_when(). */
+    uint64_t nanoseconds;    /**< Time spent logging, including evaluation
+                                of the logged expressions. */
+    uint64_t maxNanoseconds; /**< Longest time spent on one message. */
+    /** Call sites, the most called first. */
+    std::vector<SiteStats> sites;
+};
+
+/**
+ * \brief Whether variables of a type may be copied, and formatted later by
+ * the writer thread, when deferred formatting is enabled.
+ *
+ * Holds for arithmetic types, enums, C strings, std::string and, with
+ * goinglogging_containers.h, standard containers of them. Specialize for
+ * other copyable types whose formatting only depends on the copy:
+ * \code
+ * template<>
+ * struct gl::is_deferrable<Point> : std::true_type {};
+ * \endcode
+ *
+ * \tparam T Variable type, without const and volatile.
+ *
+ * \sa set_deferred_enabled()
+ *
+ */
+template<class T, class Enable = void>
+struct is_deferrable
+    : std::integral_constant<bool,
+          std::is_arithmetic<T>::value || std::is_enum<T>::value> {};
+template<>
+struct is_deferrable<char*> : std::true_type {};
+template<>
+struct is_deferrable<const char*> : std::true_type {};
+template<>
+struct is_deferrable<std::string> : std::true_type {};
+template<class U, class V>
+struct is_deferrable<std::pair<U, V>>
+    : std::integral_constant<bool,
+          is_deferrable<U>::value && is_deferrable<V>::value> {};
+
+#ifndef DOXYGEN_HIDDEN
+namespace internal {
+struct Elapsed;
+struct TimerSummary;
+} // namespace internal
+template<>
+struct is_deferrable<internal::Elapsed> : std::true_type {};
+template<>
+struct is_deferrable<internal::TimerSummary> : std::true_type {};
+#endif // DOXYGEN_HIDDEN
+
+/**
+ * \brief Bitwise \c and of logging prefix settings.
+ *
+ * \param lhs First element.
+ * \param rhs Second element.
+ * \return Bitwise \c and of \p lhs and \p rhs.
+ *
+ * \sa prefix \sa set_prefixes()
+ *
+ */
+inline prefix operator&(prefix lhs, prefix rhs) noexcept {
+    return static_cast<prefix>(
+        static_cast<uint32_t>(lhs) & static_cast<uint32_t>(rhs));
+}
+
+/**
+ * \brief Bitwise \c and of logging prefix settings.
+ *
+ * \param lhs First element.
+ * \param rhs Second element.
+ * \return Bitwise \c and of \p lhs and \p rhs.
+ *
+ * \sa prefix \sa set_prefixes()
+ *
+ */
+inline prefix& operator&=(prefix& lhs, prefix rhs) noexcept {
+    return lhs = lhs & rhs;
+}
+
+/**
+ * \brief Bitwise \c or of logging prefix settings.
+ *
+ * \param lhs First element.
+ * \param rhs Second element.
+ * \return Bitwise \c or of \p lhs and \p rhs.
+ *
+ * \sa prefix \sa set_prefixes()
+ *
+ */
+inline prefix operator|(prefix lhs, prefix rhs) noexcept {
+    return static_cast<prefix>(
+        static_cast<uint32_t>(lhs) | static_cast<uint32_t>(rhs));
+}
+
+/**
+ * \brief Bitwise \c or of logging prefix settings.
+ *
+ * \param lhs First element.
+ * \param rhs Second element.
+ * \return Bitwise \c or of \p lhs and \p rhs.
+ *
+ * \sa prefix \sa set_prefixes()
+ *
+ */
+inline prefix& operator|=(prefix& lhs, prefix rhs) noexcept {
+    return lhs = lhs | rhs;
+}
+
+/**
+ * \brief Bitwise \c xor of logging prefix settings.
+ *
+ * \param lhs First element.
+ * \param rhs Second element.
+ * \return Bitwise \c xor of \p lhs and \p rhs.
+ *
+ * \sa prefix \sa set_prefixes()
+ *
+ */
+inline prefix operator^(prefix lhs, prefix rhs) noexcept {
+    return static_cast<prefix>(
+        static_cast<uint32_t>(lhs) ^ static_cast<uint32_t>(rhs));
+}
+
+/**
+ * \brief Bitwise \c xor of logging prefix settings.
+ *
+ * \param lhs First element.
+ * \param rhs Second element.
+ * \return Bitwise \c xor of \p lhs and \p rhs.
+ *
+ * \sa prefix \sa set_prefixes()
+ *
+ */
+inline prefix& operator^=(prefix& lhs, prefix rhs) noexcept {
+    return lhs = lhs ^ rhs;
+}
+
+/**
+ * \brief Destination of logging output.
+ *
+ * Derive from this class to send logging output somewhere else than the
+ * built-in sinks. write() and flush() may be called from several threads at
+ * the same time.
+ *
+ * \sa set_sink() \sa OstreamSink \sa FdSink \sa BufferedFileSink
+ * \sa NullSink
+ *
+ */
+class Sink {
+  public:
+    /**
+     * \brief Destructor.
+     */
+    virtual ~Sink() = default;
+
+    /**
+     * \brief Write logging output.
+     *
+     * \param data Characters [\p len].
+     * \param len  Number of characters.
+     */
+    virtual void write(const char* data, size_t len) = 0;
+
+    /**
+     * \brief Flush logging output written so far.
+     */
+    virtual void flush() {
+    }
+
+    /**
+     * \return \c true if this sink discards all output. Logging is then
+     * skipped altogether.
+     */
+    virtual bool is_null() const noexcept {
+        return false;
+    }
+};
+
+/**
+ * \brief Sink writing to a std::ostream.
+ *
+ * \note This is the default sink, writing to std::cout.
+ *
+ */
+class OstreamSink : public Sink {
+  public:
+    /**
+     * \brief Constructor.
+     *
+     * \param os Output stream. Must outlive this sink.
+     */
+    explicit OstreamSink(std::ostream& os) noexcept : m_os(os), m_mutex() {
+    }
+
+    /**
+     * \brief Write to stream.
+     *
+     * \param data Characters [\p len].
+     * \param len  Number of characters.
+     */
+    void write(const char* data, size_t len) override {
+        // A stream isn't thread safe unless synchronized with stdio
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_os.write(data, static_cast<std::streamsize>(len));
+    }
+
+    /**
+     * \brief Flush stream.
+     */
+    void flush() override {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_os.flush();
+    }
+
+  private:
+    std::ostream& m_os;    /**< Output stream. */
+    std::mutex    m_mutex; /**< Serializes access to \p m_os. */
+};
+
+/**
+ * \brief Sink writing directly to a file descriptor, without buffering.
+ *
+ * Each logging message becomes one system call, bypassing iostreams
+ * altogether.
+ *
+ */
+class FdSink : public Sink {
+  public:
+    /**
+     * \brief Constructor.
+     *
+     * \param fd    File descriptor, e.g. 1 for stdout.
+     * \param owned \c true if \p fd shall be closed by this sink.
+     */
+    explicit FdSink(int fd, bool owned = false) noexcept :
+        m_fd(fd), m_owned(owned) {
+    }
+
+    FdSink(const FdSink&) = delete;
+    FdSink& operator=(const FdSink&) = delete;
+
+    /**
+     * \brief Destructor. Close file descriptor if owned.
+     */
+    ~FdSink() override {
+        if (m_owned) {
+#ifdef _WIN32
+            _close(m_fd);
+#else
+            ::close(m_fd);
+#endif // _WIN32
+        }
+    }
+
+    /**
+     * \brief Write to file descriptor. Retries on partial writes.
+     *
+     * \param data Characters [\p len].
+     * \param len  Number of characters.
+     */
+    void write(const char* data, size_t len) override {
+        while (len > 0) {
+#ifdef _WIN32
+            int n = _write(m_fd, data, static_cast<unsigned int>(len));
+#else
+            ssize_t n = ::write(m_fd, data, len);
+#endif // _WIN32
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return;
+            }
+            data += n;
+            len -= static_cast<size_t>(n);
+        }
+    }
+
+  private:
+    const int  m_fd;    /**< File descriptor. */
+    const bool m_owned; /**< \c true if \p m_fd shall be closed. */
+};
+
+/**
+ * \brief Sink writing to a file through a buffer of configurable size.
+ *
+ * Output is written to the file when the buffer is full or when flushed.
+ *
+ */
+class BufferedFileSink : public Sink {
+  public:
+    /**
+     * \brief Constructor. Create or truncate file.
+     *
+     * \param path     File path.
+     * \param buf_size Buffer size in bytes.
+     *
+     * \throw std::runtime_error if the file can't be opened.
+     */
+    explicit BufferedFileSink(
+        const std::string& path, size_t buf_size = 64 * 1024) :
+        m_out(open(path), true),
+        m_buf(new char[buf_size]), m_size(buf_size), m_used(0), m_mutex() {
+    }
+
+    BufferedFileSink(const BufferedFileSink&) = delete;
+    BufferedFileSink& operator=(const BufferedFileSink&) = delete;
+
+    /**
+     * \brief Destructor. Write buffered output to file.
+     */
+    ~BufferedFileSink() override {
+        flush();
+    }
+
+    /**
+     * \brief Write to buffer. Writes buffer to file first if it's too full.
+     *
+     * \param data Characters [\p len].
+     * \param len  Number of characters.
+     */
+    void write(const char* data, size_t len) override {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (len > m_size - m_used) {
+            flush_buffer();
+        }
+        if (len >= m_size) {
+            // Wouldn't fit anyway
+            m_out.write(data, len);
+        } else {
+            std::memcpy(m_buf.get() + m_used, data, len);
+            m_used += len;
+        }
+    }
+
+    /**
+     * \brief Write buffered output to file.
+     */
+    void flush() override {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        flush_buffer();
+    }
+
+  private:
+    /**
+     * \brief Open file for writing.
+     *
+     * \param path File path.
+     * \return File descriptor.
+     *
+     * \throw std::runtime_error if the file can't be opened.
+     */
+    static int open(const std::string& path) {
+#ifdef _WIN32
+        int fd = _open(path.c_str(),
+            _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+        int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+#endif // _WIN32
+        if (fd < 0) {
+            std::stringstream ss;
+            ss << "BufferedFileSink: Failed to open '" << path << '\'';
+            throw std::runtime_error(ss.str());
+        }
+        return fd;
+    }
+
+    /**
+     * \brief Write buffer to file. Caller must hold \p m_mutex.
+     */
+    void flush_buffer() {
+        m_out.write(m_buf.get(), m_used);
+        m_used = 0;
+    }
+
+    FdSink                  m_out;   /**< File. */
+    std::unique_ptr<char[]> m_buf;   /**< Buffer [\p m_size]. */
+    const size_t            m_size;  /**< Buffer size. */
+    size_t                  m_used;  /**< Number of buffered characters. */
+    std::mutex              m_mutex; /**< Protects \p m_buf. */
+};
+
+/**
+ * \brief Sink discarding all output.
+ *
+ * Logging costs no more than with output disabled while this sink is set.
+ *
+ * \sa set_output_enabled()
+ *
+ */
+class NullSink : public Sink {
+  public:
+    /**
+     * \brief Discard output.
+     */
+    void write(const char* /*data*/, size_t /*len*/) override {
+    }
+
+    /**
+     * \return \c true.
+     */
+    bool is_null() const noexcept override {
+        return true;
+    }
+};
+
+#ifndef _WIN32
+/**
+ * \brief Sink writing to a memory mapped file used as a ring buffer.
+ *
+ * Writing is a copy into pages shared with the kernel, which persists them
+ * even if the process crashes afterwards. When the ring is full, the oldest
+ * output is overwritten. Read the file in order with read_ring().
+ *
+ * \note Only available on POSIX systems.
+ * \note Output isn't synchronized to disk, so it doesn't survive a crash of
+ * the operating system.
+ *
+ * \sa read_ring()
+ *
+ */
+class RingFileSink : public Sink {
+  public:
+    /** Size in bytes of file header. Ring follows the header. */
+    static constexpr size_t headerSize = 64;
+
+    /**
+     * \brief Constructor. Create or truncate file.
+     *
+     * \param path File path.
+     * \param size Ring size in bytes.
+     *
+     * \throw std::runtime_error if the file can't be created or mapped.
+     */
+    explicit RingFileSink(const std::string& path, size_t size = 1024 * 1024) :
+        m_fd(::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644)),
+        m_map(nullptr), m_size(size), m_head(nullptr) {
+        if (m_fd < 0) {
+            fail("open", path);
+        }
+        if (size == 0 ||
+            ::ftruncate(m_fd, static_cast<off_t>(headerSize + size)) != 0) {
+            ::close(m_fd);
+            fail("resize", path);
+        }
+        void* p = ::mmap(nullptr, headerSize + size, PROT_READ | PROT_WRITE,
+            MAP_SHARED, m_fd, 0);
+        if (p == MAP_FAILED) {
+            ::close(m_fd);
+            fail("map", path);
+        }
+        m_map = static_cast<char*>(p);
+
+        // Header: magic, ring size and number of bytes ever written
+        std::memcpy(m_map, magic(), 8);
+        uint64_t s = size;
+        std::memcpy(m_map + 8, &s, sizeof(s));
+        m_head = new (m_map + 16) std::atomic<uint64_t>(0);
+    }
+
+    RingFileSink(const RingFileSink&) = delete;
+    RingFileSink& operator=(const RingFileSink&) = delete;
+
+    /**
+     * \brief Destructor. Unmap and close file.
+     */
+    ~RingFileSink() override {
+        ::munmap(m_map, headerSize + m_size);
+        ::close(m_fd);
+    }
+
+    /**
+     * \brief Copy to ring. Threads reserve space with a single atomic
+     * addition, and then copy without locking.
+     *
+     * \param data Characters [\p len].
+     * \param len  Number of characters. Only the last part is kept if
+     *             larger than the ring.
+     */
+    void write(const char* data, size_t len) override {
+        if (len > m_size) {
+            data += len - m_size;
+            len = m_size;
+        }
+        uint64_t pos =
+            m_head->fetch_add(len, std::memory_order_relaxed) % m_size;
+        size_t first = m_size - pos < len ? m_size - pos : len;
+        char*  ring  = m_map + headerSize;
+        std::memcpy(ring + pos, data, first);
+        std::memcpy(ring, data + first, len - first);
+    }
+
+    /**
+     * \return Magic bytes at start of file, including null terminator.
+     */
+    static const char* magic() noexcept {
+        return "GLRING1";
+    }
+
+  private:
+    /**
+     * \brief Throw exception.
+     *
+     * \param what Failed operation.
+     * \param path File path.
+     *
+     * \throw std::runtime_error always.
+     */
+    static void fail(const char* what, const std::string& path) {
+        std::stringstream ss;
+        ss << "RingFileSink: Failed to " << what << " '" << path << '\'';
+        throw std::runtime_error(ss.str());
+    }
+
+    const int              m_fd;   /**< File descriptor. */
+    char*                  m_map;  /**< Mapped file. */
+    const size_t           m_size; /**< Ring size. */
+    std::atomic<uint64_t>* m_head; /**< Number of bytes ever written. */
+};
+
+/**
+ * \brief Write output of a RingFileSink in order, oldest first.
+ *
+ * Works on the file of a running or crashed process as well. If the ring
+ * has wrapped, the partially overwritten oldest line is skipped.
+ *
+ * \param in  Ring file, opened in binary mode.
+ * \param out Output stream.
+ *
+ * \throw std::runtime_error if \p in isn't a ring file.
+ *
+ * \sa RingFileSink
+ *
+ */
+inline void read_ring(std::istream& in, std::ostream& out) {
+    char     m[8];
+    uint64_t size = 0;
+    uint64_t head = 0;
+    if (!in.read(m, sizeof(m)) ||
+        std::memcmp(m, RingFileSink::magic(), sizeof(m)) != 0 ||
+        !in.read(reinterpret_cast<char*>(&size), sizeof(size)) ||
+        !in.read(reinterpret_cast<char*>(&head), sizeof(head)) || size == 0 ||
+        !in.seekg(static_cast<std::streamoff>(RingFileSink::headerSize))) {
+        throw std::runtime_error("read_ring: Not a ring file");
+    }
+    std::string ring(static_cast<size_t>(size), '\0');
+    if (!in.read(&ring[0], static_cast<std::streamsize>(size))) {
+        throw std::runtime_error("read_ring: Truncated ring file");
+    }
+
+    if (head <= size) {
+        out.write(ring.data(), static_cast<std::streamsize>(head));
+        return;
+    }
+
+    // Oldest output starts where the newest ended, and its first line is
+    // partially overwritten
+    size_t      end = static_cast<size_t>(head % size);
+    std::string ordered = ring.substr(end) + ring.substr(0, end);
+    size_t      nl      = ordered.find('\n');
+    if (nl != std::string::npos) {
+        out.write(ordered.data() + nl + 1,
+            static_cast<std::streamsize>(ordered.size() - nl - 1));
+    }
+}
+#endif // _WIN32
+
+/**
+ * \brief Hide this section from doxygen */
+#ifndef DOXYGEN_HIDDEN
+
+/**
+ * \brief Functionality in this namespace is for internal use
+ */
+namespace internal {
+
+#ifdef __GNUC__
+/**
+ * \brief Demangler of variable type names.
+ */
+class Demangler {
+  public:
+    /**
+     * \brief Constructor.
+     */
+    Demangler() : m_buf(nullptr), m_buf_len(0) {
+    }
+
+    Demangler(const Demangler&) = delete;
+    Demangler& operator=(const Demangler&) = delete;
+
+    /**
+     * \brief Destructor. Free any allocated memory.
+     */
+    ~Demangler() {
+        // OK even if buf = nullptr
+        free(m_buf);
+    }
+
+    /**
+     * \brief Demangle type name.
+     *
+     * \param type_name Mangled type name.
+     * \return Demangled type name.
+     */
+    const char* demangle(const char* type_name) {
+        // Demangle name
+        int status = 0;
+        m_buf      = abi::__cxa_demangle(type_name, m_buf, &m_buf_len, &status);
+
+        // Check success
+        switch (status) {
+        case 0:
+            // Success. Do nothing.
+            break;
+        case -1: {
+            m_buf     = nullptr;
+            m_buf_len = 0;
+            std::stringstream ss;
+            ss << "Demangle: Invalid type name '" << type_name << '\'';
+            throw std::runtime_error(ss.str());
+            break;
+        }
+        case -2:
+            m_buf     = nullptr;
+            m_buf_len = 0;
+            throw std::runtime_error("Demangle: Memory allocation failure");
+            break;
+        case -3:
+            m_buf     = nullptr;
+            m_buf_len = 0;
+            throw std::runtime_error("Demangle: Invalid argument");
+            break;
+        default:
+            m_buf     = nullptr;
+            m_buf_len = 0;
+            throw std::runtime_error("Demangle: Unknown error");
+            break;
+        }
+
+        return m_buf;
+    }
+
+  private:
+    char*  m_buf;     /**< Demangle name buffer. Allocated with malloc. */
+    size_t m_buf_len; /**< Demangle name buffer length. */
+};
+#endif // __GNUC__
+
+/**
+ * \brief Settings shared by all threads and translation units.
+ *
+ * Read on every logging call with relaxed ordering, and only written when
+ * the user changes a setting. Kept on cache lines of its own, so that
+ * writes to nearby data don't slow down the reads.
+ */
+struct alignas(64) Config {
+    /**
+     * \brief Constructor. Default settings.
+     */
+    Config() noexcept :
+        levelGate(GL_LEVEL_TRACE), userLevel(GL_LEVEL_TRACE),
+        prefixes(static_cast<uint32_t>(prefix::FILE | prefix::LINE)),
+        userOutputEnabled(true), outputEnabled(true), colorEnabled(false),
+        timeFormat(static_cast<uint32_t>(time_format::LOCAL_MILLISECONDS)),
+        format(static_cast<uint32_t>(gl::format::TEXT)),
+        floatFormat(static_cast<uint32_t>(float_format::DEFAULT)),
+        truncation(static_cast<uint32_t>(gl::truncation::ELIDE)),
+        matrixFormat(static_cast<uint32_t>(gl::matrix_format::INDEXED)),
+        maxElements(0), suppressedSummary(false), statsEnabled(false),
+        filterGeneration(0), deferred(false), plainText(true),
+        previousValues(false), hexWidth(16), maxBytes(0), fanout(false) {
+    }
+
+    Config(const Config&) = delete;
+    Config& operator=(const Config&) = delete;
+
+    /** Lowest level of logging output that passes. Higher than level::L_OFF
+     * if output is disabled. */
+    std::atomic<uint32_t> levelGate;
+    /** Level set by user. */
+    std::atomic<uint32_t> userLevel;
+    /** Bitwise \c or of prefix. */
+    std::atomic<uint32_t> prefixes;
+    /** \c true if output is enabled by user. */
+    std::atomic<bool> userOutputEnabled;
+    /** \c true if output is enabled by user and sink doesn't discard it. */
+    std::atomic<bool> outputEnabled;
+    /** \c true if colored output is enabled. */
+    std::atomic<bool> colorEnabled;
+    /** Format of prefix::TIME. */
+    std::atomic<uint32_t> timeFormat;
+    /** Format of logging output. */
+    std::atomic<uint32_t> format;
+    /** Formatting of float and double. */
+    std::atomic<uint32_t> floatFormat;
+    /** How to shorten containers, arrays and matrices. */
+    std::atomic<uint32_t> truncation;
+    /** Formatting of matrices. */
+    std::atomic<uint32_t> matrixFormat;
+    /** Maximum number of elements to output, or 0 for all. */
+    std::atomic<size_t> maxElements;
+    /** \c true if number of suppressed messages is output. */
+    std::atomic<bool> suppressedSummary;
+    /** \c true if logging is counted by get_stats(). */
+    std::atomic<bool> statsEnabled;
+    /** Incremented when the filter changes. 0 until a filter is set. */
+    std::atomic<uint32_t> filterGeneration;
+    /** \c true if formatting of l() is deferred to the writer thread. */
+    std::atomic<bool> deferred;
+    /** \c true if format is format::TEXT, formatted when logging. */
+    std::atomic<bool> plainText;
+    /** \c true if l_changed() outputs previous values. */
+    std::atomic<bool> previousValues;
+    /** Bytes per line of l_hex(). */
+    std::atomic<size_t> hexWidth;
+    /** Maximum number of bytes of l_hex() and l_bytes(), or 0 for all. */
+    std::atomic<size_t> maxBytes;
+    /** \c true if sinks were added by gl::add_sink(). */
+    std::atomic<bool> fanout;
+};
+
+/**
+ * \return Settings. The same object in all translation units.
+ */
+inline Config& config() noexcept {
+    static Config c;
+    return c;
+}
+
+/**
+ * \return Current prefixes.
+ */
+inline prefix current_prefixes() noexcept {
+    return static_cast<prefix>(
+        config().prefixes.load(std::memory_order_relaxed));
+}
+
+/**
+ * \return \c true if sinks were added by gl::add_sink().
+ */
+inline bool is_fanout() noexcept {
+    return config().fanout.load(std::memory_order_relaxed);
+}
+
+/**
+ * \brief Check if a logging message of a level passes.
+ *
+ * \param lvl Level.
+ * \return \c true if message shall be output.
+ */
+inline bool is_level_enabled(uint32_t lvl) noexcept {
+    return GL_UNLIKELY(
+        config().levelGate.load(std::memory_order_relaxed) <= lvl);
+}
+
+/** Platform dependent path separator */
+constexpr char pathSeparator =
+#ifdef _WIN32
+    '\\';
+#else
+    '/';
+#endif // _WIN32
+
+/**
+ * \brief Get file name from file path at compile time.
+ *
+ * \param path File path, or what remains of it.
+ * \param name File name found so far.
+ * \return File name.
+ */
+constexpr const char* file_name(const char* path, const char* name) noexcept {
+    return *path == '\0' ?
+               name :
+               file_name(path + 1, *path == pathSeparator ? path + 1 : name);
+}
+
+/**
+ * \brief Render file, line and function prefix.
+ *
+ * \param p         Prefixes. Only FILE, LINE and FUNCTION are used.
+ * \param file_name File name without path.
+ * \param file_line Line number in file.
+ * \param func      Function name.
+ * \return Prefix text, followed by ": " if not empty.
+ */
+inline std::string render_site(
+    prefix p, const char* file_name, long file_line, const char* func) {
+    std::ostringstream os;
+
+    // FILE
+    if ((p & prefix::FILE) != prefix::NONE) {
+        os << file_name;
+    }
+
+    // LINE
+    if ((p & prefix::LINE) != prefix::NONE) {
+        // Output 'Line' prefix only if file name has not been
+        // output
+        if ((p & prefix::FILE) == prefix::NONE) {
+            os << "Line: ";
+        } else {
+            os << ":";
+        }
+        os << file_line;
+    }
+
+    // FUNCTION
+    if ((p & prefix::FUNCTION) != prefix::NONE) {
+        if ((p & (prefix::FILE | prefix::LINE)) != prefix::NONE) {
+            os << ", ";
+        }
+        os << func << "()";
+    }
+
+    std::string rv = os.str();
+    if (!rv.empty()) {
+        rv += ": ";
+    }
+    return rv;
+}
+
+/**
+ * \return Number of call sites given an id so far. Shared by all translation
+ * units.
+ */
+inline std::atomic<uint32_t>& site_count() noexcept {
+    static std::atomic<uint32_t> n(0);
+    return n;
+}
+
+class Site;
+
+/**
+ * \return First call site counted by get_stats(). Linked through the sites.
+ * Shared by all translation units.
+ */
+inline std::atomic<const Site*>& site_list() noexcept {
+    static std::atomic<const Site*> first(nullptr);
+    return first;
+}
+
+/**
+ * \brief Check if text matches a glob pattern.
+ *
+ * \param pat  Pattern. '*' matches any characters and '?' one character.
+ * \param text Text.
+ * \return \c true if \p text matches.
+ */
+inline bool glob_matches(const char* pat, const char* text) noexcept {
+    const char* star = nullptr; // After last '*' in pattern
+    const char* mark = nullptr; // Text matched by last '*'
+    while (*text != '\0') {
+        if (*pat == '*') {
+            star = ++pat;
+            mark = text;
+        } else if (*pat == '?' || *pat == *text) {
+            ++pat;
+            ++text;
+        } else if (star != nullptr) {
+            pat  = star;
+            text = ++mark;
+        } else {
+            return false;
+        }
+    }
+    while (*pat == '*') {
+        ++pat;
+    }
+    return *pat == '\0';
+}
+
+/**
+ * \brief Call sites selected by gl::set_filter(), parsed once.
+ */
+class Filter {
+  public:
+    /**
+     * \brief Constructor.
+     *
+     * \param text Filter, e.g. "motor_*.cpp:*,main.cpp:run".
+     */
+    explicit Filter(const std::string& text) : m_text(text), m_patterns() {
+        size_t begin = 0;
+        while (begin <= text.size()) {
+            size_t end = text.find(',', begin);
+            if (end == std::string::npos) {
+                end = text.size();
+            }
+            std::string p = text.substr(begin, end - begin);
+            p.erase(0, p.find_first_not_of(" \t"));
+            p.erase(p.find_last_not_of(" \t") + 1);
+            if (!p.empty()) {
+                size_t colon = p.find(':');
+                m_patterns.emplace_back(p.substr(0, colon),
+                    colon == std::string::npos ? "*" : p.substr(colon + 1));
+            }
+            begin = end + 1;
+        }
+    }
+
+    /**
+     * \brief Check if a call site is selected.
+     *
+     * \param path File path including name.
+     * \param name File name without path.
+     * \param func Function name.
+     * \return \c true if selected. Always if there are no patterns.
+     */
+    bool matches(
+        const char* path, const char* name, const char* func) const noexcept {
+        if (m_patterns.empty()) {
+            return true;
+        }
+        for (const Pattern& pt : m_patterns) {
+            if (glob_matches(pt.file.c_str(), pt.path ? path : name) &&
+                glob_matches(pt.func.c_str(), func)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * \return Filter as set.
+     */
+    const std::string& get_text() const noexcept {
+        return m_text;
+    }
+
+  private:
+    /** One comma separated part of the filter. */
+    struct Pattern {
+        /**
+         * \brief Constructor.
+         *
+         * \param fi Pattern of file.
+         * \param fu Pattern of function.
+         */
+        Pattern(std::string fi, std::string fu) :
+            file(std::move(fi)), func(std::move(fu)),
+            path(file.find(pathSeparator) != std::string::npos) {
+        }
+
+        std::string file; /**< Pattern of file. */
+        std::string func; /**< Pattern of function. */
+        bool        path; /**< \c true if \p file is matched with path. */
+    };
+
+    std::string          m_text;     /**< Filter as set. */
+    std::vector<Pattern> m_patterns; /**< Parts, of which one must match. */
+};
+
+/**
+ * \brief Current filter. Only used when a call site sees a new filter
+ * generation, so a lock is fine.
+ */
+struct FilterHolder {
+    /**
+     * \brief Constructor. No filter.
+     */
+    FilterHolder() : mutex(), filter() {
+    }
+
+    std::mutex                    mutex;  /**< Guards \p filter. */
+    std::shared_ptr<const Filter> filter; /**< Filter, or nullptr if none. */
+};
+
+/**
+ * \return Current filter. The same object in all translation units.
+ */
+inline FilterHolder& filter_holder() {
+    static FilterHolder h;
+    return h;
+}
+
+/**
+ * \brief Check if a call site is selected by the current filter.
+ *
+ * \param path File path including name.
+ * \param name File name without path.
+ * \param func Function name.
+ * \param gen  Set to the filter generation that the verdict is for.
+ * \return \c true if selected.
+ */
+inline bool filter_selects(const char* path, const char* name,
+    const char* func, uint32_t& gen) {
+    std::shared_ptr<const Filter> f;
+    {
+        FilterHolder&               h = filter_holder();
+        std::lock_guard<std::mutex> lock(h.mutex);
+        f   = h.filter;
+        gen = config().filterGeneration.load(std::memory_order_relaxed);
+    }
+    return f == nullptr || f->matches(path, name, func);
+}
+
+/**
+ * \brief Split macro arguments as written into argument names.
+ *
+ * \param args Arguments, e.g. "i, f(a, b)".
+ * \return Names, e.g. "i" and "f(a, b)".
+ */
+inline std::vector<std::string> split_arguments(const char* args) {
+    std::vector<std::string> rv;
+    std::string              cur;
+    int                      depth = 0;
+    char                     quote = '\0';
+    for (const char* c = args; *c != '\0'; ++c) {
+        if (quote != '\0') {
+            // Within string or character literal
+            cur += *c;
+            if (*c == '\\' && c[1] != '\0') {
+                cur += *++c;
+            } else if (*c == quote) {
+                quote = '\0';
+            }
+            continue;
+        }
+        switch (*c) {
+        case '"':
+        case '\'':
+            quote = *c;
+            break;
+        case '(':
+        case '[':
+        case '{':
+            ++depth;
+            break;
+        case ')':
+        case ']':
+        case '}':
+            --depth;
+            break;
+        case ',':
+            if (depth == 0) {
+                rv.push_back(cur);
+                cur.clear();
+                continue;
+            }
+            break;
+        default:
+            break;
+        }
+        cur += *c;
+    }
+    rv.push_back(cur);
+
+    // Remove surrounding white space
+    for (std::string& s : rv) {
+        size_t b = s.find_first_not_of(" \t\n");
+        size_t e = s.find_last_not_of(" \t\n");
+        s = b == std::string::npos ? std::string() : s.substr(b, e - b + 1);
+    }
+    return rv;
+}
+
+/**
+ * \brief Literal text of a logging call, split into one fragment before
+ * each variable. E.g. "a = " and ", b = " for l(a, b). Built once per
+ * call site, so that the text is written with one call per variable.
+ */
+class FormatPlan {
+  public:
+    /**
+     * \brief Constructor.
+     *
+     * \param args  Macro arguments as written, e.g. "a, b".
+     * \param types Type names of variables [\p n], or nullptr for none.
+     * \param n     Number of variables.
+     */
+    FormatPlan(
+        const char* args, const std::string* const* types, size_t n) :
+        m_text(),
+        m_ends() {
+        std::vector<std::string> names = split_arguments(args);
+        names.resize(n);
+        m_ends.reserve(n);
+        for (size_t k = 0; k < n; ++k) {
+            if (k != 0) {
+                m_text += ", ";
+            }
+            if (types != nullptr) {
+                m_text += *types[k];
+                m_text += ' ';
+            }
+            m_text += names[k];
+            m_text += " = ";
+            m_ends.push_back(m_text.size());
+        }
+    }
+
+    /**
+     * \brief Write fragment before a variable.
+     *
+     * \param os Output stream.
+     * \param k  Index of variable.
+     */
+    void write_fragment(std::ostream& os, size_t k) const {
+        size_t begin = k == 0 ? 0 : m_ends[k - 1];
+        os.write(m_text.data() + begin,
+            static_cast<std::streamsize>(m_ends[k] - begin));
+    }
+
+    /**
+     * \brief Write name of a variable. Only for plans without type names.
+     *
+     * \param os Output stream.
+     * \param k  Index of variable.
+     */
+    void write_name(std::ostream& os, size_t k) const {
+        size_t begin = k == 0 ? 0 : m_ends[k - 1] + 2;
+        os.write(m_text.data() + begin,
+            static_cast<std::streamsize>(m_ends[k] - 3 - begin));
+    }
+
+  private:
+    std::string         m_text; /**< All fragments. */
+    std::vector<size_t> m_ends; /**< End of each fragment in m_text. */
+};
+
+/**
+ * \brief Static information about a logging call site. Created once per
+ * expansion of a logging macro.
+ *
+ * Caches the rendered file, line and function prefix for each combination
+ * of those prefixes, and the FormatPlan of its variables.
+ *
+ */
+class Site {
+  public:
+    /**
+     * \brief Constructor. Can be evaluated at compile time.
+     *
+     * \param file_path File path including name.
+     * \param file_line Line number in file.
+     * \param func      Function name.
+     * \param args      Macro arguments as written, e.g. "i, s".
+     *
+     */
+    constexpr Site(const char* file_path, long file_line, const char* func,
+        const char* args = "") noexcept :
+        m_file_path(file_path),
+        m_file_name(file_name(file_path, file_path)), m_file_line(file_line),
+        m_func(func), m_args(args),
+        m_text{{nullptr}, {nullptr}, {nullptr}, {nullptr}, {nullptr},
+            {nullptr}, {nullptr}, {nullptr}},
+        m_plans{{nullptr}, {nullptr}}, m_id(0), m_session(0), m_calls(0),
+        m_bytes(0), m_next(nullptr), m_listed(false), m_filter(0) {
+    }
+
+    Site(const Site&) = delete;
+    Site& operator=(const Site&) = delete;
+
+    /**
+     * \return File path including name.
+     */
+    const char* get_file_path() const noexcept {
+        return m_file_path;
+    }
+
+    /**
+     * \return File name without path.
+     */
+    const char* get_file_name() const noexcept {
+        return m_file_name;
+    }
+
+    /**
+     * \return Line number in file.
+     */
+    long get_file_line_number() const noexcept {
+        return m_file_line;
+    }
+
+    /**
+     * \return Function name.
+     */
+    const char* get_function_name() const noexcept {
+        return m_func;
+    }
+
+    /**
+     * \return Macro arguments as written.
+     */
+    const char* get_arguments() const noexcept {
+        return m_args;
+    }
+
+    /**
+     * \return Id of site. Unique within the process, and assigned on first
+     * use.
+     */
+    uint32_t get_id() const noexcept {
+        uint32_t id = m_id.load(std::memory_order_relaxed);
+        if (id == 0) {
+            uint32_t n = site_count().fetch_add(1) + 1;
+            if (m_id.compare_exchange_strong(id, n)) {
+                id = n;
+            }
+        }
+        return id;
+    }
+
+    /**
+     * \return Binary output session that the site was last announced in.
+     */
+    uint32_t get_session() const noexcept {
+        return m_session.load(std::memory_order_acquire);
+    }
+
+    /**
+     * \brief Remember that site has been announced in binary output session.
+     *
+     * \param s Session.
+     */
+    void set_session(uint32_t s) const noexcept {
+        m_session.store(s, std::memory_order_release);
+    }
+
+    /**
+     * \brief Check if site is selected by gl::set_filter(). The verdict is
+     * cached until the filter changes.
+     *
+     * \return \c true if selected.
+     */
+    bool is_selected() const {
+        const uint32_t gen =
+            config().filterGeneration.load(std::memory_order_acquire);
+        if (gen == 0) {
+            return true;
+        }
+        const uint32_t v = m_filter.load(std::memory_order_relaxed);
+        if (GL_UNLIKELY((v >> 1) != gen)) {
+            return select();
+        }
+        return (v & 1) != 0;
+    }
+
+    /**
+     * \brief Count a logging message. Adds the site to site_list() the first
+     * time.
+     *
+     * \param bytes Bytes of logging output.
+     */
+    void count(uint64_t bytes) const noexcept {
+        if (!m_listed.load(std::memory_order_relaxed) &&
+            !m_listed.exchange(true, std::memory_order_relaxed)) {
+            const Site* first = site_list().load(std::memory_order_relaxed);
+            do {
+                m_next = first;
+            } while (!site_list().compare_exchange_weak(
+                first, this, std::memory_order_release));
+        }
+        m_calls.fetch_add(1, std::memory_order_relaxed);
+        m_bytes.fetch_add(bytes, std::memory_order_relaxed);
+    }
+
+    /**
+     * \return Number of counted logging messages.
+     */
+    uint64_t get_calls() const noexcept {
+        return m_calls.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * \return Bytes of counted logging output.
+     */
+    uint64_t get_bytes() const noexcept {
+        return m_bytes.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * \return Next site in site_list(), or nullptr if last.
+     */
+    const Site* get_next() const noexcept {
+        return m_next;
+    }
+
+    /**
+     * \brief Get rendered file, line and function prefix.
+     *
+     * \param p Prefixes. Only FILE, LINE and FUNCTION are used.
+     * \return Prefix text, followed by ": " if not empty.
+     */
+    const std::string& get_text(prefix p) const {
+        uint32_t idx = static_cast<uint32_t>(p) & textMask;
+        const std::string* t = m_text[idx].load(std::memory_order_acquire);
+        if (t == nullptr) {
+            // Intentionally never freed, since sites live until program end
+            std::string* n = new std::string(
+                render_site(p, m_file_name, m_file_line, m_func));
+            if (m_text[idx].compare_exchange_strong(
+                    t, n, std::memory_order_acq_rel)) {
+                t = n;
+            } else {
+                delete n;
+            }
+        }
+        return *t;
+    }
+
+    /**
+     * \brief Get text of variables.
+     *
+     * \param typed \c true if type names are included.
+     * \param make  Function building the plan of the variables logged at
+     * the site. Called on first use.
+     * \return Plan.
+     */
+    const FormatPlan& get_plan(
+        bool typed, FormatPlan* (*make)(const char*, bool)) const {
+        std::atomic<const FormatPlan*>& slot = m_plans[typed ? 1 : 0];
+        const FormatPlan* pl = slot.load(std::memory_order_acquire);
+        if (pl == nullptr) {
+            // Intentionally never freed, since sites live until program end
+            FormatPlan* n = make(m_args, typed);
+            if (slot.compare_exchange_strong(
+                    pl, n, std::memory_order_acq_rel)) {
+                pl = n;
+            } else {
+                delete n;
+            }
+        }
+        return *pl;
+    }
+
+  private:
+    /**
+     * \brief Match site against the current filter, and cache the verdict.
+     *
+     * \return \c true if selected.
+     */
+    bool select() const {
+        uint32_t   gen = 0;
+        const bool sel = filter_selects(m_file_path, m_file_name, m_func, gen);
+        m_filter.store((gen << 1) | (sel ? 1 : 0), std::memory_order_relaxed);
+        return sel;
+    }
+
+    /** Prefixes cached by get_text(). */
+    static constexpr uint32_t textMask =
+        static_cast<uint32_t>(prefix::FILE) |
+        static_cast<uint32_t>(prefix::LINE) |
+        static_cast<uint32_t>(prefix::FUNCTION);
+
+    const char* m_file_path; /**< File path including name. */
+    const char* m_file_name; /**< File name without path. */
+    const long  m_file_line; /**< Line number in file. */
+    const char* m_func;      /**< Function name. */
+    const char* m_args;      /**< Macro arguments as written. */
+    /** Rendered prefixes, indexed by prefix bits. */
+    mutable std::atomic<const std::string*> m_text[textMask + 1];
+    /** Plans without and with type names. */
+    mutable std::atomic<const FormatPlan*> m_plans[2];
+    mutable std::atomic<uint32_t> m_id;      /**< Id. 0 until first use. */
+    mutable std::atomic<uint32_t> m_session; /**< Last announced session. */
+    mutable std::atomic<uint64_t> m_calls;   /**< Counted messages. */
+    mutable std::atomic<uint64_t> m_bytes;   /**< Counted output. */
+    mutable const Site*           m_next;    /**< Next in site_list(). */
+    mutable std::atomic<bool>     m_listed;  /**< \c true if in site_list(). */
+    /** Filter generation shifted left one bit, ored with 1 if selected. */
+    mutable std::atomic<uint32_t> m_filter;
+};
+
+/**
+ * \brief Counters of one thread for get_stats(). Only written by the thread
+ * that owns it, so that counting needs neither locks nor read-modify-write
+ * operations. Handed over to a new thread when the owner exits.
+ */
+struct ThreadStats {
+    /**
+     * \brief Constructor. Owned by the constructing thread.
+     */
+    ThreadStats() noexcept :
+        calls(0), bytes(0), nanoseconds(0), maxNanoseconds(0), suppressed(0),
+        next(nullptr), owned(true) {
+    }
+
+    ThreadStats(const ThreadStats&) = delete;
+    ThreadStats& operator=(const ThreadStats&) = delete;
+
+    /**
+     * \brief Add to counter. Only called by the owner.
+     *
+     * \param c Counter.
+     * \param n Amount.
+     */
+    static void add(std::atomic<uint64_t>& c, uint64_t n) noexcept {
+        c.store(c.load(std::memory_order_relaxed) + n,
+            std::memory_order_relaxed);
+    }
+
+    std::atomic<uint64_t> calls;          /**< Logging messages. */
+    std::atomic<uint64_t> bytes;          /**< Bytes of logging output. */
+    std::atomic<uint64_t> nanoseconds;    /**< Time spent logging. */
+    std::atomic<uint64_t> maxNanoseconds; /**< Longest message. */
+    std::atomic<uint64_t> suppressed;     /**< Suppressed messages. */
+    ThreadStats*          next;           /**< Next in list. */
+    std::atomic<bool>     owned; /**< \c true while a thread owns it. */
+};
+
+/**
+ * \return First object of type \p T of all threads. Objects are never freed,
+ * so that they outlive their threads. Shared by all translation units.
+ *
+ * \tparam T Type with members \c next and \c owned, like ThreadStats.
+ */
+template<class T>
+std::atomic<T*>& thread_owned_list() noexcept {
+    static std::atomic<T*> first(nullptr);
+    return first;
+}
+
+/**
+ * \brief Owner of the object of type \p T of a thread. Takes an object left by
+ * an exited thread, if any.
+ *
+ * \tparam T Type with members \c next and \c owned, like ThreadStats.
+ */
+template<class T>
+class ThreadOwner {
+  public:
+    /**
+     * \brief Constructor.
+     */
+    ThreadOwner() : m_obj(nullptr) {
+        std::atomic<T*>& list = thread_owned_list<T>();
+        for (T* t = list.load(std::memory_order_acquire); t != nullptr;
+             t = t->next) {
+            bool owned = false;
+            if (t->owned.compare_exchange_strong(
+                    owned, true, std::memory_order_acquire)) {
+                m_obj = t;
+                return;
+            }
+        }
+        // Intentionally never freed
+        m_obj    = new T();
+        T* first = list.load(std::memory_order_relaxed);
+        do {
+            m_obj->next = first;
+        } while (!list.compare_exchange_weak(
+            first, m_obj, std::memory_order_release));
+    }
+
+    ThreadOwner(const ThreadOwner&) = delete;
+    ThreadOwner& operator=(const ThreadOwner&) = delete;
+
+    /**
+     * \brief Destructor. Leaves object to the next new thread.
+     */
+    ~ThreadOwner() {
+        m_obj->owned.store(false, std::memory_order_release);
+    }
+
+    /**
+     * \return Object.
+     */
+    T& get() noexcept {
+        return *m_obj;
+    }
+
+  private:
+    T* m_obj; /**< Object. */
+};
+
+/**
+ * \return Counters of current thread.
+ */
+inline ThreadStats& thread_stats() {
+    static thread_local ThreadOwner<ThreadStats> o;
+    return o.get();
+}
+
+/**
+ * \return \c true if logging is counted.
+ */
+inline bool is_stats_enabled() noexcept {
+    return config().statsEnabled.load(std::memory_order_relaxed);
+}
+
+/**
+ * \brief Count a message suppressed by a call site state.
+ */
+inline void count_suppressed() {
+    if (GL_UNLIKELY(is_stats_enabled())) {
+        ThreadStats::add(thread_stats().suppressed, 1);
+    }
+}
+
+/**
+ * \brief Counts a logging message of a call site, and the time spent on it,
+ * when destroyed. Does nothing unless stats were enabled on construction.
+ */
+class StatsScope {
+  public:
+    /**
+     * \brief Constructor.
+     *
+     * \param site Call site.
+     */
+    explicit StatsScope(const Site& site) :
+        m_site(nullptr), m_bytes(0), m_start() {
+        if (GL_UNLIKELY(is_stats_enabled())) {
+            m_site  = &site;
+            m_bytes = thread_stats().bytes.load(std::memory_order_relaxed);
+            m_start = std::chrono::steady_clock::now();
+        }
+    }
+
+    StatsScope(const StatsScope&) = delete;
+    StatsScope& operator=(const StatsScope&) = delete;
+
+    /**
+     * \brief Destructor.
+     */
+    ~StatsScope() {
+        if (m_site == nullptr) {
+            return;
+        }
+        const uint64_t ns = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - m_start)
+                .count());
+        ThreadStats& t = thread_stats();
+        ThreadStats::add(t.calls, 1);
+        ThreadStats::add(t.nanoseconds, ns);
+        if (ns > t.maxNanoseconds.load(std::memory_order_relaxed)) {
+            t.maxNanoseconds.store(ns, std::memory_order_relaxed);
+        }
+        m_site->count(t.bytes.load(std::memory_order_relaxed) - m_bytes);
+    }
+
+  private:
+    const Site* m_site;  /**< Call site, or nullptr if not counted. */
+    uint64_t    m_bytes; /**< Bytes output by thread on construction. */
+    /** Time of construction. */
+    std::chrono::steady_clock::time_point m_start;
+};
+
+/**
+ * \brief Write zero padded decimal number.
+ *
+ * \param out Output [\p n].
+ * \param v   Value. Must be less than 10^\p n.
+ * \param n   Number of digits.
+ */
+inline void write_digits(char* out, uint64_t v, size_t n) noexcept {
+    for (size_t i = n; i > 0; --i) {
+        out[i - 1] = static_cast<char>('0' + v % 10);
+        v /= 10;
+    }
+}
+
+/**
+ * \brief Local time of a second, formatted as hour:minute:second. Cached per
+ * thread, since converting to local time is slow and takes a lock.
+ */
+struct TimeCache {
+    std::time_t sec = -1; /**< Second of \p text. */
+    char        text[8];  /**< Formatted local time. Not null terminated. */
+};
+
+/**
+ * \brief Get current time of the clock used by a prefix::TIME format.
+ *
+ * \param fmt Format.
+ * \return Nanoseconds since epoch of the clock.
+ */
+inline int64_t current_time(time_format fmt) noexcept {
+    if (fmt == time_format::MONOTONIC) {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+
+/**
+ * \brief Render time according to a prefix::TIME format.
+ *
+ * \param buf Output. At least 32 characters.
+ * \param fmt Format.
+ * \param ns  Time, as returned by current_time().
+ * \return Number of characters written. 0 if local time is unavailable.
+ */
+inline size_t render_time(char* buf, time_format fmt, int64_t ns) noexcept {
+    if (fmt == time_format::MONOTONIC) {
+        // Nanoseconds of a monotonic clock, e.g. time since boot
+        uint64_t sec = static_cast<uint64_t>(ns) / 1000000000;
+        char     tmp[20];
+        size_t   n = 0;
+        do {
+            tmp[n++] = static_cast<char>('0' + sec % 10);
+            sec /= 10;
+        } while (sec != 0);
+        for (size_t i = 0; i < n; ++i) {
+            buf[i] = tmp[n - 1 - i];
+        }
+        buf[n] = '.';
+        write_digits(buf + n + 1, static_cast<uint64_t>(ns) % 1000000000, 9);
+        return n + 10;
+    }
+
+    int64_t     us  = ns / 1000;
+    std::time_t sec = static_cast<std::time_t>(us / 1000000);
+    uint64_t    sub = static_cast<uint64_t>(us % 1000000);
+
+    // Refresh cache when second changes
+    static thread_local TimeCache cache;
+    if (cache.sec != sec) {
+        std::tm local;
+#ifdef _WIN32
+        if (localtime_s(&local, &sec) != 0) {
+            return 0;
+        }
+#else
+        if (localtime_r(&sec, &local) == nullptr) {
+            return 0;
+        }
+#endif // _WIN32
+        write_digits(cache.text, static_cast<uint64_t>(local.tm_hour), 2);
+        cache.text[2] = ':';
+        write_digits(cache.text + 3, static_cast<uint64_t>(local.tm_min), 2);
+        cache.text[5] = ':';
+        write_digits(cache.text + 6, static_cast<uint64_t>(local.tm_sec), 2);
+        cache.sec = sec;
+    }
+
+    std::memcpy(buf, cache.text, sizeof(cache.text));
+    buf[8] = '.';
+    if (fmt == time_format::LOCAL_MICROSECONDS) {
+        write_digits(buf + 9, sub, 6);
+        return 15;
+    }
+    write_digits(buf + 9, sub / 1000, 3);
+    return 12;
+}
+
+/**
+ * \return Id of current thread, formatted once per thread.
+ */
+inline const std::string& thread_id_text() {
+    static thread_local const std::string text = []() {
+        std::ostringstream os;
+        os << std::this_thread::get_id();
+        return os.str();
+    }();
+    return text;
+}
+
+/**
+ * \brief Write prefix to stream.
+ *
+ * \param os   Output stream.
+ * \param text Rendered file, line and function prefix, see Site::get_text().
+ * \param p    Prefixes.
+ * \param fmt  Format of prefix::TIME.
+ * \param ns   Time, as returned by current_time(). Used only for
+ *             prefix::TIME.
+ * \param tid  Thread id. Used only for prefix::THREAD.
+ * \return Output stream.
+ */
+inline std::ostream& write_prefix(std::ostream& os, const std::string& text,
+    prefix p, time_format fmt, int64_t ns, const std::string& tid) {
+    /** Number of prefixes written */
+    uint32_t cnt = 0;
+    if (!text.empty()) {
+        // Skip final separator
+        os.write(text.data(), static_cast<std::streamsize>(text.size() - 2));
+        ++cnt;
+    }
+
+    // TIME
+    if ((p & prefix::TIME) != prefix::NONE) {
+        char   buf[32];
+        size_t len = render_time(buf, fmt, ns);
+        if (len != 0) {
+            if (cnt != 0) {
+                os.write(", ", 2);
+            }
+            os.write(buf, static_cast<std::streamsize>(len));
+            ++cnt;
+        }
+    }
+
+    // THREAD
+    if ((p & prefix::THREAD) != prefix::NONE) {
+        if (cnt != 0) {
+            os.write(", ", 2);
+        }
+        os.write("TID: ", 5);
+        os.write(tid.data(), static_cast<std::streamsize>(tid.size()));
+        ++cnt;
+    }
+
+    // Final separator, if any
+    if (cnt != 0) {
+        os.write(": ", 2);
+    }
+
+    return os;
+}
+
+inline std::ostream& write_captured_prefix(std::ostream& os, const Site& site);
+
+/**
+ * \brief Prefix formatter. */
+class PrefixFormatter {
+  public:
+    /**
+     * \brief Constructor.
+     *
+     * \param site Call site.
+     *
+     */
+    explicit PrefixFormatter(const Site& site) noexcept : m_site(site) {
+    }
+
+    friend std::ostream& operator<<(
+        std::ostream& os, const PrefixFormatter& p) noexcept;
+
+    /**
+     * \return Call site.
+     */
+    const Site& get_site() const noexcept {
+        return m_site;
+    }
+
+    /**
+     * \return File path including name.
+     */
+    const char* get_file_path() const noexcept {
+        return m_site.get_file_path();
+    }
+
+    /**
+     * \return Line number in file.
+     */
+    long get_file_line_number() const noexcept {
+        return m_site.get_file_line_number();
+    }
+
+    /**
+     * \return Function name.
+     */
+    const char* get_function_name() const noexcept {
+        return m_site.get_function_name();
+    }
+
+  private:
+    const Site& m_site; /**< Call site. */
+};
+
+/**
+ * \brief Write to stream.
+ *
+ * \param os Output stream.
+ * \param p  PrefixFormatter to output.
+ * \return Output stream.
+ *
+ */
+inline std::ostream& operator<<(
+    std::ostream& os, const PrefixFormatter& p) noexcept {
+    if (GL_UNLIKELY(is_fanout())) {
+        return write_captured_prefix(os, p.get_site());
+    }
+
+    // FILE, LINE and FUNCTION in one write
+    const prefix       pre     = current_prefixes();
+    const std::string& text    = p.get_site().get_text(pre);
+    const prefix       dynamic = prefix::TIME | prefix::THREAD;
+    if ((pre & dynamic) == prefix::NONE) {
+        return os.write(text.data(), static_cast<std::streamsize>(text.size()));
+    }
+
+    auto fmt = static_cast<time_format>(
+        config().timeFormat.load(std::memory_order_relaxed));
+    int64_t ns = 0;
+    if ((pre & prefix::TIME) != prefix::NONE) {
+        ns = current_time(fmt);
+    }
+    return write_prefix(os, text, pre, fmt, ns, thread_id_text());
+}
+
+/** Kind of number, for formatting arrays and matrices in blocks. */
+enum class NumberKind : uint8_t {
+    OTHER,   /**< Not formatted by write_integer() or write_floating(). */
+    INTEGER, /**< Formatted by write_integer(). */
+    FLOATING /**< Formatted by write_floating(). */
+};
+
+/**
+ * \brief Kind of number of a type.
+ *
+ * \tparam T Type.
+ */
+template<class T>
+struct NumberTraits
+    : std::integral_constant<NumberKind, NumberKind::OTHER> {};
+
+/** Kind of number of short. */
+template<>
+struct NumberTraits<short>
+    : std::integral_constant<NumberKind, NumberKind::INTEGER> {};
+
+/** Kind of number of unsigned short. */
+template<>
+struct NumberTraits<unsigned short>
+    : std::integral_constant<NumberKind, NumberKind::INTEGER> {};
+
+/** Kind of number of int. */
+template<>
+struct NumberTraits<int>
+    : std::integral_constant<NumberKind, NumberKind::INTEGER> {};
+
+/** Kind of number of unsigned int. */
+template<>
+struct NumberTraits<unsigned int>
+    : std::integral_constant<NumberKind, NumberKind::INTEGER> {};
+
+/** Kind of number of long. */
+template<>
+struct NumberTraits<long>
+    : std::integral_constant<NumberKind, NumberKind::INTEGER> {};
+
+/** Kind of number of unsigned long. */
+template<>
+struct NumberTraits<unsigned long>
+    : std::integral_constant<NumberKind, NumberKind::INTEGER> {};
+
+/** Kind of number of long long. */
+template<>
+struct NumberTraits<long long>
+    : std::integral_constant<NumberKind, NumberKind::INTEGER> {};
+
+/** Kind of number of unsigned long long. */
+template<>
+struct NumberTraits<unsigned long long>
+    : std::integral_constant<NumberKind, NumberKind::INTEGER> {};
+
+/** Kind of number of float. */
+template<>
+struct NumberTraits<float>
+    : std::integral_constant<NumberKind, NumberKind::FLOATING> {};
+
+/** Kind of number of double. */
+template<>
+struct NumberTraits<double>
+    : std::integral_constant<NumberKind, NumberKind::FLOATING> {};
+
+/**
+ * \brief Get number of elements to output before the gap.
+ *
+ * \param n   Number of elements.
+ * \param max Maximum number of elements to output, or 0 for all.
+ * \return Number of leading elements to output. \p n if none are left out.
+ */
+inline size_t elision_head(size_t n, size_t max) noexcept {
+    return max == 0 || n <= max ? n : max - max / 2;
+}
+
+/**
+ * \brief Get number of elements to output after the gap.
+ *
+ * \param n   Number of elements.
+ * \param max Maximum number of elements to output, or 0 for all.
+ * \return Number of trailing elements to output.
+ */
+inline size_t elision_tail(size_t n, size_t max) noexcept {
+    return max == 0 || n <= max ? 0 : max / 2;
+}
+
+/**
+ * \brief Write number of elements left out.
+ *
+ * \param os     Output stream.
+ * \param hidden Number of elements left out.
+ * \return Output stream.
+ */
+inline std::ostream& write_gap(std::ostream& os, size_t hidden) {
+    return os << ", ... (" << hidden << " more)";
+}
+
+/**
+ * \brief Minimum, maximum and mean of numbers, output instead of the numbers
+ * themselves with truncation::SUMMARIZE.
+ *
+ * \tparam T Value type.
+ * \tparam K Kind of number.
+ */
+template<class T, NumberKind K = NumberTraits<T>::value>
+class Summary;
+
+/**
+ * \brief Variable value formatter.
+ *
+ * \tparam T Value type.
+ *
+ */
+template<class T>
+class ValueFormatter {
+  public:
+    /**
+     * \brief Constructor.
+     *
+     * \param val Value.
+     *
+     */
+    explicit ValueFormatter(T& val) noexcept : m_val(val) {
+    }
+
+    // Container value helper functions.
+    std::ostream& sequence(std::ostream& os) const noexcept;
+    std::ostream& map(std::ostream& os) const noexcept;
+    std::ostream& stack(std::ostream& os) const noexcept;
+    std::ostream& queue(std::ostream& os) const noexcept;
+
+    template<class U>
+    friend std::ostream& operator<<(
+        std::ostream& os, const ValueFormatter<U>& f) noexcept;
+
+    /**
+     * \return Value to format.
+     */
+    T& get_value() const {
+        return m_val;
+    }
+
+  private:
+    T& m_val; /**< Value to format. Use non-const reference in case operator<<
+                 isn't const. */
+};
+
+/**
+ * \brief Create ValueFormatter with the right template type.
+ *  This solves the error "cannot refer to class template
+ * 'ValueFormatter' without a template argument list".
+ *
+ * Top-level const is removed, so that e.g. map keys of type
+ * const char* const use the same formatter as const char*.
+ *
+ * \tparam T Value type.
+ * \param val Value.
+ * \return New ValueFormatter.
+ */
+template<class T>
+ValueFormatter<typename std::remove_const<T>::type> format_value(T& val) {
+    using U = typename std::remove_const<T>::type;
+    return ValueFormatter<U>(const_cast<U&>(val));
+};
+
+/**
+ * \brief Minimum, maximum and mean of numbers.
+ *
+ * \tparam T Value type.
+ * \tparam K Kind of number.
+ */
+template<class T, NumberKind K>
+class Summary {
+  public:
+    /**
+     * \brief Constructor.
+     */
+    Summary() noexcept : m_n(0), m_min(), m_max(), m_sum(0.0) {
+    }
+
+    /**
+     * \return \c true if numbers that don't fit should be summarized.
+     */
+    static bool is_enabled() noexcept {
+        return config().truncation.load(std::memory_order_relaxed) ==
+               static_cast<uint32_t>(truncation::SUMMARIZE);
+    }
+
+    /**
+     * \brief Add number.
+     *
+     * \param v Number.
+     */
+    void add(T v) noexcept {
+        if (m_n == 0 || v < m_min) {
+            m_min = v;
+        }
+        if (m_n == 0 || m_max < v) {
+            m_max = v;
+        }
+        m_sum += static_cast<double>(v);
+        ++m_n;
+    }
+
+    /**
+     * \brief Write summary, e.g. "3 values, min = 1, max = 3, mean = 2".
+     *
+     * \param os Output stream.
+     * \return Output stream.
+     */
+    std::ostream& write(std::ostream& os) {
+        double mean = m_n == 0 ? 0.0 : m_sum / static_cast<double>(m_n);
+        return os << m_n << " values, min = " << format_value(m_min)
+                  << ", max = " << format_value(m_max)
+                  << ", mean = " << format_value(mean);
+    }
+
+  private:
+    size_t m_n;   /**< Number of numbers. */
+    T      m_min; /**< Minimum. */
+    T      m_max; /**< Maximum. */
+    double m_sum; /**< Sum. */
+};
+
+/**
+ * \brief Summary of values that aren't numbers. Never enabled.
+ *
+ * \tparam T Value type.
+ */
+template<class T>
+class Summary<T, NumberKind::OTHER> {
+  public:
+    /**
+     * \return \c false.
+     */
+    static bool is_enabled() noexcept {
+        return false;
+    }
+
+    /**
+     * \brief Ignore value.
+     */
+    void add(const T& /*v*/) noexcept {
+    }
+
+    /**
+     * \brief Write nothing.
+     *
+     * \param os Output stream.
+     * \return Output stream.
+     */
+    std::ostream& write(std::ostream& os) noexcept {
+        return os;
+    }
+};
+
+/**
+ * \brief General value formatter.
+ *
+ * \tparam T Value type.
+ * \param os Output stream.
+ * \param f  ValueFormatter.
+ * \return Output stream.
+ *
+ */
+template<class T>
+std::ostream& operator<<(
+    std::ostream& os, const ValueFormatter<T>& f) noexcept {
+    return os << f.m_val;
+}
+
+/**
+ * \brief Format char16_t as number, as before C++20 deleted its operator<<.
+ *
+ * \param os Output stream.
+ * \param f  ValueFormatter.
+ * \return Output stream.
+ *
+ */
+template<>
+inline std::ostream& operator<<(
+    std::ostream& os, const ValueFormatter<char16_t>& f) noexcept {
+    return os << +f.m_val;
+}
+
+/**
+ * \brief Format char32_t as number, as before C++20 deleted its operator<<.
+ *
+ * \param os Output stream.
+ * \param f  ValueFormatter.
+ * \return Output stream.
+ *
+ */
+template<>
+inline std::ostream& operator<<(
+    std::ostream& os, const ValueFormatter<char32_t>& f) noexcept {
+    return os << +f.m_val;
+}
+
+/**
+ * \brief Format wchar_t as number, as before C++20 deleted its operator<<.
+ *
+ * \param os Output stream.
+ * \param f  ValueFormatter.
+ * \return Output stream.
+ *
+ */
+template<>
+inline std::ostream& operator<<(
+    std::ostream& os, const ValueFormatter<wchar_t>& f) noexcept {
+    return os << +f.m_val;
+}
+
+/**
+ * \brief Format std::pair.
+ *
+ * \tparam U First type of pair.
+ * \tparam V Second type of pair.
+ * \param os Output stream.
+ * \param f  ValueFormatter.
+ * \return Output stream.
+ *
+ */
+template<class U, class V>
+std::ostream& operator<<(
+    std::ostream& os, const ValueFormatter<std::pair<U, V>>& f) noexcept {
+    return os << '{' << format_value(f.get_value().first) << ", "
+              << format_value(f.get_value().second) << '}';
+}
+
+/**
+ * \brief Format std::tuple.
+ *
+ * \tparam U First type of tuple.
+ * \tparam V Second type of tuple.
+ * \param os Output stream.
+ * \param f  ValueFormatter.
+ * \return Output stream.
+ *
+ */
+template<class U, class V>
+std::ostream& operator<<(
+    std::ostream& os, const ValueFormatter<std::tuple<U, V>>& f) noexcept {
+    return os << '{' << format_value(std::get<0>(f.get_value())) << ", "
+              << format_value(std::get<1>(f.get_value())) << '}';
+}
+
+/**
+ * \brief Format std::unique_ptr.
+ *
+ * \tparam U Pointer type.
+ * \param os Output stream.
+ * \param f  ValueFormatter.
+ * \return Output stream.
+ *
+ */
+template<class U>
+std::ostream& operator<<(
+    std::ostream& os, const ValueFormatter<std::unique_ptr<U>>& f) noexcept {
+    return os << f.get_value().get();
+}
+
+/**
+ * \brief Format std::shared_ptr.
+ *
+ * \tparam U Pointer type.
+ * \param os Output stream.
+ * \param f  ValueFormatter.
+ * \return Output stream.
+ *
+ */
+template<class U>
+std::ostream& operator<<(
+    std::ostream& os, const ValueFormatter<std::shared_ptr<U>>& f) noexcept {
+    return os << f.get_value().get();
+}
+
+/**
+ * \brief Format std::weak_ptr.
+ *
+ * \tparam U Pointer type.
+ * \param os Output stream.
+ * \param f  ValueFormatter.
+ * \return Output stream.
+ *
+ */
+template<class U>
+std::ostream& operator<<(
+    std::ostream& os, const ValueFormatter<std::weak_ptr<U>>& f) noexcept {
+    // Convert to temporary shared_ptr in order to get value.
+    std::shared_ptr<U> tmp = f.get_value().lock();
+    return os << tmp.get();
+}
+
+/**
+ * \brief Format bool.
+ *
+ * \param os Output stream.
+ * \param f  ValueFormatter.
+ * \return Output stream.
+ *
+ */
+template<>
+inline std::ostream& operator<<(
+    std::ostream& os, const ValueFormatter<bool>& f) noexcept {
+    return os << (f.m_val ? "true" : "false");
+}
+
+// 3.9.1 in C++ standard: Plain char, signed char, and unsigned
+// char are three distinct types
+
+/**
+ * \brief Format char.
+ *
+ * \param os Output stream.
+ * \param f  ValueFormatter.
+ * \return Output stream.
+ *
+ */
+template<>
+inline std::ostream& operator<<(
+    std::ostream& os, const ValueFormatter<char>& f) noexcept {
+    return os << '\'' << f.m_val << '\'';
+}
+
+/**
+ * \brief Format unsigned char.
+ *
+ * \param os Output stream.
+ * \param f  ValueFormatter.
+ * \return Output stream.
+ *
+ */
+template<>
+inline std::ostream& operator<<(
+    std::ostream& os, const ValueFormatter<unsigned char>& f) noexcept {
+    return os << '\'' << f.m_val << '\'';
+}
+
+/**
+ * \brief Format signed char.
+ *
+ * \param os Output stream.
+ * \param f  ValueFormatter.
+ * \return Output stream.
+ *
+ */
+template<>
+inline std::ostream& operator<<(
+    std::ostream& os, const ValueFormatter<signed char>& f) noexcept {
+    return os << '\'' << f.m_val << '\'';
+}
+
+/**
+ * \return Index of stream word caching whether the locale of a stream
+ * formats numbers like the "C" locale.
+ */
+inline int number_format_index() {
+    static const int i = std::ios_base::xalloc();
+    return i;
+}
+
+/** Bits of the stream word at number_format_index(). */
+enum NumberFormatBits : long {
+    NUMBER_FORMAT_CHECKED    = 1, /**< Locale has been checked. */
+    NUMBER_FORMAT_PLAIN      = 2, /**< Locale formats numbers plainly. */
+    NUMBER_FORMAT_REGISTERED = 4  /**< Imbue callback is registered. */
+};
+
+/**
+ * \brief Forget checked locale when a new locale is imbued.
+ *
+ * \param e   Event.
+ * \param os  Stream.
+ * \param idx Index of stream word.
+ */
+inline void reset_number_format(
+    std::ios_base::event e, std::ios_base& os, int idx) {
+    if (e == std::ios_base::imbue_event) {
+        os.iword(idx) &= NUMBER_FORMAT_REGISTERED;
+    }
+}
+
+/**
+ * \brief Check if numbers written to stream look the same as with the
+ * default locale, i.e. without digit grouping and with '.' as decimal point.
+ * Checked once per stream and locale.
+ *
+ * \param os Output stream.
+ * \return \c true if the locale of \p os formats numbers plainly.
+ */
+inline bool has_plain_locale(std::ios_base& os) {
+    long& w = os.iword(number_format_index());
+    if ((w & NUMBER_FORMAT_CHECKED) == 0) {
+        const auto& np = std::use_facet<std::numpunct<char>>(os.getloc());
+        bool plain     = np.grouping().empty() && np.decimal_point() == '.';
+        if ((w & NUMBER_FORMAT_REGISTERED) == 0) {
+            os.register_callback(reset_number_format, number_format_index());
+        }
+        w = NUMBER_FORMAT_CHECKED | NUMBER_FORMAT_REGISTERED |
+            (plain ? static_cast<long>(NUMBER_FORMAT_PLAIN) : 0L);
+    }
+    return (w & NUMBER_FORMAT_PLAIN) != 0;
+}
+
+template<class U>
+char* write_decimal(char* end, U v) noexcept;
+
+#ifdef GL_INTERNAL_SSE2
+/**
+ * \brief Convert value below 10^8 to 8 decimal digits, one per 16 bit lane,
+ * most significant first.
+ *
+ * Divides by 10000, then by 1000, 100, 10 and 1 with multiplications by
+ * reciprocals, as described by Wojciech Mula.
+ *
+ * \param v Value. Less than 10^8.
+ * \return Digits.
+ */
+inline __m128i decimal_digits8(uint32_t v) noexcept {
+    const __m128i x = _mm_cvtsi32_si128(static_cast<int>(v));
+    // abcd = v / 10000, efgh = v % 10000
+    const __m128i abcd = _mm_srli_epi64(
+        _mm_mul_epu32(x, _mm_set1_epi32(static_cast<int>(0xd1b71759u))), 45);
+    const __m128i efgh =
+        _mm_sub_epi32(x, _mm_mul_epu32(abcd, _mm_set1_epi32(10000)));
+    // [abcd * 4] x 4, [efgh * 4] x 4
+    const __m128i v1 = _mm_slli_epi64(_mm_unpacklo_epi16(abcd, efgh), 2);
+    const __m128i v1x2 = _mm_unpacklo_epi16(v1, v1);
+    const __m128i v2   = _mm_unpacklo_epi32(v1x2, v1x2);
+    // a, ab, abc, abcd, e, ef, efg, efgh
+    const __m128i v3 = _mm_mulhi_epu16(v2,
+        _mm_setr_epi16(8389, 5243, 13108, -32768, 8389, 5243, 13108, -32768));
+    const __m128i v4 = _mm_mulhi_epu16(v3,
+        _mm_setr_epi16(128, 2048, 8192, -32768, 128, 2048, 8192, -32768));
+    // Subtract 10 times the previous lane: a, b, c, d, e, f, g, h
+    const __m128i v5 =
+        _mm_slli_epi64(_mm_mullo_epi16(v4, _mm_set1_epi16(10)), 16);
+    return _mm_sub_epi16(v4, v5);
+}
+
+/**
+ * \brief Write unsigned integer of at least 13 digits in decimal, 16 digits
+ * at a time.
+ *
+ * \param end End of output buffer. At least 20 characters before it.
+ * \param v   Value. At least 10^12.
+ * \return Start of output.
+ */
+inline char* write_long_decimal(char* end, uint64_t v) noexcept {
+    const uint64_t e8   = 100000000u;
+    const uint64_t e16  = e8 * e8;
+    const uint64_t low  = v % e16;
+    const __m128i  zero = _mm_set1_epi8('0');
+    const __m128i  d    = _mm_add_epi8(
+        _mm_packus_epi16(decimal_digits8(static_cast<uint32_t>(low / e8)),
+            decimal_digits8(static_cast<uint32_t>(low % e8))),
+        zero);
+    end -= 16;
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(end), d);
+    if (v >= e16) {
+        return write_decimal(end, static_cast<uint32_t>(v / e16));
+    }
+    // At most 3 leading zeros
+    const int nz = ~_mm_movemask_epi8(_mm_cmpeq_epi8(d, zero));
+    return end + ((nz & 1) != 0   ? 0
+                     : (nz & 2) != 0 ? 1
+                     : (nz & 4) != 0 ? 2
+                                     : 3);
+}
+#endif // GL_INTERNAL_SSE2
+
+/**
+ * \brief Write unsigned integer in decimal, two digits at a time, or with
+ * SSE2 16 digits at a time if it has at least 13.
+ *
+ * The table is as fast up to 12 digits, since the SSE2 path always converts
+ * 16. From 13 digits, e.g. nanosecond timestamps, SSE2 took about 12 instead
+ * of 15 to 24 ns per value on x86-64.
+ *
+ * \param end End of output buffer. At least 20 characters before it.
+ * \param v   Value.
+ * \return Start of output.
+ */
+template<class U>
+char* write_decimal(char* end, U v) noexcept {
+    static const char pairs[] = "0001020304050607080910111213141516171819"
+                                "2021222324252627282930313233343536373839"
+                                "4041424344454647484950515253545556575859"
+                                "6061626364656667686970717273747576777879"
+                                "8081828384858687888990919293949596979899";
+#ifdef GL_INTERNAL_SSE2
+    if (sizeof(U) > 4 && static_cast<uint64_t>(v) >= 1000000000000u) {
+        return write_long_decimal(end, static_cast<uint64_t>(v));
+    }
+#endif // GL_INTERNAL_SSE2
+    while (v >= 100) {
+        const char* d = pairs + 2 * static_cast<size_t>(v % 100);
+        v /= 100;
+        *--end = d[1];
+        *--end = d[0];
+    }
+    if (v >= 10) {
+        const char* d = pairs + 2 * static_cast<size_t>(v);
+        *--end        = d[1];
+        *--end        = d[0];
+    } else {
+        *--end = static_cast<char>('0' + v);
+    }
+    return end;
+}
+
+/**
+ * \brief Get magnitude of integer.
+ *
+ * \param v Value.
+ * \return Absolute value of \p v.
+ */
+template<class T>
+typename std::make_unsigned<T>::type magnitude(T v, std::true_type /*signed*/) {
+    using U = typename std::make_unsigned<T>::type;
+    return v < 0 ? static_cast<U>(0U - static_cast<U>(v)) : static_cast<U>(v);
+}
+
+/**
+ * \brief Get magnitude of integer.
+ *
+ * \param v Value.
+ * \return \p v.
+ */
+template<class T>
+T magnitude(T v, std::false_type /*signed*/) {
+    return v;
+}
+
+/**
+ * \brief Check if integers written to stream look the same as with default
+ * formatting settings and locale.
+ *
+ * \param os Output stream.
+ * \return \c true if integers can be formatted by format_integer().
+ */
+inline bool is_plain_integer_stream(std::ios_base& os) {
+    return (os.flags() & (std::ios_base::basefield | std::ios_base::showpos)) ==
+               std::ios_base::dec &&
+           os.width() == 0 && has_plain_locale(os);
+}
+
+/**
+ * \brief Format integer in decimal.
+ *
+ * \param end End of output buffer. At least 21 characters before it.
+ * \param v   Value.
+ * \return Start of output.
+ */
+template<class T>
+char* format_integer(char* end, T v) noexcept {
+    char* p = write_decimal(end, magnitude(v, std::is_signed<T>()));
+    if (v < static_cast<T>(0)) {
+        *--p = '-';
+    }
+    return p;
+}
+
+/**
+ * \brief Write integer without locale lookups, unless stream formatting
+ * settings require them.
+ *
+ * \param os Output stream.
+ * \param v  Value.
+ * \return Output stream.
+ */
+template<class T>
+std::ostream& write_integer(std::ostream& os, T v) {
+    if (!is_plain_integer_stream(os)) {
+        return os << v;
+    }
+
+    char  buf[24];
+    char* end = buf + sizeof(buf);
+    char* p   = format_integer(end, v);
+    return os.write(p, end - p);
+}
+
+/**
+ * \brief Format floating point value like printf("%.*g").
+ *
+ * \param buf Output [\p n].
+ * \param n   Size of \p buf.
+ * \param p   Precision.
+ * \param v   Value.
+ * \return Number of characters, or 0 if the C locale doesn't use '.' as
+ * decimal point.
+ */
+inline size_t print_floating(char* buf, size_t n, int p, double v) noexcept {
+    int len = std::snprintf(buf, n, "%.*g", p, v);
+    if (len <= 0 || static_cast<size_t>(len) >= n) {
+        return 0;
+    }
+    for (int i = 0; i < len; ++i) {
+        char c = buf[i];
+        if (!((c >= '0' && c <= '9') || c == '.' || c == '-' || c == '+' ||
+                (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'))) {
+            return 0;
+        }
+    }
+    return static_cast<size_t>(len);
+}
+
+/**
+ * \brief Parse output of print_floating().
+ *
+ * \param s Characters.
+ * \return Value.
+ */
+template<class T>
+T parse_floating(const char* s) noexcept;
+
+/**
+ * \brief Parse output of print_floating().
+ *
+ * \param s Characters.
+ * \return Value.
+ */
+template<>
+inline float parse_floating<float>(const char* s) noexcept {
+    return std::strtof(s, nullptr);
+}
+
+/**
+ * \brief Parse output of print_floating().
+ *
+ * \param s Characters.
+ * \return Value.
+ */
+template<>
+inline double parse_floating<double>(const char* s) noexcept {
+    return std::strtod(s, nullptr);
+}
+
+/**
+ * \brief Check if floating point values written to stream look the same as
+ * with default formatting settings and locale.
+ *
+ * \param os Output stream.
+ * \return \c true if values can be formatted by format_floating().
+ */
+inline bool is_plain_floating_stream(std::ios_base& os) {
+    return (os.flags() &
+               (std::ios_base::floatfield | std::ios_base::showpos |
+                   std::ios_base::showpoint | std::ios_base::uppercase)) ==
+               0 &&
+           os.width() == 0 && has_plain_locale(os);
+}
+
+/**
+ * \brief Format float or double. Output is identical to operator<<, or the
+ * shortest output that reads back to the same value with
+ * float_format::ROUND_TRIP.
+ *
+ * \param buf       Output [\p n].
+ * \param n         Size of \p buf.
+ * \param precision Stream precision.
+ * \param v         Value.
+ * \return Number of characters, or 0 if the value must be formatted by a
+ * stream.
+ */
+template<class T>
+size_t format_floating(char* buf, size_t n, int precision, T v) noexcept {
+    if (config().floatFormat.load(std::memory_order_relaxed) !=
+            static_cast<uint32_t>(float_format::ROUND_TRIP) ||
+        v != v) {
+        return print_floating(buf, n, precision, v);
+    }
+
+    // Fewest significant digits that read back exactly. Values with fewer
+    // digits than the first attempt print without trailing zeros.
+    size_t    len    = 0;
+    const int digits = std::numeric_limits<T>::digits10;
+    for (int p = digits; p <= digits + 3; ++p) {
+        len = print_floating(buf, n, p, v);
+        if (len == 0 || parse_floating<T>(buf) == v) {
+            break;
+        }
+    }
+    return len;
+}
+
+/**
+ * \brief Write float or double without locale lookups, unless stream
+ * formatting settings require them.
+ *
+ * \param os Output stream.
+ * \param v  Value.
+ * \return Output stream.
+ *
+ * \sa format_floating()
+ */
+template<class T>
+std::ostream& write_floating(std::ostream& os, T v) {
+    char   buf[64];
+    size_t len = 0;
+    if (is_plain_floating_stream(os)) {
+        len = format_floating(
+            buf, sizeof(buf), static_cast<int>(os.precision()), v);
+    }
+    if (len == 0) {
+        return os << v;
+    }
+    return os.write(buf, static_cast<std::streamsize>(len));
+}
+
+/**
+ * \brief Text formatted into a fixed buffer, written to a stream whenever
+ * it fills up.
+ */
+class TextBlock {
+  public:
+    /**
+     * \brief Constructor.
+     *
+     * \param os Output stream.
+     */
+    explicit TextBlock(std::ostream& os) noexcept :
+        m_os(os), m_len(0), m_buf() {
+    }
+
+    TextBlock(const TextBlock&) = delete;
+    TextBlock& operator=(const TextBlock&) = delete;
+
+    /**
+     * \brief Destructor. Writes remaining text.
+     */
+    ~TextBlock() {
+        flush();
+    }
+
+    /**
+     * \return Output stream.
+     */
+    std::ostream& stream() noexcept {
+        return m_os;
+    }
+
+    /**
+     * \brief Get space for text.
+     *
+     * \param n Number of characters. At most 256.
+     * \return Space for at least \p n characters, added by commit().
+     */
+    char* reserve(size_t n) {
+        if (sizeof(m_buf) - m_len < n) {
+            flush();
+        }
+        return m_buf + m_len;
+    }
+
+    /**
+     * \brief Add text written to reserve().
+     *
+     * \param n Number of characters.
+     */
+    void commit(size_t n) noexcept {
+        m_len += n;
+    }
+
+    /**
+     * \brief Add text.
+     *
+     * \param s Characters [\p n].
+     * \param n Number of characters. At most 256.
+     */
+    void append(const char* s, size_t n) {
+        std::memcpy(reserve(n), s, n);
+        commit(n);
+    }
+
+    /**
+     * \brief Write text to stream.
+     */
+    void flush() {
+        m_os.write(m_buf, static_cast<std::streamsize>(m_len));
+        m_len = 0;
+    }
+
+  private:
+    std::ostream& m_os;        /**< Output stream. */
+    size_t        m_len;       /**< Number of characters in buffer. */
+    char          m_buf[4096]; /**< Buffer. */
+};
+
+/**
+ * \brief Check if stream formats integers plainly.
+ *
+ * \param os Output stream.
+ * \return \c true if plain.
+ */
+inline bool is_plain_number_stream(std::ios_base& os,
+    std::integral_constant<NumberKind, NumberKind::INTEGER> /*kind*/) {
+    return is_plain_integer_stream(os);
+}
+
+/**
+ * \brief Check if stream formats floating point values plainly.
+ *
+ * \param os Output stream.
+ * \return \c true if plain.
+ */
+inline bool is_plain_number_stream(std::ios_base& os,
+    std::integral_constant<NumberKind, NumberKind::FLOATING> /*kind*/) {
+    return is_plain_floating_stream(os);
+}
+
+/**
+ * \brief Values that aren't numbers are formatted by the stream.
+ *
+ * \return \c false.
+ */
+inline bool is_plain_number_stream(std::ios_base& /*os*/,
+    std::integral_constant<NumberKind, NumberKind::OTHER> /*kind*/) {
+    return false;
+}
+
+/**
+ * \brief Add integer to block.
+ *
+ * \param b Block.
+ * \param v Value.
+ */
+template<class T>
+void append_number(TextBlock& b, T v,
+    std::integral_constant<NumberKind, NumberKind::INTEGER> /*kind*/) {
+    char  buf[24];
+    char* end = buf + sizeof(buf);
+    char* p   = format_integer(end, v);
+    b.append(p, static_cast<size_t>(end - p));
+}
+
+/**
+ * \brief Add floating point value to block.
+ *
+ * \param b Block.
+ * \param v Value.
+ */
+template<class T>
+void append_number(TextBlock& b, T v,
+    std::integral_constant<NumberKind, NumberKind::FLOATING> /*kind*/) {
+    const size_t n   = 64;
+    size_t       len = format_floating(b.reserve(n), n,
+        static_cast<int>(b.stream().precision()), v);
+    if (len == 0) {
+        b.flush();
+        b.stream() << v;
+    } else {
+        b.commit(len);
+    }
+}
+
+/**
+ * \brief Add number of elements left out to block.
+ *
+ * \param b      Block.
+ * \param hidden Number of elements left out.
+ */
+inline void append_gap(TextBlock& b, size_t hidden) {
+    b.append(", ... (", 7);
+    append_number(
+        b, hidden, std::integral_constant<NumberKind, NumberKind::INTEGER>());
+    b.append(" more)", 6);
+}
+
+/**
+ * \brief Format short.
+ *
+ * \param os Output stream.
+ * \param f  ValueFormatter.
+ * \return Output stream.
+ *
+ */
+template<>
+inline std::ostream& operator<<(
+    std::ostream& os, const ValueFormatter<short>& f) noexcept {
+    return write_integer(os, f.m_val);
+}
+
+/**
+ * \brief Format unsigned short.
+ *
+ * \param os Output stream.
+ * \param f  ValueFormatter.
+ * \return Output stream.
+ *
+ */
+template<>
+inline std::ostream& operator<<(
+    std::ostream& os, const ValueFormatter<unsigned short>& f) noexcept {
+    return write_integer(os, f.m_val);
+}
+
+/**
+ * \brief Format int.
+ *
+ * \param os Output stream.
+ * \param f  ValueFormatter.
+ * \return Output stream.
+ *
+ */
+template<>
+inline std::ostream& operator<<(
+    std::ostream& os, const ValueFormatter<int>& f) noexcept {
+    return write_integer(os, f.m_val);
+}
+
+/**
+ * \brief Format unsigned int.
+ *
+ * \param os Output stream.
+ * \param f  ValueFormatter.
+ * \return Output stream.
+ *
+ */
+template<>
+inline std::ostream& operator<<(
+    std::ostream& os, const ValueFormatter<unsigned int>& f) noexcept {
+    return write_integer(os, f.m_val);
+}
+
+/**
+ * \brief Format long.
+ *
+ * \param os Output stream.
+ * \param f  ValueFormatter.
+ * \return Output stream.
+ *
+ */
+template<>
+inline std::ostream& operator<<(
+    std::ostream& os, const ValueFormatter<long>& f) noexcept {
+    return write_integer(os, f.m_val);
+}
+
+/**
+ * \brief Format unsigned long.
+ *
+ * \param os Output stream.
+ * \param f  ValueFormatter.
+ * \return Output stream.
+ *
+ */
+template<>
+inline std::ostream& operator<<(
+    std::ostream& os, const ValueFormatter<unsigned long>& f) noexcept {
+    return write_integer(os, f.m_val);
+}
+
+/**
+ * \brief Format long long.
+ *
+ * \param os Output stream.
+ * \param f  ValueFormatter.
+ * \return Output stream.
+ *
+ */
+template<>
+inline std::ostream& operator<<(
+    std::ostream& os, const ValueFormatter<long long>& f) noexcept {
+    return write_integer(os, f.m_val);
+}
+
+/**
+ * \brief Format unsigned long long.
+ *
+ * \param os Output stream.
+ * \param f  ValueFormatter.
+ * \return Output stream.
+ *
+ */
+template<>
+inline std::ostream& operator<<(
+    std::ostream& os, const ValueFormatter<unsigned long long>& f) noexcept {
+    return write_integer(os, f.m_val);
+}
+
+/**
+ * \brief Format float.
+ *
+ * \param os Output stream.
+ * \param f  ValueFormatter.
+ * \return Output stream.
+ *
+ */
+template<>
+inline std::ostream& operator<<(
+    std::ostream& os, const ValueFormatter<float>& f) noexcept {
+    return write_floating(os, f.m_val);
+}
+
+/**
+ * \brief Format double.
+ *
+ * \param os Output stream.
+ * \param f  ValueFormatter.
+ * \return Output stream.
+ *
+ */
+template<>
+inline std::ostream& operator<<(
+    std::ostream& os, const ValueFormatter<double>& f) noexcept {
+    return write_floating(os, f.m_val);
+}
+
+/**
+ * \brief Format char*.
+ *
+ * \param os Output stream.
+ * \param f  ValueFormatter.
+ * \return Output stream.
+ *
+ */
+template<>
+inline std::ostream& operator<<(
+    std::ostream& os, const ValueFormatter<char*>& f) noexcept {
+    return os << '\"' << f.m_val << '\"';
+}
+
+/**
+ * \brief Format const char*.
+ *
+ * \param os Output stream.
+ * \param f  ValueFormatter.
+ * \return Output stream.
+ *
+ */
+template<>
+inline std::ostream& operator<<(
+    std::ostream& os, const ValueFormatter<const char*>& f) noexcept {
+    return os << '\"' << f.m_val << '\"';
+}
+
+/**
+ * \brief Format std::tm.
+ *
+ * \param os Output stream.
+ * \param f  ValueFormatter.
+ * \return Output stream.
+ *
+ */
+template<>
+inline std::ostream& operator<<(
+    std::ostream& os, const ValueFormatter<std::tm>& f) noexcept {
+    // Format as "YYYY-MM-DD HH:MM:SS", including null pointer
+    char buf[20];
+    if (std::strftime(buf, sizeof(buf), "%F %T", &f.m_val) == 0) {
+        os << "std::tm format error";
+    } else {
+        os << buf;
+    }
+    return os;
+}
+
+/**
+ * \brief Format std::div_t.
+ *
+ * \param os Output stream.
+ * \param f  ValueFormatter.
+ * \return Output stream.
+ *
+ */
+template<>
+inline std::ostream& operator<<(
+    std::ostream& os, const ValueFormatter<std::div_t>& f) noexcept {
+    return os << "{quot = " << f.m_val.quot << ", rem = " << f.m_val.rem << '}';
+}
+
+/**
+ * \brief Format std::ldiv_t.
+ *
+ * \param os Output stream.
+ * \param f  ValueFormatter.
+ * \return Output stream.
+ *
+ */
+template<>
+inline std::ostream& operator<<(
+    std::ostream& os, const ValueFormatter<std::ldiv_t>& f) noexcept {
+    return os << "{quot = " << f.m_val.quot << ", rem = " << f.m_val.rem << '}';
+}
+
+/**
+ * \brief Format std::lldiv_t.
+ *
+ * \param os Output stream.
+ * \param f  ValueFormatter.
+ * \return Output stream.
+ *
+ */
+template<>
+inline std::ostream& operator<<(
+    std::ostream& os, const ValueFormatter<std::lldiv_t>& f) noexcept {
+    return os << "{quot = " << f.m_val.quot << ", rem = " << f.m_val.rem << '}';
+}
+
+/**
+ * \brief Format std::ratio.
+ *
+ * \param os Output stream.
+ * \param f  ValueFormatter.
+ * \return Output stream.
+ *
+ */
+template<std::intmax_t U, std::intmax_t V>
+std::ostream& operator<<(
+    std::ostream& os, const ValueFormatter<std::ratio<U, V>>& f) noexcept {
+    return os << f.get_value().num << " / " << f.get_value().den;
+}
+
+/**
+ * \brief Format std::string.
+ *
+ * \param os Output stream.
+ * \param f  ValueFormatter.
+ * \return Output stream.
+ *
+ */
+template<>
+inline std::ostream& operator<<(
+    std::ostream& os, const ValueFormatter<std::string>& f) noexcept {
+    return os << '\"' << f.m_val << '\"';
+}
+
+/** ANSI code starting colored output, in red. */
+constexpr char colorStartCode[] = "\033[0;31m";
+/** ANSI code ending colored output. */
+constexpr char colorEndCode[] = "\033[0m";
+
+/**
+ * \brief Write ANSI color start code to stream, if color is enabled.
+ *
+ * \param os Output stream.
+ * \return Output stream.
+ *
+ */
+inline std::ostream& color_start(std::ostream& os) noexcept {
+    if (config().colorEnabled.load(std::memory_order_relaxed)) {
+        os << colorStartCode;
+    }
+    return os;
+}
+
+inline void end_capture(std::ostream& os) noexcept;
+
+/**
+ * \brief Write ANSI color end code to stream, if color is enabled.
+ *
+ * \param os Output stream.
+ * \return Output stream.
+ *
+ */
+inline std::ostream& color_end(std::ostream& os) noexcept {
+    if (GL_UNLIKELY(is_fanout())) {
+        end_capture(os);
+    }
+    if (config().colorEnabled.load(std::memory_order_relaxed)) {
+        os << colorEndCode;
+    }
+    return os;
+}
+
+/**
+ * \brief Get name of type. Demangled only once per type, and then cached.
+ *
+ * \tparam T Variable type.
+ * \return Type name.
+ */
+template<class T>
+const std::string& cached_type_name() {
+    // Initialization is thread safe, and each type has its own demangler
+    static const std::string name = []() {
+        const char* tn = typeid(T).name();
+#ifndef __GNUC__
+        return std::string(tn);
+#else
+        Demangler d;
+        return std::string(d.demangle(tn));
+#endif // __GNUC__
+    }();
+    return name;
+}
+
+/**
+ * \brief Variable type formatter.
+ *
+ * \tparam T Variable type.
+ * \param os Output stream.
+ * \return Output stream.
+ */
+template<class T>
+std::ostream& type_name(std::ostream& os) {
+    if ((current_prefixes() & prefix::TYPE_NAME) == prefix::TYPE_NAME) {
+        const std::string& tn = cached_type_name<T>();
+        os.write(tn.data(), static_cast<std::streamsize>(tn.size()));
+        os.put(' ');
+    }
+    return os;
+}
+
+/**
+ * \brief Build plan of the variables logged at a site.
+ *
+ * \tparam T    Variable types.
+ * \param args  Macro arguments as written.
+ * \param typed \c true if type names are included.
+ * \return New plan.
+ */
+template<class... T>
+FormatPlan* make_plan(const char* args, bool typed) {
+    const std::string* types[] = {
+        &cached_type_name<typename std::remove_reference<T>::type>()...};
+    return new FormatPlan(args, typed ? types : nullptr, sizeof...(T));
+}
+
+/**
+ * \brief Write variable with the text before it.
+ *
+ * \param os   Output stream.
+ * \param plan Plan.
+ * \param k    Index of variable. Incremented.
+ * \param v    Variable.
+ */
+template<class T>
+void write_variable(
+    std::ostream& os, const FormatPlan& plan, size_t& k, T& v) {
+    plan.write_fragment(os, k++);
+    os << format_value(v);
+}
+
+/**
+ * \brief Write names and values of variables of a call site.
+ *
+ * \tparam T   Variable types.
+ * \param os   Output stream.
+ * \param site Call site.
+ * \param make Function building the plan of the call site. Called on first
+ * use.
+ * \param v    Variables.
+ * \return Output stream.
+ */
+template<class... T>
+std::ostream& write_planned(std::ostream& os, const Site& site,
+    FormatPlan* (*make)(const char*, bool), T&... v) {
+    bool typed = (current_prefixes() & prefix::TYPE_NAME) == prefix::TYPE_NAME;
+    const FormatPlan& plan = site.get_plan(typed, make);
+
+    size_t k        = 0;
+    int    expand[] = {(write_variable(os, plan, k, v), 0)...};
+    static_cast<void>(expand);
+    return os;
+}
+
+/**
+ * \brief Write names and values of variables, e.g. "a = 1, b = 2".
+ *
+ * \tparam T   Variable types. References if lvalues.
+ * \param os   Output stream.
+ * \param site Call site.
+ * \param v    Variables.
+ * \return Output stream.
+ */
+template<class... T>
+std::ostream& write_variables(std::ostream& os, const Site& site, T&&... v) {
+    return write_planned(os, site, &make_plan<T...>, v...);
+}
+
+/**
+ * \brief Array.
+ *
+ * \tparam T Value type.
+ *
+ */
+template<class T>
+class Array {
+  public:
+    /**
+     * \brief Constructor.
+     *
+     * \param name      Name.
+     * \param val       Values [\p len].
+     * \param len       Number of values.
+     * \param maxElems  Maximum number of values to output, or 0 for all.
+     * \param prefixFmt PrefixFormatter.
+     *
+     */
+    explicit Array(const char* name, T& val, size_t len, size_t maxElems,
+        const PrefixFormatter& prefixFmt) noexcept :
+        m_name(name),
+        m_val(val), m_len(len), m_maxElems(maxElems), m_prefixFmt(prefixFmt) {
+    }
+
+    template<class U>
+    friend std::ostream& operator<<(
+        std::ostream& os, const Array<U>& a) noexcept;
+
+    /**
+     * \return Name.
+     */
+    const char* get_name() const noexcept {
+        return m_name;
+    }
+
+    /**
+     * \return Values.
+     */
+    T& get_values() const noexcept {
+        return m_val;
+    }
+
+    /**
+     * \return Number of values.
+     */
+    size_t get_number_of_values() const noexcept {
+        return m_len;
+    }
+
+    /**
+     * \return Maximum number of values to output, or 0 for all.
+     */
+    size_t get_max_elements() const noexcept {
+        return m_maxElems;
+    }
+
+    /**
+     * \return PrefixFormatter.
+     */
+    const PrefixFormatter& get_prefix_formatter() const noexcept {
+        return m_prefixFmt;
+    }
+
+  private:
+    const char*            m_name;      /**< Name. */
+    T&                     m_val;       /**< Values. */
+    const size_t           m_len;       /**< Number of values. */
+    const size_t           m_maxElems;  /**< Maximum number of values. */
+    const PrefixFormatter& m_prefixFmt; /**< PrefixFormatter. */
+};
+
+/**
+ * \brief Write values of Array to stream.
+ *
+ * \tparam U Value type.
+ * \param os Output stream.
+ * \param a  Array.
+ *
+ */
+template<class U>
+void write_elements(std::ostream& os, const Array<U>& a,
+    std::integral_constant<NumberKind, NumberKind::OTHER> /*kind*/) {
+    const size_t n    = a.get_number_of_values();
+    const size_t head = elision_head(n, a.get_max_elements());
+    const size_t tail = elision_tail(n, a.get_max_elements());
+    // Print first object without comma
+    if (head > 0) {
+        os << format_value(a.get_values()[0]);
+    }
+    // Print the rest
+    for (size_t i = 1; i < head; ++i) {
+        os << ", " << format_value(a.get_values()[i]);
+    }
+    if (head != n) {
+        write_gap(os, n - head - tail);
+    }
+    for (size_t i = n - tail; i < n; ++i) {
+        os << ", " << format_value(a.get_values()[i]);
+    }
+}
+
+/**
+ * \brief Write values of Array of numbers to stream, formatted in blocks.
+ *
+ * \tparam U Value type.
+ * \tparam K Kind of number.
+ * \param os   Output stream.
+ * \param a    Array.
+ * \param kind Kind of number.
+ *
+ */
+template<class U, NumberKind K>
+void write_elements(std::ostream& os, const Array<U>& a,
+    std::integral_constant<NumberKind, K> kind) {
+    if (!is_plain_number_stream(os, kind)) {
+        write_elements(
+            os, a, std::integral_constant<NumberKind, NumberKind::OTHER>());
+        return;
+    }
+
+    const size_t n    = a.get_number_of_values();
+    const size_t head = elision_head(n, a.get_max_elements());
+    const size_t tail = elision_tail(n, a.get_max_elements());
+    TextBlock    b(os);
+    for (size_t i = 0; i < head; ++i) {
+        if (i != 0) {
+            b.append(", ", 2);
+        }
+        append_number(b, a.get_values()[i], kind);
+    }
+    if (head != n) {
+        append_gap(b, n - head - tail);
+    }
+    for (size_t i = n - tail; i < n; ++i) {
+        b.append(", ", 2);
+        append_number(b, a.get_values()[i], kind);
+    }
+}
+
+/**
+ * \brief Write name and values of Array to stream, without prefix.
+ *
+ * \tparam U Value type.
+ * \param os Output stream.
+ * \param a  Array.
+ * \return Output stream.
+ *
+ */
+template<class U>
+std::ostream& write_values(std::ostream& os, const Array<U>& a) {
+    using E = typename std::remove_cv<typename std::remove_reference<decltype(
+        std::declval<U&>()[0])>::type>::type;
+    os << a.get_name() << " = {";
+    const size_t n = a.get_number_of_values();
+    Summary<E>   s;
+    if (s.is_enabled() && elision_head(n, a.get_max_elements()) != n) {
+        for (size_t i = 0; i < n; ++i) {
+            s.add(a.get_values()[i]);
+        }
+        s.write(os);
+    } else {
+        write_elements(os, a, NumberTraits<E>());
+    }
+    return os << '}';
+}
+
+/**
+ * \brief Write Array to stream.
+ *
+ * \tparam U Value type.
+ * \param os Output stream.
+ * \param a  Array.
+ * \return Output stream.
+ *
+ */
+template<class U>
+std::ostream& operator<<(std::ostream& os, const Array<U>& a) noexcept {
+    if (config().outputEnabled.load(std::memory_order_relaxed)) {
+        os << color_start << a.get_prefix_formatter() << type_name<U>;
+        write_values(os, a);
+        os << color_end << GL_NEWLINE;
+    }
+
+    return os;
+}
+
+/**
+ * \brief Create array.
+ *  This solves the error "cannot refer to class template 'Array' without a
+ * template argument list".
+ *
+ * \tparam T Value type.
+ * \param name      Name.
+ * \param val       Values.
+ * \param len       Number of values.
+ * \param maxElems  Maximum number of values to output, or 0 for all.
+ * \param prefixFmt PrefixFormatter.
+ * \return Array.
+ *
+ */
+template<class T>
+Array<typename std::remove_reference<T>::type> make_array(const char* name,
+    T&& val, size_t len, size_t maxElems, const PrefixFormatter& prefixFmt) {
+    return Array<typename std::remove_reference<T>::type>(
+        name, val, len, maxElems, prefixFmt);
+};
+
+/**
+ * \brief Matrix in a flat buffer, with a stride between rows or columns.
+ * Indexed like an array of arrays, so that it can be logged as a Matrix.
+ *
+ * \tparam T Element type.
+ *
+ */
+template<class T>
+class MatrixView {
+  public:
+    /**
+     * \brief Row of matrix.
+     */
+    class Row {
+      public:
+        /**
+         * \brief Constructor.
+         *
+         * \param p    First element of row.
+         * \param step Distance between elements of row.
+         */
+        Row(T* p, size_t step) noexcept : m_p(p), m_step(step) {
+        }
+
+        /**
+         * \param j Column.
+         * \return Element in column \p j.
+         */
+        T& operator[](size_t j) const noexcept {
+            return m_p[j * m_step];
+        }
+
+      private:
+        T*     m_p;    /**< First element of row. */
+        size_t m_step; /**< Distance between elements of row. */
+    };
+
+    /**
+     * \brief Constructor.
+     *
+     * \param p      First element.
+     * \param stride Distance between first elements of rows if \p l is
+     * layout::ROW_MAJOR, otherwise of columns.
+     * \param l      Layout.
+     */
+    MatrixView(T* p, size_t stride, layout l) noexcept :
+        m_p(p), m_rowStep(l == layout::ROW_MAJOR ? stride : 1),
+        m_colStep(l == layout::ROW_MAJOR ? 1 : stride) {
+    }
+
+    /**
+     * \param i Row.
+     * \return Row \p i.
+     */
+    Row operator[](size_t i) const noexcept {
+        return Row(m_p + i * m_rowStep, m_colStep);
+    }
+
+  private:
+    T*     m_p;       /**< First element. */
+    size_t m_rowStep; /**< Distance between first elements of rows. */
+    size_t m_colStep; /**< Distance between elements of a row. */
+};
+
+/**
+ * \brief Create matrix view.
+ *
+ * \tparam T Element type.
+ * \param p      First element.
+ * \param stride Distance between first elements of rows or columns.
+ * \param l      Layout.
+ * \return Matrix view.
+ */
+template<class T>
+MatrixView<T> make_matrix_view(T* p, size_t stride, layout l) noexcept {
+    return MatrixView<T>(p, stride, l);
+}
+
+/**
+ * \brief Type logged as type name of Matrix values.
+ *
+ * \tparam T Value type.
+ */
+template<class T>
+struct ShownType {
+    using type = T; /**< Type name to log. */
+};
+
+/**
+ * \brief Matrix view is logged as pointer to elements.
+ *
+ * \tparam T Element type.
+ */
+template<class T>
+struct ShownType<MatrixView<T>> {
+    using type = T*; /**< Type name to log. */
+};
+
+/**
+ * \brief Matrix.
+ *
+ * \tparam T Value type.
+ *
+ */
+template<class T>
+class Matrix {
+  public:
+    /**
+     * \brief Constructor.
+     *
+     * \param name      Name.
+     * \param val       Values [\p cols x \p rows].
+     * \param cols      Number of columns.
+     * \param rows      Number of rows.
+     * \param maxElems  Maximum number of values to output, or 0 for all.
+     * \param prefixFmt PrefixFormatter.
+     *
+     */
+    explicit Matrix(const char* name, T& val, size_t cols, size_t rows,
+        size_t maxElems, const PrefixFormatter& prefixFmt) noexcept :
+        m_name(name),
+        m_val(val), m_cols(cols), m_rows(rows), m_maxElems(maxElems),
+        m_prefixFmt(prefixFmt) {
+    }
+
+    template<class U>
+    friend std::ostream& operator<<(
+        std::ostream& os, const Matrix<U>& a) noexcept;
+
+    /**
+     * \return Name.
+     */
+    const char* get_name() const noexcept {
+        return m_name;
+    }
+
+    /**
+     * \return Values.
+     */
+    T& get_values() const noexcept {
+        return m_val;
+    }
+
+    /**
+     * \return Number of columns.
+     */
+    size_t get_number_of_columns() const noexcept {
+        return m_cols;
+    }
+
+    /**
+     * \return Number of rows.
+     */
+    size_t get_number_of_rows() const noexcept {
+        return m_rows;
+    }
+
+    /**
+     * \return Maximum number of values to output, or 0 for all.
+     */
+    size_t get_max_elements() const noexcept {
+        return m_maxElems;
+    }
+
+    /**
+     * \return PrefixFormatter.
+     */
+    const PrefixFormatter& get_prefix_formatter() const noexcept {
+        return m_prefixFmt;
+    }
+
+  private:
+    const char*            m_name;      /**< Name. */
+    T&                     m_val;       /**< Values. */
+    const size_t           m_cols;      /**< Number of columns. */
+    const size_t           m_rows;      /**< Number of rows. */
+    const size_t           m_maxElems;  /**< Maximum number of values. */
+    const PrefixFormatter& m_prefixFmt; /**< PrefixFormatter. */
+};
+
+/**
+ * \brief Write value of Matrix to stream.
+ *
+ * \tparam U Value type.
+ * \param os Output stream.
+ * \param m  Matrix.
+ * \param k  Index of value, in row-major order.
+ *
+ */
+template<class U>
+void write_element(std::ostream& os, const Matrix<U>& m, size_t k) {
+    size_t i = k / m.get_number_of_columns();
+    size_t j = k % m.get_number_of_columns();
+    os << '[' << i << ',' << j
+       << "] = " << format_value(m.get_values()[i][j]);
+}
+
+/**
+ * \brief Write values of Matrix to stream.
+ *
+ * \tparam U Value type.
+ * \param os Output stream.
+ * \param m  Matrix. Not empty.
+ *
+ */
+template<class U>
+void write_elements(std::ostream& os, const Matrix<U>& m,
+    std::integral_constant<NumberKind, NumberKind::OTHER> /*kind*/) {
+    const size_t n = m.get_number_of_columns() * m.get_number_of_rows();
+    const size_t head = elision_head(n, m.get_max_elements());
+    const size_t tail = elision_tail(n, m.get_max_elements());
+    for (size_t k = 0; k < head; ++k) {
+        if (k != 0) {
+            os << ", ";
+        }
+        write_element(os, m, k);
+    }
+    if (head != n) {
+        write_gap(os, n - head - tail);
+    }
+    for (size_t k = n - tail; k < n; ++k) {
+        os << ", ";
+        write_element(os, m, k);
+    }
+}
+
+/**
+ * \brief Add number in Matrix to block.
+ *
+ * \tparam U Value type.
+ * \tparam K Kind of number.
+ * \param b    Block.
+ * \param m    Matrix.
+ * \param k    Index of value, in row-major order.
+ * \param kind Kind of number.
+ *
+ */
+template<class U, NumberKind K>
+void append_element(TextBlock& b, const Matrix<U>& m, size_t k,
+    std::integral_constant<NumberKind, K> kind) {
+    using Index = std::integral_constant<NumberKind, NumberKind::INTEGER>;
+    size_t i = k / m.get_number_of_columns();
+    size_t j = k % m.get_number_of_columns();
+    b.append("[", 1);
+    append_number(b, i, Index());
+    b.append(",", 1);
+    append_number(b, j, Index());
+    b.append("] = ", 4);
+    append_number(b, m.get_values()[i][j], kind);
+}
+
+/**
+ * \brief Write values of Matrix of numbers to stream, formatted in blocks.
+ *
+ * \tparam U Value type.
+ * \tparam K Kind of number.
+ * \param os   Output stream.
+ * \param m    Matrix. Not empty.
+ * \param kind Kind of number.
+ *
+ */
+template<class U, NumberKind K>
+void write_elements(std::ostream& os, const Matrix<U>& m,
+    std::integral_constant<NumberKind, K> kind) {
+    if (!is_plain_number_stream(os, kind) || !is_plain_integer_stream(os)) {
+        write_elements(
+            os, m, std::integral_constant<NumberKind, NumberKind::OTHER>());
+        return;
+    }
+
+    const size_t n = m.get_number_of_columns() * m.get_number_of_rows();
+    const size_t head = elision_head(n, m.get_max_elements());
+    const size_t tail = elision_tail(n, m.get_max_elements());
+    TextBlock    b(os);
+    for (size_t k = 0; k < head; ++k) {
+        if (k != 0) {
+            b.append(", ", 2);
+        }
+        append_element(b, m, k, kind);
+    }
+    if (head != n) {
+        append_gap(b, n - head - tail);
+    }
+    for (size_t k = n - tail; k < n; ++k) {
+        b.append(", ", 2);
+        append_element(b, m, k, kind);
+    }
+}
+
+/**
+ * \brief Add value of Matrix to block, formatted by the stream.
+ *
+ * \tparam V Value type.
+ * \param b Block.
+ * \param v Value.
+ */
+template<class V>
+void append_cell(TextBlock& b, const V& v,
+    std::integral_constant<NumberKind, NumberKind::OTHER> /*kind*/) {
+    b.flush();
+    b.stream() << format_value(v);
+}
+
+/**
+ * \brief Add number of Matrix to block.
+ *
+ * \tparam V Value type.
+ * \tparam K Kind of number.
+ * \param b    Block.
+ * \param v    Value.
+ * \param kind Kind of number.
+ */
+template<class V, NumberKind K>
+void append_cell(
+    TextBlock& b, const V& v, std::integral_constant<NumberKind, K> kind) {
+    append_number(b, v, kind);
+}
+
+/**
+ * \brief Add row of Matrix to block, as values separated by spaces.
+ *
+ * \tparam U Value type.
+ * \tparam K Kind of number.
+ * \param b    Block.
+ * \param m    Matrix.
+ * \param i    Row.
+ * \param kind Kind of number.
+ */
+template<class U, NumberKind K>
+void append_row(TextBlock& b, const Matrix<U>& m, size_t i,
+    std::integral_constant<NumberKind, K> kind) {
+    using Index  = std::integral_constant<NumberKind, NumberKind::INTEGER>;
+    const size_t n    = m.get_number_of_columns();
+    const size_t head = elision_head(n, m.get_max_elements());
+    const size_t tail = elision_tail(n, m.get_max_elements());
+    // Row pointer or view, looked up once per row
+    const auto& row = m.get_values()[i];
+    for (size_t j = 0; j < head; ++j) {
+        if (j != 0) {
+            b.append(" ", 1);
+        }
+        append_cell(b, row[j], kind);
+    }
+    if (head != n) {
+        b.append(" ... (", 6);
+        append_number(b, n - head - tail, Index());
+        b.append(" more)", 6);
+    }
+    for (size_t j = n - tail; j < n; ++j) {
+        b.append(" ", 1);
+        append_cell(b, row[j], kind);
+    }
+}
+
+/**
+ * \brief Write values of Matrix to stream as matrix_format::GRID.
+ *
+ * Rows in the middle are left out to stay within the maximum number of
+ * values, and values in the middle of rows that alone exceed it.
+ *
+ * \tparam U Value type.
+ * \tparam K Kind of number.
+ * \param os   Output stream.
+ * \param m    Matrix. Not empty.
+ * \param kind Kind of number.
+ *
+ */
+template<class U, NumberKind K>
+void write_grid(std::ostream& os, const Matrix<U>& m,
+    std::integral_constant<NumberKind, K> kind) {
+    using Index  = std::integral_constant<NumberKind, NumberKind::INTEGER>;
+    using Other  = std::integral_constant<NumberKind, NumberKind::OTHER>;
+    const size_t rows = m.get_number_of_rows();
+    const size_t cols = m.get_number_of_columns();
+    const size_t max  = m.get_max_elements();
+    // Rows that fit into max, but at least one
+    const size_t rowMax = max == 0 ? 0 : std::max<size_t>(max / cols, 1);
+    const size_t head   = elision_head(rows, rowMax);
+    const size_t tail   = elision_tail(rows, rowMax);
+    const bool   plain  = is_plain_number_stream(os, kind);
+    TextBlock    b(os);
+    append_number(b, rows, Index());
+    b.append(" x ", 3);
+    append_number(b, cols, Index());
+    for (size_t i = 0; i < rows; ++i) {
+        if (i == head && head != rows) {
+            b.append("\n... (", 6);
+            append_number(b, rows - head - tail, Index());
+            b.append(" more rows)", 11);
+            i = rows - tail;
+            if (i == rows) {
+                break;
+            }
+        }
+        b.append("\n", 1);
+        if (plain) {
+            append_row(b, m, i, kind);
+        } else {
+            append_row(b, m, i, Other());
+        }
+    }
+}
+
+/**
+ * \brief Write name and values of Matrix to stream, without prefix.
+ *
+ * \tparam U Value type.
+ * \param os Output stream.
+ * \param m  Matrix.
+ * \return Output stream.
+ *
+ */
+template<class U>
+std::ostream& write_values(std::ostream& os, const Matrix<U>& m) {
+    using E = typename std::remove_cv<typename std::remove_reference<decltype(
+        std::declval<U&>()[0][0])>::type>::type;
+    os << m.get_name() << ": ";
+    if (m.get_number_of_columns() <= 0 || m.get_number_of_rows() <= 0) {
+        return os << "{}";
+    }
+    const size_t n = m.get_number_of_columns() * m.get_number_of_rows();
+    Summary<E>   s;
+    if (s.is_enabled() && elision_head(n, m.get_max_elements()) != n) {
+        for (size_t i = 0; i < m.get_number_of_rows(); ++i) {
+            for (size_t j = 0; j < m.get_number_of_columns(); ++j) {
+                s.add(m.get_values()[i][j]);
+            }
+        }
+        return s.write(os);
+    }
+    if (config().matrixFormat.load(std::memory_order_relaxed) ==
+        static_cast<uint32_t>(matrix_format::GRID)) {
+        write_grid(os, m, NumberTraits<E>());
+        return os;
+    }
+    write_elements(os, m, NumberTraits<E>());
+    return os;
+}
+
+/**
+ * \brief Write Matrix to stream.
+ *
+ * \tparam U Value type.
+ * \param os Output stream.
+ * \param m  Matrix.
+ * \return Output stream.
+ *
+ */
+template<class U>
+std::ostream& operator<<(std::ostream& os, const Matrix<U>& m) noexcept {
+    if (config().outputEnabled.load(std::memory_order_relaxed)) {
+        os << color_start << m.get_prefix_formatter()
+           << type_name<typename ShownType<U>::type>;
+        write_values(os, m);
+        os << color_end << GL_NEWLINE;
+    }
+
+    return os;
+}
+
+/**
+ * \brief Create matrix.
+ *  This solves the error "cannot refer to class template 'Matrix' without a
+ * template argument list".
+ *
+ * \tparam T Value type.
+ * \param name      Name.
+ * \param val       Values.
+ * \param cols      Number of columns.
+ * \param rows      Number of rows.
+ * \param maxElems  Maximum number of values to output, or 0 for all.
+ * \param prefixFmt PrefixFormatter.
+ *
+ * \return New matrix.
+ *
+ */
+template<class T>
+Matrix<typename std::remove_reference<T>::type> make_matrix(const char* name,
+    T&& val, size_t cols, size_t rows, size_t maxElems,
+    const PrefixFormatter& prefixFmt) {
+    return Matrix<typename std::remove_reference<T>::type>(
+        name, val, cols, rows, maxElems, prefixFmt);
+};
+
+/**
+ * \return Lowercase hexadecimal digit.
+ *
+ * \param v Value. Only the lowest 4 bits are used.
+ */
+inline char hex_digit(unsigned v) noexcept {
+    return "0123456789abcdef"[v & 0x0Fu];
+}
+
+/**
+ * \brief Write two hexadecimal digits per byte, 16 bytes at a time with SSE2.
+ *
+ * \param out Digits [2 * \p n].
+ * \param in  Bytes [\p n].
+ * \param n   Number of bytes.
+ */
+inline void encode_hex(char* out, const unsigned char* in, size_t n) noexcept {
+    size_t i = 0;
+#ifdef GL_INTERNAL_SSE2
+    const __m128i mask  = _mm_set1_epi8(0x0F);
+    const __m128i nine  = _mm_set1_epi8(9);
+    const __m128i zero  = _mm_set1_epi8('0');
+    const __m128i after = _mm_set1_epi8('a' - '0' - 10);
+    for (; n - i >= 16; i += 16) {
+        __m128i v  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        __m128i hi = _mm_and_si128(_mm_srli_epi16(v, 4), mask);
+        __m128i lo = _mm_and_si128(v, mask);
+        // '0' + nibble, and 'a' - 10 + nibble for nibbles above 9
+        hi = _mm_add_epi8(_mm_add_epi8(hi, zero),
+            _mm_and_si128(_mm_cmpgt_epi8(hi, nine), after));
+        lo = _mm_add_epi8(_mm_add_epi8(lo, zero),
+            _mm_and_si128(_mm_cmpgt_epi8(lo, nine), after));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 2 * i),
+            _mm_unpacklo_epi8(hi, lo));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 2 * i + 16),
+            _mm_unpackhi_epi8(hi, lo));
+    }
+#endif // GL_INTERNAL_SSE2
+    for (; i < n; ++i) {
+        out[2 * i]     = hex_digit(in[i] >> 4u);
+        out[2 * i + 1] = hex_digit(in[i]);
+    }
+}
+
+/**
+ * \brief Write bytes as ASCII, with '.' for bytes that aren't printable. 16
+ * bytes at a time with SSE2.
+ *
+ * \param out Characters [\p n].
+ * \param in  Bytes [\p n].
+ * \param n   Number of bytes.
+ */
+inline void encode_ascii(
+    char* out, const unsigned char* in, size_t n) noexcept {
+    size_t i = 0;
+#ifdef GL_INTERNAL_SSE2
+    const __m128i space = _mm_set1_epi8(' ' - 1);
+    const __m128i del   = _mm_set1_epi8(0x7F);
+    const __m128i dot   = _mm_set1_epi8('.');
+    for (; n - i >= 16; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        // Signed comparison, so bytes from 0x80 aren't printable
+        __m128i printable = _mm_andnot_si128(
+            _mm_cmpeq_epi8(v, del), _mm_cmpgt_epi8(v, space));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i),
+            _mm_or_si128(_mm_and_si128(printable, v),
+                _mm_andnot_si128(printable, dot)));
+    }
+#endif // GL_INTERNAL_SSE2
+    for (; i < n; ++i) {
+        out[i] = in[i] >= ' ' && in[i] < 0x7F ? static_cast<char>(in[i]) : '.';
+    }
+}
+
+/**
+ * \brief Bytes of memory, logged by l_hex() and l_bytes().
+ */
+class Bytes {
+  public:
+    /**
+     * \brief Constructor.
+     *
+     * \param name      Name.
+     * \param val       Bytes [\p len].
+     * \param len       Number of bytes.
+     * \param dump      \c true for lines of offset, hex and ASCII.
+     * \param prefixFmt PrefixFormatter.
+     *
+     */
+    explicit Bytes(const char* name, const void* val, size_t len, bool dump,
+        const PrefixFormatter& prefixFmt) noexcept :
+        m_name(name),
+        m_val(static_cast<const unsigned char*>(val)), m_len(len),
+        m_dump(dump), m_prefixFmt(prefixFmt) {
+    }
+
+    /**
+     * \return Name.
+     */
+    const char* get_name() const noexcept {
+        return m_name;
+    }
+
+    /**
+     * \return Bytes.
+     */
+    const unsigned char* get_values() const noexcept {
+        return m_val;
+    }
+
+    /**
+     * \return Number of bytes.
+     */
+    size_t get_number_of_values() const noexcept {
+        return m_len;
+    }
+
+    /**
+     * \return \c true for lines of offset, hex and ASCII.
+     */
+    bool is_dump() const noexcept {
+        return m_dump;
+    }
+
+    /**
+     * \return PrefixFormatter.
+     */
+    const PrefixFormatter& get_prefix_formatter() const noexcept {
+        return m_prefixFmt;
+    }
+
+  private:
+    const char*            m_name;      /**< Name. */
+    const unsigned char*   m_val;       /**< Bytes. */
+    const size_t           m_len;       /**< Number of bytes. */
+    const bool             m_dump;      /**< \c true for lines. */
+    const PrefixFormatter& m_prefixFmt; /**< PrefixFormatter. */
+};
+
+/**
+ * \return Bytes per line of l_hex(), in [1, 64].
+ */
+inline size_t hex_width() noexcept {
+    const size_t w = config().hexWidth.load(std::memory_order_relaxed);
+    return w == 0 ? 16 : std::min<size_t>(w, 64);
+}
+
+/**
+ * \brief Write bytes as hexadecimal digits.
+ *
+ * \param b  Text block.
+ * \param in Bytes [\p n].
+ * \param n  Number of bytes.
+ */
+inline void append_hex(TextBlock& b, const unsigned char* in, size_t n) {
+    for (size_t i = 0; i < n; i += 128) {
+        const size_t k = std::min<size_t>(n - i, 128);
+        encode_hex(b.reserve(2 * k), in + i, k);
+        b.commit(2 * k);
+    }
+}
+
+/**
+ * \brief Write one line of a hex dump, like "hexdump -C" does.
+ *
+ * \param b      Text block.
+ * \param in     All bytes.
+ * \param offset Offset of line.
+ * \param n      Number of bytes on line. At most \p width.
+ * \param width  Bytes per line.
+ */
+inline void append_dump_line(TextBlock& b, const unsigned char* in,
+    size_t offset, size_t n, size_t width) {
+    // Offset with at least 8 digits
+    char   digits[2 * sizeof(size_t)];
+    size_t k = sizeof(digits);
+    for (size_t o = offset; o != 0 || sizeof(digits) - k < 8; o >>= 4) {
+        digits[--k] = hex_digit(static_cast<unsigned>(o));
+    }
+    b.append("\n", 1);
+    b.append(digits + k, sizeof(digits) - k);
+    b.append("  ", 2);
+
+    char hex[2 * 64];
+    encode_hex(hex, in + offset, n);
+    char* out = b.reserve(3 * width + width / 8 + 1);
+    char* p   = out;
+    for (size_t i = 0; i < width; ++i) {
+        if (i < n) {
+            *p++ = hex[2 * i];
+            *p++ = hex[2 * i + 1];
+        } else {
+            *p++ = ' ';
+            *p++ = ' ';
+        }
+        *p++ = ' ';
+        if (i % 8 == 7 && i + 1 != width) {
+            *p++ = ' ';
+        }
+    }
+    *p++ = ' ';
+    b.commit(static_cast<size_t>(p - out));
+
+    out    = b.reserve(n + 2);
+    out[0] = '|';
+    encode_ascii(out + 1, in + offset, n);
+    out[n + 1] = '|';
+    b.commit(n + 2);
+}
+
+/**
+ * \brief Write name and bytes to stream, without prefix.
+ *
+ * \param os Output stream.
+ * \param c  Bytes.
+ * \return Output stream.
+ */
+inline std::ostream& write_values(std::ostream& os, const Bytes& c) {
+    const unsigned char* in = c.get_values();
+    const size_t         n  = c.get_number_of_values();
+    const size_t max = config().maxBytes.load(std::memory_order_relaxed);
+    os << c.get_name() << " = ";
+    if (!c.is_dump()) {
+        const size_t head = elision_head(n, max);
+        const size_t tail = elision_tail(n, max);
+        TextBlock    b(os);
+        append_hex(b, in, head);
+        if (head != n) {
+            b.flush();
+            os << " ... (" << n - head - tail << " more) ";
+            append_hex(b, in + n - tail, tail);
+        }
+        return os;
+    }
+
+    os << n << " bytes";
+    const size_t w = hex_width();
+    // Leave out whole lines
+    size_t head = std::min(n, (elision_head(n, max) + w - 1) / w * w);
+    size_t tail = std::max(head, (n - elision_tail(n, max)) / w * w);
+    if (head == tail) {
+        head = n;
+        tail = n;
+    }
+    TextBlock b(os);
+    for (size_t i = 0; i < head; i += w) {
+        append_dump_line(b, in, i, std::min(w, n - i), w);
+    }
+    if (head != n) {
+        b.flush();
+        os << "\n... (" << tail - head << " more)";
+        for (size_t i = tail; i < n; i += w) {
+            append_dump_line(b, in, i, std::min(w, n - i), w);
+        }
+    }
+    return os;
+}
+
+/**
+ * \brief Write Bytes to stream.
+ *
+ * \param os Output stream.
+ * \param c  Bytes.
+ * \return Output stream.
+ *
+ */
+inline std::ostream& operator<<(std::ostream& os, const Bytes& c) noexcept {
+    if (config().outputEnabled.load(std::memory_order_relaxed)) {
+        os << color_start << c.get_prefix_formatter();
+        write_values(os, c);
+        os << color_end << GL_NEWLINE;
+    }
+
+    return os;
+}
+
+/**
+ * \brief Part of a message following its prefix, kept while sinks added by
+ * gl::add_sink() are active so that each of them can write its own prefix.
+ *
+ */
+struct Capture {
+    const Site* site;  /**< Call site, or nullptr if nothing was captured. */
+    size_t      begin; /**< Position of text after prefix. */
+    size_t      end;   /**< Position of end of text, before color end. */
+    int64_t     ns;    /**< Time of message. */
+    time_format fmt;   /**< Format of \p ns. */
+};
+
+/**
+ * \brief Stream buffer collecting one logging message.
+ *
+ * Keeps track of whether the message asked for a flush, e.g. by ending with
+ * std::endl.
+ *
+ */
+class LineBuffer : public std::streambuf {
+  public:
+    /**
+     * \brief Constructor.
+     */
+    LineBuffer() : m_text(), m_flush(false), m_kept(false), m_capture() {
+    }
+
+    /**
+     * \return Message text.
+     */
+    const char* data() const noexcept {
+        return m_text.data();
+    }
+
+    /**
+     * \return Number of characters in message.
+     */
+    size_t size() const noexcept {
+        return m_text.size();
+    }
+
+    /**
+     * \return \c true if message asked for a flush.
+     */
+    bool is_flush_requested() const noexcept {
+        return m_flush;
+    }
+
+    /**
+     * \brief Mark message as one that overflow policies must not drop.
+     */
+    void keep() noexcept {
+        m_kept = true;
+    }
+
+    /**
+     * \return \c true if message must not be dropped.
+     */
+    bool is_kept() const noexcept {
+        return m_kept;
+    }
+
+    /**
+     * \brief Overwrite part of message.
+     *
+     * \param pos Position in message.
+     * \param s   Characters [\p n].
+     * \param n   Number of characters. \p pos + \p n must not exceed size().
+     */
+    void replace(size_t pos, const char* s, size_t n) noexcept {
+        m_text.replace(pos, n, s, n);
+    }
+
+    /**
+     * \return Message text, for editing in place.
+     */
+    std::string& text() noexcept {
+        return m_text;
+    }
+
+    /**
+     * \return Prefix and text positions of message.
+     */
+    const Capture& capture() const noexcept {
+        return m_capture;
+    }
+
+    /**
+     * \return Prefix and text positions of message, for recording them.
+     */
+    Capture& capture() noexcept {
+        return m_capture;
+    }
+
+    /**
+     * \brief Remove message, but keep allocated memory.
+     */
+    void clear() noexcept {
+        m_text.clear();
+        m_flush        = false;
+        m_kept         = false;
+        m_capture.site = nullptr;
+    }
+
+  protected:
+    /**
+     * \brief Append character.
+     *
+     * \param c Character.
+     * \return \p c.
+     */
+    int_type overflow(int_type c) override {
+        if (!traits_type::eq_int_type(c, traits_type::eof())) {
+            m_text.push_back(traits_type::to_char_type(c));
+        }
+        return traits_type::not_eof(c);
+    }
+
+    /**
+     * \brief Append characters.
+     *
+     * \param s Characters [\p n].
+     * \param n Number of characters.
+     * \return \p n.
+     */
+    std::streamsize xsputn(const char* s, std::streamsize n) override {
+        m_text.append(s, static_cast<size_t>(n));
+        return n;
+    }
+
+    /**
+     * \brief Remember that a flush was requested.
+     *
+     * \return 0.
+     */
+    int sync() override {
+        m_flush = true;
+        return 0;
+    }
+
+  private:
+    std::string m_text;    /**< Message text. */
+    bool        m_flush;   /**< \c true if message asked for a flush. */
+    bool        m_kept;    /**< \c true if message must not be dropped. */
+    Capture     m_capture; /**< Prefix and text positions. */
+};
+
+/**
+ * \brief Write prefix of message, and remember where the text after it
+ * starts, for sinks added by gl::add_sink().
+ *
+ * \param os   Output stream.
+ * \param site Call site.
+ * \return Output stream.
+ */
+inline std::ostream& write_captured_prefix(std::ostream& os, const Site& site) {
+    const prefix pre = current_prefixes();
+    auto         fmt = static_cast<time_format>(
+        config().timeFormat.load(std::memory_order_relaxed));
+    // Added sinks may show the time even if the main sink doesn't
+    const int64_t ns = current_time(fmt);
+    write_prefix(os, site.get_text(pre), pre, fmt, ns, thread_id_text());
+
+    auto* buf = dynamic_cast<LineBuffer*>(os.rdbuf());
+    if (buf != nullptr && buf->capture().site == nullptr) {
+        Capture& c = buf->capture();
+        c.site     = &site;
+        c.begin    = buf->size();
+        c.end      = std::string::npos;
+        c.ns       = ns;
+        c.fmt      = fmt;
+    }
+    return os;
+}
+
+/**
+ * \brief Remember where the text of a message ends, before color end code.
+ *
+ * \param os Output stream.
+ */
+inline void end_capture(std::ostream& os) noexcept {
+    auto* buf = dynamic_cast<LineBuffer*>(os.rdbuf());
+    if (buf != nullptr && buf->capture().site != nullptr &&
+        buf->capture().end == std::string::npos) {
+        buf->capture().end = buf->size();
+    }
+}
+
+inline void submit(const LineBuffer& buf);
+
+/**
+ * \brief Message buffer and stream of a thread. Reused between messages, so
+ * that building a message neither allocates nor locks in steady state.
+ *
+ */
+struct ThreadLine {
+    /**
+     * \brief Constructor.
+     */
+    ThreadLine() : buf(), os(&buf), busy(false) {
+    }
+
+    ThreadLine(const ThreadLine&) = delete;
+    ThreadLine& operator=(const ThreadLine&) = delete;
+
+    /**
+     * \brief Remove message, and undo formatting done by the previous one.
+     *
+     * Flags, fill, width and precision are set to the defaults of a new
+     * \c std::ostream, so that manipulators do not leak into later messages.
+     */
+    void reset() {
+        buf.clear();
+        os.clear();
+        os.flags(std::ios_base::skipws | std::ios_base::dec);
+        os.fill(' ');
+        os.width(0);
+        os.precision(6);
+    }
+
+    LineBuffer   buf;  /**< Message buffer. */
+    std::ostream os;   /**< Stream writing to \p buf. */
+    bool         busy; /**< \c true if a message is being built. */
+};
+
+/**
+ * \return Message buffer and stream of current thread.
+ */
+inline ThreadLine& thread_line() {
+    static thread_local ThreadLine t;
+    return t;
+}
+
+/**
+ * \brief One logging message. Collects the message in the buffer of the
+ * current thread and submits it with a single write on destruction.
+ *
+ * A message logged while another is being built on the same thread, e.g. by
+ * an operator<< that itself logs, gets a buffer of its own.
+ *
+ * Every message starts with default stream formatting, see
+ * ThreadLine::reset().
+ *
+ */
+class Line {
+  public:
+    /**
+     * \brief Constructor.
+     */
+    Line() : m_line(&thread_line()), m_own() {
+        if (m_line->busy) {
+            m_own.reset(new ThreadLine());
+            m_line = m_own.get();
+        }
+        m_line->busy = true;
+        m_line->reset();
+    }
+
+    Line(const Line&) = delete;
+    Line& operator=(const Line&) = delete;
+
+    /**
+     * \brief Destructor. Submit message.
+     */
+    ~Line() {
+        submit(m_line->buf);
+        m_line->busy = false;
+    }
+
+    /**
+     * \return Stream to write message to.
+     */
+    std::ostream& stream() noexcept {
+        return m_line->os;
+    }
+
+    /**
+     * \return Buffer that stream() writes to.
+     */
+    LineBuffer& buffer() noexcept {
+        return m_line->buf;
+    }
+
+  private:
+    ThreadLine*                 m_line; /**< Buffer and stream in use. */
+    std::unique_ptr<ThreadLine> m_own;  /**< Buffer used when nested. */
+};
+
+/**
+ * \brief Values of a logging message, copied when logging and formatted
+ * later by the writer thread.
+ */
+class DeferredRecord {
+  public:
+    DeferredRecord() = default;
+    DeferredRecord(const DeferredRecord&) = delete;
+    DeferredRecord& operator=(const DeferredRecord&) = delete;
+
+    /**
+     * \brief Destructor.
+     */
+    virtual ~DeferredRecord() = default;
+
+    /**
+     * \brief Write the rest of the message, after its prefix.
+     *
+     * \param os Output stream.
+     */
+    virtual void format(std::ostream& os) = 0;
+};
+
+/**
+ * \brief Memory of a thread for deferred records. Blocks are recycled, so
+ * that deferring makes no allocations in steady state.
+ *
+ * Only the owning thread allocates. Any thread may release, which pushes the
+ * block on a lock-free list that the owner takes whole when it runs out.
+ */
+class DeferArena {
+  public:
+    /** Size of smallest block. */
+    static constexpr size_t minSize = 64;
+    /** Number of block sizes, each twice the previous. */
+    static constexpr size_t classes = 5;
+    /** Size of largest block. */
+    static constexpr size_t maxSize = minSize << (classes - 1);
+
+    /**
+     * \brief Constructor. Owned by the constructing thread.
+     */
+    DeferArena() noexcept :
+        next(nullptr), owned(true), m_free(), m_returned() {
+    }
+
+    DeferArena(const DeferArena&) = delete;
+    DeferArena& operator=(const DeferArena&) = delete;
+
+    /**
+     * \brief Allocate memory. Only called by the owner.
+     *
+     * \param n Number of bytes.
+     * \return Memory aligned for any scalar type, or nullptr if \p n is
+     * larger than maxSize.
+     */
+    void* allocate(size_t n) {
+        size_t c = 0;
+        while (c < classes && (minSize << c) < n) {
+            ++c;
+        }
+        if (c == classes) {
+            return nullptr;
+        }
+        Block* b = m_free[c];
+        if (b == nullptr) {
+            b = m_returned[c].exchange(nullptr, std::memory_order_acquire);
+        }
+        if (b != nullptr) {
+            m_free[c] = b->next;
+        } else {
+            // Kept by the arena, which is never freed
+            b        = static_cast<Block*>(
+                ::operator new(sizeof(Block) + (minSize << c)));
+            b->arena = this;
+            b->cls   = c;
+        }
+        return b + 1;
+    }
+
+    /**
+     * \brief Release memory to the arena that allocated it.
+     *
+     * \param p Memory returned by allocate().
+     */
+    static void release(void* p) noexcept {
+        Block*               b = static_cast<Block*>(p) - 1;
+        std::atomic<Block*>& r = b->arena->m_returned[b->cls];
+        Block*               first = r.load(std::memory_order_relaxed);
+        do {
+            b->next = first;
+        } while (!r.compare_exchange_weak(first, b, std::memory_order_release,
+            std::memory_order_relaxed));
+    }
+
+    DeferArena*       next;  /**< Next in list. */
+    std::atomic<bool> owned; /**< \c true while a thread owns it. */
+
+  private:
+    /** Header of a block, followed by its memory. */
+    struct alignas(std::max_align_t) Block {
+        Block*      next;  /**< Next free block. */
+        DeferArena* arena; /**< Arena that allocated the block. */
+        size_t      cls;   /**< Size class. */
+    };
+
+    Block*              m_free[classes];     /**< Free blocks. */
+    std::atomic<Block*> m_returned[classes]; /**< Released by any thread. */
+};
+
+/**
+ * \return Deferred record memory of current thread.
+ */
+inline DeferArena& defer_arena() {
+    static thread_local ThreadOwner<DeferArena> o;
+    return o.get();
+}
+
+/**
+ * \brief Destroy deferred record, and release its memory.
+ *
+ * \param r Record allocated by defer_arena().
+ */
+inline void release_record(DeferredRecord* r) noexcept {
+    r->~DeferredRecord();
+    DeferArena::release(r);
+}
+
+/**
+ * \brief Bounded lock-free queue of logging messages, emptied by a background
+ * writer thread.
+ *
+ * Multiple producers and consumers are allowed, which is what makes
+ * overflow::DROP_OLDEST possible: a producer that finds the queue full may
+ * consume the oldest message itself.
+ *
+ */
+class AsyncWriter {
+  public:
+    /**
+     * \brief Constructor.
+     *
+     * \param target   Sink to write to, or nullptr for the current sink.
+     * \param prefixes Prefixes of captured messages written to \p target.
+     * \param color    \c true if captured messages written to \p target are
+     * colored.
+     */
+    explicit AsyncWriter(Sink* target = nullptr,
+        prefix prefixes = prefix::NONE, bool color = false) :
+        m_slots(), m_mask(0), m_enqueuePos(0), m_dequeuePos(0), m_written(0),
+        m_running(false), m_inFlight(0), m_sleeping(false), m_dropped(0),
+        m_capacity(1024), m_overflow(static_cast<int>(overflow::BLOCK)),
+        m_thread(), m_mutex(), m_cv(), m_control(), m_format(),
+        m_target(target), m_prefixes(prefixes), m_color(color) {
+    }
+
+    AsyncWriter(const AsyncWriter&) = delete;
+    AsyncWriter& operator=(const AsyncWriter&) = delete;
+
+    /**
+     * \brief Destructor. Write all queued messages and stop writer thread.
+     */
+    ~AsyncWriter() {
+        stop();
+    }
+
+    /**
+     * \brief Start writer thread, if not already running.
+     */
+    void start() {
+        std::lock_guard<std::mutex> lock(m_control);
+        if (m_running.load()) {
+            return;
+        }
+
+        // Round capacity up to a power of two
+        size_t cap = 2;
+        while (cap < m_capacity) {
+            cap <<= 1;
+        }
+        m_slots.reset(new Slot[cap]);
+        for (size_t i = 0; i < cap; ++i) {
+            m_slots[i].seq.store(i, std::memory_order_relaxed);
+        }
+        m_mask = cap - 1;
+        m_enqueuePos.store(0, std::memory_order_relaxed);
+        m_dequeuePos.store(0, std::memory_order_relaxed);
+        m_written.store(0, std::memory_order_relaxed);
+
+        m_running.store(true);
+        m_thread = std::thread(&AsyncWriter::run, this);
+    }
+
+    /**
+     * \brief Write all queued messages and stop writer thread, if running.
+     */
+    void stop() {
+        std::lock_guard<std::mutex> lock(m_control);
+        if (!m_running.load()) {
+            return;
+        }
+
+        // Let producers that already decided to enqueue finish
+        m_running.store(false);
+        while (m_inFlight.load() != 0) {
+            std::this_thread::yield();
+        }
+
+        wake();
+        m_thread.join();
+    }
+
+    /**
+     * \brief Enqueue message.
+     *
+     * \param data     Message text [\p len].
+     * \param len      Number of characters.
+     * \param flush    \c true if output shall be flushed after message.
+     * \param deferred Values to format after the text, or nullptr. Owned by
+     * the queue if pushed.
+     * \param capture  Call site and time of text following the prefix, for
+     * writing it with the prefixes of this writer, or nullptr.
+     * \param keep     \c true if the message must not be dropped, since later
+     * messages depend on it. It then waits for space like overflow::BLOCK.
+     * \return \c false if writer thread isn't running. The message is then
+     * not consumed.
+     */
+    bool push(const char* data, size_t len, bool flush,
+        DeferredRecord* deferred = nullptr, const Capture* capture = nullptr,
+        bool keep = false) {
+        m_inFlight.fetch_add(1);
+        if (!m_running.load()) {
+            m_inFlight.fetch_sub(1);
+            return false;
+        }
+
+        while (!try_push(data, len, flush, deferred, capture, keep)) {
+            overflow o = get_overflow();
+            if (o == overflow::DROP_NEWEST && !keep) {
+                m_dropped.fetch_add(1, std::memory_order_relaxed);
+                if (deferred != nullptr) {
+                    release_record(deferred);
+                }
+                break;
+            } else if (o == overflow::DROP_OLDEST && try_drop()) {
+                m_dropped.fetch_add(1, std::memory_order_relaxed);
+            } else {
+                wake();
+                std::this_thread::yield();
+            }
+        }
+
+        if (m_sleeping.load()) {
+            wake();
+        }
+        m_inFlight.fetch_sub(1);
+        return true;
+    }
+
+    /**
+     * \brief Wait until the messages enqueued so far are written, if the
+     * writer thread is running.
+     */
+    void drain() {
+        const size_t end = m_enqueuePos.load();
+        while (m_running.load() && m_written.load() < end) {
+            wake();
+            std::this_thread::yield();
+        }
+        // Wait for a stop in progress to write the rest
+        std::lock_guard<std::mutex> lock(m_control);
+    }
+
+    /**
+     * \return \c true if writer thread is running.
+     */
+    bool is_running() const noexcept {
+        return m_running.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * \param c Capacity. Used the next time the writer thread starts.
+     */
+    void set_capacity(size_t c) noexcept {
+        m_capacity = c;
+    }
+
+    /**
+     * \return Capacity.
+     */
+    size_t get_capacity() const noexcept {
+        return m_capacity;
+    }
+
+    /**
+     * \param o Overflow policy.
+     */
+    void set_overflow(overflow o) noexcept {
+        m_overflow.store(static_cast<int>(o), std::memory_order_relaxed);
+    }
+
+    /**
+     * \return Overflow policy.
+     */
+    overflow get_overflow() const noexcept {
+        return static_cast<overflow>(
+            m_overflow.load(std::memory_order_relaxed));
+    }
+
+    /**
+     * \return Number of dropped messages.
+     */
+    uint64_t get_dropped() const noexcept {
+        return m_dropped.load(std::memory_order_relaxed);
+    }
+
+  private:
+    /**
+     * \brief Queue element.
+     */
+    struct Slot {
+        Slot() :
+            seq(0), text(), flush(false), keep(false), deferred(nullptr),
+            site(nullptr), ns(0), fmt(time_format::LOCAL_MILLISECONDS),
+            thread() {
+        }
+
+        Slot(const Slot&) = delete;
+        Slot& operator=(const Slot&) = delete;
+
+        std::atomic<size_t> seq;      /**< Sequence number. */
+        std::string         text;     /**< Message text. */
+        bool                flush;    /**< \c true if flush was requested. */
+        std::atomic<bool>   keep;     /**< \c true if it must not be dropped. */
+        DeferredRecord*     deferred; /**< Values to format, or nullptr. */
+        const Site*         site;     /**< Site of text, or nullptr. */
+        int64_t             ns;       /**< Time, if \p site is set. */
+        time_format         fmt;      /**< Format of \p ns. */
+        std::string         thread;   /**< Thread, if \p site is set. */
+    };
+
+    /** Maximum number of messages written per batch. */
+    static constexpr size_t batchSize = 64;
+
+    /**
+     * \brief Try to enqueue message.
+     *
+     * \param data     Message text [\p len].
+     * \param len      Number of characters.
+     * \param flush    \c true if output shall be flushed after message.
+     * \param deferred Values to format after the text, or nullptr.
+     * \param capture  Call site and time of text without prefix, or nullptr.
+     * \param keep     \c true if message must not be dropped.
+     * \return \c false if queue is full.
+     */
+    bool try_push(const char* data, size_t len, bool flush,
+        DeferredRecord* deferred, const Capture* capture, bool keep) {
+        size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+        Slot*  slot;
+        while (true) {
+            slot         = &m_slots[pos & m_mask];
+            size_t   seq = slot->seq.load(std::memory_order_acquire);
+            intptr_t dif =
+                static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (dif == 0) {
+                if (m_enqueuePos.compare_exchange_weak(
+                        pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (dif < 0) {
+                return false;
+            } else {
+                pos = m_enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        // Reuses capacity of earlier messages
+        slot->text.assign(data, len);
+        slot->flush = flush;
+        slot->keep.store(keep, std::memory_order_relaxed);
+        slot->deferred = deferred;
+        slot->site     = nullptr;
+        if (capture != nullptr) {
+            slot->site = capture->site;
+            slot->ns   = capture->ns;
+            slot->fmt  = capture->fmt;
+            slot->thread.assign(thread_id_text());
+        }
+        slot->seq.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * \brief Try to dequeue message. Deferred values are formatted, so only
+     * the writer thread may pass \p out.
+     *
+     * \param out   Append message text here. May be nullptr to discard it.
+     * \param flush Set to \c true if message requested flush. May be nullptr.
+     * \return \c false if queue is empty.
+     */
+    bool try_pop(std::string* out, bool* flush) {
+        size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+        Slot*  slot;
+        while (true) {
+            slot         = &m_slots[pos & m_mask];
+            size_t   seq = slot->seq.load(std::memory_order_acquire);
+            intptr_t dif =
+                static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if (dif == 0) {
+                if (m_dequeuePos.compare_exchange_weak(
+                        pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (dif < 0) {
+                return false;
+            } else {
+                pos = m_dequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        if (out != nullptr && slot->site != nullptr) {
+            // Captured text gets the prefixes and color of this writer
+            m_format.reset();
+            if (m_color) {
+                m_format.os << colorStartCode;
+            }
+            write_prefix(m_format.os, slot->site->get_text(m_prefixes),
+                m_prefixes, slot->fmt, slot->ns, slot->thread);
+            m_format.os << slot->text;
+            if (m_color) {
+                m_format.os << colorEndCode;
+            }
+            m_format.os << GL_NEWLINE;
+            out->append(m_format.buf.data(), m_format.buf.size());
+        } else if (out != nullptr) {
+            out->append(slot->text);
+        }
+        if (slot->deferred != nullptr) {
+            if (out != nullptr) {
+                m_format.reset();
+                slot->deferred->format(m_format.os);
+                out->append(m_format.buf.data(), m_format.buf.size());
+            }
+            release_record(slot->deferred);
+            slot->deferred = nullptr;
+        }
+        if (flush != nullptr && slot->flush) {
+            *flush = true;
+        }
+        slot->seq.store(pos + m_mask + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * \brief Try to dequeue and discard the oldest message, unless it must be
+     * kept.
+     *
+     * \return \c false if queue is empty or the oldest message must be kept.
+     */
+    bool try_drop() {
+        size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+        Slot*  slot;
+        while (true) {
+            slot         = &m_slots[pos & m_mask];
+            size_t   seq = slot->seq.load(std::memory_order_acquire);
+            intptr_t dif =
+                static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if (dif == 0) {
+                // Only valid if the slot is still unclaimed, which the
+                // exchange checks
+                if (slot->keep.load(std::memory_order_relaxed)) {
+                    return false;
+                }
+                if (m_dequeuePos.compare_exchange_weak(
+                        pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (dif < 0) {
+                return false;
+            } else {
+                pos = m_dequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        if (slot->deferred != nullptr) {
+            release_record(slot->deferred);
+            slot->deferred = nullptr;
+        }
+        slot->seq.store(pos + m_mask + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * \brief Wake writer thread.
+     */
+    void wake() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_cv.notify_one();
+    }
+
+    void write(const std::string& batch, bool flush);
+
+    /**
+     * \brief Writer thread. Write messages in batches until stopped and
+     * queue is empty.
+     */
+    void run() {
+        std::string batch;
+        while (true) {
+            bool   flush = false;
+            size_t n     = 0;
+            batch.clear();
+            while (n < batchSize && try_pop(&batch, &flush)) {
+                ++n;
+            }
+
+            if (n != 0) {
+                write(batch, flush);
+                m_written.store(m_dequeuePos.load());
+                continue;
+            }
+            // Also counts messages dropped by producers
+            m_written.store(m_dequeuePos.load());
+
+            if (!m_running.load()) {
+                break;
+            }
+
+            // Sleep until woken by a producer. Recheck queue after
+            // announcing sleep, since a producer may have missed it.
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_sleeping.store(true);
+            size_t pos  = m_dequeuePos.load(std::memory_order_relaxed);
+            size_t seq  = m_slots[pos & m_mask].seq.load();
+            bool   idle = (seq != pos + 1) && m_running.load();
+            if (idle) {
+                m_cv.wait_for(lock, std::chrono::milliseconds(10));
+            }
+            m_sleeping.store(false);
+        }
+    }
+
+    std::unique_ptr<Slot[]> m_slots;      /**< Queue elements. */
+    size_t                  m_mask;       /**< Capacity - 1. */
+    std::atomic<size_t>     m_enqueuePos; /**< Next position to enqueue. */
+    std::atomic<size_t>     m_dequeuePos; /**< Next position to dequeue. */
+    std::atomic<size_t>     m_written;    /**< Position written up to. */
+    std::atomic<bool>       m_running;    /**< \c true if thread runs. */
+    std::atomic<int>        m_inFlight;   /**< Producers in push(). */
+    std::atomic<bool>       m_sleeping;   /**< \c true if thread sleeps. */
+    std::atomic<uint64_t>   m_dropped;    /**< Dropped messages. */
+    size_t                  m_capacity;   /**< Requested capacity. */
+    std::atomic<int>        m_overflow;   /**< Overflow policy. */
+    std::thread             m_thread;     /**< Writer thread. */
+    std::mutex              m_mutex;      /**< Protects \p m_cv. */
+    std::condition_variable m_cv;         /**< Wakes writer thread. */
+    std::mutex              m_control;    /**< Serializes start and stop. */
+    /** Stream formatting deferred values. Only used by writer thread. */
+    ThreadLine m_format;
+    Sink*      m_target;   /**< Sink written to, or nullptr for current. */
+    prefix     m_prefixes; /**< Prefixes of captured messages. */
+    bool       m_color;    /**< \c true if captured messages are colored. */
+};
+
+/**
+ * \return Process wide asynchronous writer.
+ */
+inline AsyncWriter& async_writer() {
+    static AsyncWriter w;
+    return w;
+}
+
+/**
+ * \brief Current sink.
+ *
+ */
+class SinkHolder {
+  public:
+    /**
+     * \brief Constructor. Write to std::cout by default.
+     */
+    SinkHolder() :
+        m_owner(std::make_shared<OstreamSink>(std::cout)),
+        m_sink(m_owner.get()) {
+    }
+
+    /**
+     * \brief Replace sink.
+     *
+     * \param s New sink.
+     */
+    void set(std::shared_ptr<Sink> s) {
+        m_sink.store(s.get());
+        m_owner.swap(s);
+    }
+
+    /**
+     * \return Current sink.
+     */
+    std::shared_ptr<Sink> get() const {
+        return m_owner;
+    }
+
+    /**
+     * \return Current sink.
+     */
+    Sink& sink() const noexcept {
+        return *m_sink.load(std::memory_order_acquire);
+    }
+
+  private:
+    std::shared_ptr<Sink> m_owner; /**< Keeps current sink alive. */
+    std::atomic<Sink*>    m_sink;  /**< Current sink. */
+};
+
+/**
+ * \return Process wide sink holder.
+ */
+inline SinkHolder& sink_holder() {
+    static SinkHolder h;
+    return h;
+}
+
+/**
+ * \brief When to flush the sink, set by gl::set_flush_bytes() and
+ * gl::set_flush_interval(). Counts output written since the last flush.
+ */
+class FlushPolicy {
+  public:
+    /**
+     * \brief Constructor. Can be evaluated at compile time.
+     */
+    constexpr FlushPolicy() noexcept :
+        m_bytes(0), m_ms(0), m_pending(0), m_since(0) {
+    }
+
+    FlushPolicy(const FlushPolicy&) = delete;
+    FlushPolicy& operator=(const FlushPolicy&) = delete;
+
+    /**
+     * \param n Bytes after which to flush, or 0 for no limit.
+     */
+    void set_bytes(size_t n) noexcept {
+        m_bytes.store(n, std::memory_order_relaxed);
+    }
+
+    /**
+     * \return Bytes after which to flush, or 0 for no limit.
+     */
+    size_t get_bytes() const noexcept {
+        return m_bytes.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * \param ms Milliseconds after which to flush, or 0 for no limit.
+     */
+    void set_interval(int64_t ms) noexcept {
+        m_ms.store(ms < 0 ? 0 : ms, std::memory_order_relaxed);
+    }
+
+    /**
+     * \return Milliseconds after which to flush, or 0 for no limit.
+     */
+    int64_t get_interval() const noexcept {
+        return m_ms.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * \return \c true if output is flushed by size or time. Otherwise each
+     * asynchronous batch is flushed, and synchronous output only if asked.
+     */
+    bool is_batched() const noexcept {
+        return get_bytes() != 0 || get_interval() != 0;
+    }
+
+    /**
+     * \brief Count output written to the sink.
+     *
+     * \param len Number of characters.
+     * \return \c true if the sink shall be flushed now, since enough output
+     * is pending.
+     */
+    bool add(size_t len) noexcept {
+        const size_t pending =
+            m_pending.fetch_add(len, std::memory_order_relaxed) + len;
+        const size_t bytes = get_bytes();
+        return bytes != 0 && pending >= bytes;
+    }
+
+    /**
+     * \brief Start waiting for the interval, unless already waiting.
+     *
+     * \return \c true if started now.
+     */
+    bool arm() noexcept {
+        int64_t none = 0;
+        return get_interval() != 0 &&
+               m_since.load(std::memory_order_relaxed) == 0 &&
+               m_since.compare_exchange_strong(none,
+                   current_time(time_format::MONOTONIC) | 1,
+                   std::memory_order_relaxed);
+    }
+
+    /**
+     * \return Nanoseconds until the interval has passed since the oldest
+     * output that isn't flushed. 0 or less if due, and
+     * std::numeric_limits<int64_t>::max() if no output is waiting.
+     */
+    int64_t time_left() const noexcept {
+        const int64_t since = m_since.load(std::memory_order_relaxed);
+        if (since == 0) {
+            return std::numeric_limits<int64_t>::max();
+        }
+        return since + get_interval() * 1000000 -
+               current_time(time_format::MONOTONIC);
+    }
+
+    /**
+     * \brief Flush sink, and forget pending output.
+     *
+     * \param s Sink.
+     */
+    void flush(Sink& s) {
+        m_pending.store(0, std::memory_order_relaxed);
+        m_since.store(0, std::memory_order_relaxed);
+        s.flush();
+    }
+
+  private:
+    std::atomic<size_t>  m_bytes;   /**< Bytes limit, or 0. */
+    std::atomic<int64_t> m_ms;      /**< Interval in ms, or 0. */
+    std::atomic<size_t>  m_pending; /**< Bytes since last flush. */
+    /** Monotonic time in ns of oldest output that isn't flushed, or 0. */
+    std::atomic<int64_t> m_since;
+};
+
+/**
+ * \return Process wide flush policy.
+ */
+inline FlushPolicy& flush_policy() noexcept {
+    static FlushPolicy p;
+    return p;
+}
+
+/**
+ * \brief Thread flushing the sink when gl::set_flush_interval() has passed
+ * since output that isn't flushed.
+ */
+class FlushTimer {
+  public:
+    /**
+     * \brief Constructor.
+     */
+    FlushTimer() :
+        m_thread(), m_mutex(), m_cv(), m_running(false), m_woken(false) {
+    }
+
+    FlushTimer(const FlushTimer&) = delete;
+    FlushTimer& operator=(const FlushTimer&) = delete;
+
+    /**
+     * \brief Destructor. Stop thread.
+     */
+    ~FlushTimer() {
+        stop();
+    }
+
+    /**
+     * \brief Start thread, if not already running.
+     */
+    void start() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_running) {
+            m_running = true;
+            m_thread  = std::thread(&FlushTimer::run, this);
+        }
+    }
+
+    /**
+     * \brief Stop thread, if running.
+     */
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_running) {
+                return;
+            }
+            m_running = false;
+            m_cv.notify_one();
+        }
+        m_thread.join();
+    }
+
+    /**
+     * \brief Wake thread, since output started waiting for the interval.
+     */
+    void wake() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_woken = true;
+        m_cv.notify_one();
+    }
+
+    /**
+     * \return Mutex held while the thread flushes. Hold it while replacing
+     * the sink.
+     */
+    std::mutex& get_mutex() noexcept {
+        return m_mutex;
+    }
+
+  private:
+    /**
+     * \brief Thread. Flush whenever the interval has passed.
+     */
+    void run();
+
+    std::thread             m_thread;  /**< Thread. */
+    std::mutex              m_mutex;   /**< Protects members and the sink. */
+    std::condition_variable m_cv;      /**< Wakes thread. */
+    bool                    m_running; /**< \c true until stopped. */
+    bool                    m_woken;   /**< \c true if woken by wake(). */
+};
+
+/**
+ * \return Process wide flush timer. Constructed after the sink holder, so
+ * that it's stopped before the sink is destroyed.
+ */
+inline FlushTimer& flush_timer() {
+    sink_holder();
+    static FlushTimer t;
+    return t;
+}
+
+inline void FlushTimer::run() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (m_running) {
+        FlushPolicy&  p    = flush_policy();
+        const int64_t left = p.time_left();
+        if (left <= 0) {
+            p.flush(sink_holder().sink());
+        } else if (left == std::numeric_limits<int64_t>::max()) {
+            m_cv.wait(lock, [this] { return m_woken || !m_running; });
+        } else {
+            m_cv.wait_for(lock, std::chrono::nanoseconds(left),
+                [this] { return m_woken || !m_running; });
+        }
+        m_woken = false;
+    }
+}
+
+/**
+ * \brief Flush sink after output was written to it, if the flush policy or
+ * the output asks for it.
+ *
+ * \param s     Sink.
+ * \param len   Number of characters written.
+ * \param flush \c true if the output asked for a flush, e.g. by std::endl.
+ */
+inline void after_write(Sink& s, size_t len, bool flush) {
+    FlushPolicy& p = flush_policy();
+    if (!p.is_batched()) {
+        if (flush) {
+            s.flush();
+        }
+    } else if (p.add(len) || flush) {
+        p.flush(s);
+    } else if (p.arm()) {
+        flush_timer().wake();
+    }
+}
+
+/**
+ * \brief Sink added by gl::add_sink(), written by a thread of its own.
+ *
+ */
+struct AddedSink {
+    /**
+     * \brief Constructor.
+     *
+     * \param s     Sink.
+     * \param p     Prefixes.
+     * \param color \c true if output is colored.
+     */
+    AddedSink(std::shared_ptr<Sink> s, prefix p, bool color) :
+        sink(std::move(s)), writer(sink.get(), p, color) {
+    }
+
+    std::shared_ptr<Sink> sink;   /**< Sink. */
+    AsyncWriter           writer; /**< Writer thread of \p sink. */
+};
+
+/**
+ * \return Sinks added by gl::add_sink().
+ */
+inline std::vector<std::unique_ptr<AddedSink>>& added_sinks() {
+    static std::vector<std::unique_ptr<AddedSink>> s;
+    return s;
+}
+
+/**
+ * \brief Write batch of messages, and flush unless flushing is batched by
+ * the flush policy. Sinks added by gl::add_sink() are flushed after each
+ * batch.
+ *
+ * \param batch Messages.
+ * \param flush \c true if a message asked for a flush.
+ */
+inline void AsyncWriter::write(const std::string& batch, bool flush) {
+    if (m_target != nullptr) {
+        m_target->write(batch.data(), batch.size());
+        m_target->flush();
+        return;
+    }
+
+    Sink& s = sink_holder().sink();
+    s.write(batch.data(), batch.size());
+    after_write(s, batch.size(), flush || !flush_policy().is_batched());
+}
+
+/**
+ * \brief Enqueue logging message to the writers of sinks added by
+ * gl::add_sink(). Text following the prefix is enqueued if captured, so that
+ * each writer adds its own prefix, otherwise the whole message.
+ *
+ * \param buf Message.
+ */
+inline void fan_out(const LineBuffer& buf) {
+    const Capture& c    = buf.capture();
+    const bool     text = c.site != nullptr && c.end != std::string::npos;
+    for (auto& a : added_sinks()) {
+        if (text) {
+            a->writer.push(buf.data() + c.begin, c.end - c.begin,
+                buf.is_flush_requested(), nullptr, &c, buf.is_kept());
+        } else {
+            a->writer.push(buf.data(), buf.size(), buf.is_flush_requested(),
+                nullptr, nullptr, buf.is_kept());
+        }
+    }
+}
+
+/**
+ * \brief Submit logging message to asynchronous writer if running, otherwise
+ * write it directly to the sink with a single write.
+ *
+ * \param buf Message.
+ */
+inline void submit(const LineBuffer& buf) {
+    if (buf.size() == 0) {
+        return;
+    }
+    if (GL_UNLIKELY(is_stats_enabled())) {
+        ThreadStats::add(thread_stats().bytes, buf.size());
+    }
+    if (GL_UNLIKELY(is_fanout())) {
+        fan_out(buf);
+    }
+    AsyncWriter& w = async_writer();
+    if (w.is_running() &&
+        w.push(buf.data(), buf.size(), buf.is_flush_requested(), nullptr,
+            nullptr, buf.is_kept())) {
+        return;
+    }
+
+    Sink& s = sink_holder().sink();
+    s.write(buf.data(), buf.size());
+    after_write(s, buf.size(), buf.is_flush_requested());
+}
+
+/**
+ * \brief Write all queued asynchronous messages, and flush the sink.
+ */
+inline void flush_all() {
+    for (auto& a : added_sinks()) {
+        a->writer.drain();
+        a->sink->flush();
+    }
+    async_writer().drain();
+    std::lock_guard<std::mutex> lock(flush_timer().get_mutex());
+    flush_policy().flush(sink_holder().sink());
+}
+
+/**
+ * \brief Signal handlers installed by gl::set_crash_flush_enabled().
+ */
+struct CrashHandlers {
+    /** Signal handler. */
+    using Handler = void (*)(int);
+
+    /** Number of signals. */
+#ifdef SIGBUS
+    static constexpr size_t count = 5;
+#else
+    static constexpr size_t count = 4;
+#endif // SIGBUS
+
+    /**
+     * \return Signals [count].
+     */
+    static const int* signals() noexcept {
+        static const int s[] = {SIGABRT, SIGSEGV, SIGFPE, SIGILL,
+#ifdef SIGBUS
+            SIGBUS
+#endif // SIGBUS
+        };
+        return s;
+    }
+
+    /**
+     * \brief Constructor.
+     */
+    CrashHandlers() : mutex(), installed(false), previous(), crashed(false) {
+    }
+
+    std::mutex        mutex;           /**< Protects installed. */
+    bool              installed;       /**< \c true if installed. */
+    Handler           previous[count]; /**< Handlers before installing. */
+    std::atomic<bool> crashed;         /**< \c true once a handler ran. */
+};
+
+/**
+ * \return Process wide crash handlers.
+ */
+inline CrashHandlers& crash_handlers() {
+    static CrashHandlers h;
+    return h;
+}
+
+/**
+ * \brief Flush sink once, then let the previous handler handle the signal.
+ *
+ * \param sig Signal.
+ */
+inline void crash_handler(int sig) {
+    CrashHandlers& h = crash_handlers();
+    if (!h.crashed.exchange(true)) {
+        sink_holder().sink().flush();
+        for (auto& a : added_sinks()) {
+            a->sink->flush();
+        }
+    }
+    for (size_t i = 0; i < CrashHandlers::count; ++i) {
+        if (CrashHandlers::signals()[i] == sig) {
+            std::signal(sig, h.previous[i]);
+        }
+    }
+    std::raise(sig);
+}
+
+/**
+ * \brief Flush at exit. Registered with std::atexit().
+ */
+inline void flush_at_exit() {
+    flush_all();
+}
+
+/**
+ * \brief Register flush_at_exit(), once.
+ */
+inline void register_flush_at_exit() {
+    // Construct objects used by flush_all() first, so that they are
+    // destroyed after it has run
+    static const bool registered =
+        (async_writer(), flush_timer(), added_sinks(),
+            std::atexit(&flush_at_exit) == 0);
+    static_cast<void>(registered);
+}
+
+/**
+ * \brief Recompute level gate from user level, output enabled setting,
+ * current sink and sinks added by gl::add_sink().
+ */
+inline void update_level_gate() noexcept {
+    // Serialize writers, so that the gate matches the latest settings
+    static std::mutex           m;
+    std::lock_guard<std::mutex> lock(m);
+    Config&                     c = config();
+    bool                        e =
+        c.userOutputEnabled.load(std::memory_order_relaxed) &&
+        (!sink_holder().sink().is_null() || is_fanout());
+    c.outputEnabled.store(e, std::memory_order_relaxed);
+    c.levelGate.store(
+        e ? c.userLevel.load(std::memory_order_relaxed) : GL_LEVEL_OFF + 1,
+        std::memory_order_relaxed);
+}
+
+
+/**
+ * \return Binary output session. Call sites are announced once per session,
+ * and a new session starts when format or sink changes. Shared by all
+ * translation units.
+ */
+inline std::atomic<uint32_t>& binary_session() noexcept {
+    static std::atomic<uint32_t> s(1);
+    return s;
+}
+
+/**
+ * \return \c true if logging output is formatted text, and formatted when
+ * logging.
+ */
+inline bool is_plain_text() noexcept {
+    return config().plainText.load(std::memory_order_relaxed);
+}
+
+/**
+ * \brief Recompute plain text setting from format and deferred setting.
+ */
+inline void update_plain_text() noexcept {
+    static std::mutex           m;
+    std::lock_guard<std::mutex> lock(m);
+    Config&                     c = config();
+    c.plainText.store(c.format.load() == static_cast<uint32_t>(format::TEXT) &&
+                      !c.deferred.load());
+}
+
+/**
+ * \return \c true if logging output is binary.
+ */
+inline bool is_binary() noexcept {
+    return config().format.load(std::memory_order_relaxed) ==
+           static_cast<uint32_t>(format::BINARY);
+}
+
+/**
+ * \brief Kind of record in binary output.
+ */
+enum class BinaryRecord : char {
+    SITE   = 'S', /**< Call site, written before first use in a session. */
+    VALUES = 'V', /**< Arguments of l(). */
+    TEXT   = 'T'  /**< Preformatted text, e.g. of l_arr(). */
+};
+
+/**
+ * \brief Type of an argument in binary output.
+ */
+enum class BinaryType : uint8_t {
+    TEXT,          /**< Preformatted text. */
+    STRING,        /**< Unformatted string. */
+    BOOL,          /**< bool. */
+    CHAR,          /**< char. */
+    SIGNED_CHAR,   /**< signed char. */
+    UNSIGNED_CHAR, /**< unsigned char. */
+    CHAR16,        /**< char16_t. */
+    CHAR32,        /**< char32_t. */
+    WCHAR,         /**< wchar_t. */
+    INT16,         /**< 16 bit signed integer. */
+    UINT16,        /**< 16 bit unsigned integer. */
+    INT32,         /**< 32 bit signed integer. */
+    UINT32,        /**< 32 bit unsigned integer. */
+    INT64,         /**< 64 bit signed integer. */
+    UINT64,        /**< 64 bit unsigned integer. */
+    FLOAT,         /**< float. */
+    DOUBLE,        /**< double. */
+    LONG_DOUBLE    /**< long double. */
+};
+
+/**
+ * \brief Binary type of an integer of a size. Other sizes are
+ * preformatted.
+ *
+ * \tparam N Size in bytes.
+ * \tparam S \c true if signed.
+ */
+template<size_t N, bool S>
+struct BinaryInteger
+    : std::integral_constant<BinaryType, BinaryType::TEXT> {};
+template<>
+struct BinaryInteger<2, true>
+    : std::integral_constant<BinaryType, BinaryType::INT16> {};
+template<>
+struct BinaryInteger<2, false>
+    : std::integral_constant<BinaryType, BinaryType::UINT16> {};
+template<>
+struct BinaryInteger<4, true>
+    : std::integral_constant<BinaryType, BinaryType::INT32> {};
+template<>
+struct BinaryInteger<4, false>
+    : std::integral_constant<BinaryType, BinaryType::UINT32> {};
+template<>
+struct BinaryInteger<8, true>
+    : std::integral_constant<BinaryType, BinaryType::INT64> {};
+template<>
+struct BinaryInteger<8, false>
+    : std::integral_constant<BinaryType, BinaryType::UINT64> {};
+
+/**
+ * \brief Binary type of a variable type. Types that aren't listed are
+ * preformatted as text.
+ *
+ * \tparam T Variable type, without const and volatile.
+ */
+template<class T, class Enable = void>
+struct BinaryTraits : std::integral_constant<BinaryType, BinaryType::TEXT> {
+};
+template<class T>
+struct BinaryTraits<T,
+    typename std::enable_if<std::is_integral<T>::value>::type>
+    : BinaryInteger<sizeof(T), std::is_signed<T>::value> {};
+template<>
+struct BinaryTraits<bool>
+    : std::integral_constant<BinaryType, BinaryType::BOOL> {};
+template<>
+struct BinaryTraits<char>
+    : std::integral_constant<BinaryType, BinaryType::CHAR> {};
+template<>
+struct BinaryTraits<signed char>
+    : std::integral_constant<BinaryType, BinaryType::SIGNED_CHAR> {};
+template<>
+struct BinaryTraits<unsigned char>
+    : std::integral_constant<BinaryType, BinaryType::UNSIGNED_CHAR> {};
+template<>
+struct BinaryTraits<char16_t>
+    : std::integral_constant<BinaryType, BinaryType::CHAR16> {};
+template<>
+struct BinaryTraits<char32_t>
+    : std::integral_constant<BinaryType, BinaryType::CHAR32> {};
+template<>
+struct BinaryTraits<wchar_t>
+    : std::integral_constant<BinaryType, BinaryType::WCHAR> {};
+template<>
+struct BinaryTraits<float>
+    : std::integral_constant<BinaryType, BinaryType::FLOAT> {};
+template<>
+struct BinaryTraits<double>
+    : std::integral_constant<BinaryType, BinaryType::DOUBLE> {};
+template<>
+struct BinaryTraits<long double>
+    : std::integral_constant<BinaryType, BinaryType::LONG_DOUBLE> {};
+template<>
+struct BinaryTraits<char*>
+    : std::integral_constant<BinaryType, BinaryType::STRING> {};
+template<>
+struct BinaryTraits<const char*>
+    : std::integral_constant<BinaryType, BinaryType::STRING> {};
+template<>
+struct BinaryTraits<std::string>
+    : std::integral_constant<BinaryType, BinaryType::STRING> {};
+
+/**
+ * \brief Write bytes of value in native byte order.
+ *
+ * \param os Output stream.
+ * \param v  Value.
+ */
+template<class T>
+void write_raw(std::ostream& os, const T& v) {
+    os.write(reinterpret_cast<const char*>(&v), sizeof(v));
+}
+
+/**
+ * \brief Write length prefixed string.
+ *
+ * \param os Output stream.
+ * \param s  Characters [\p n].
+ * \param n  Number of characters.
+ */
+inline void write_string(std::ostream& os, const char* s, size_t n) {
+    write_raw(os, static_cast<uint32_t>(n));
+    os.write(s, static_cast<std::streamsize>(n));
+}
+
+/**
+ * \brief Write length prefixed string.
+ *
+ * \param os Output stream.
+ * \param s  String. \c nullptr is written as an empty string.
+ */
+inline void write_string(std::ostream& os, const char* s) {
+    write_string(os, s, s == nullptr ? 0 : std::strlen(s));
+}
+
+/**
+ * \brief Write length prefixed string.
+ *
+ * \param os Output stream.
+ * \param s  String.
+ */
+inline void write_string(std::ostream& os, const std::string& s) {
+    write_string(os, s.data(), s.size());
+}
+
+/**
+ * \brief Start text of unknown length. Finish with end_text().
+ *
+ * \param os  Output stream writing to \p buf.
+ * \param buf Message.
+ * \return Position of length.
+ */
+inline size_t begin_text(std::ostream& os, const LineBuffer& buf) {
+    size_t pos = buf.size();
+    write_raw(os, static_cast<uint32_t>(0));
+    return pos;
+}
+
+/**
+ * \brief Finish text started with begin_text().
+ *
+ * \param buf Message.
+ * \param pos Position of length.
+ */
+inline void end_text(LineBuffer& buf, size_t pos) noexcept {
+    auto len = static_cast<uint32_t>(buf.size() - pos - sizeof(uint32_t));
+    buf.replace(pos, reinterpret_cast<const char*>(&len), sizeof(len));
+}
+
+/**
+ * \brief Write argument as raw bytes.
+ *
+ * \param os Output stream.
+ * \param v  Value.
+ */
+template<class T, BinaryType B>
+void write_binary_value(std::ostream& os, LineBuffer& /*buf*/, T& v,
+    std::integral_constant<BinaryType, B> /*type*/) {
+    os.put(static_cast<char>(B));
+    write_raw(os, v);
+}
+
+/**
+ * \brief Write string argument.
+ *
+ * \param os Output stream.
+ * \param v  Value.
+ */
+template<class T>
+void write_binary_value(std::ostream& os, LineBuffer& /*buf*/, T& v,
+    std::integral_constant<BinaryType, BinaryType::STRING> /*type*/) {
+    os.put(static_cast<char>(BinaryType::STRING));
+    write_string(os, v);
+}
+
+/**
+ * \brief Write argument formatted as text.
+ *
+ * \param os  Output stream writing to \p buf.
+ * \param buf Message.
+ * \param v   Value.
+ */
+template<class T>
+void write_binary_value(std::ostream& os, LineBuffer& buf, T& v,
+    std::integral_constant<BinaryType, BinaryType::TEXT> /*type*/) {
+    os.put(static_cast<char>(BinaryType::TEXT));
+    size_t pos = begin_text(os, buf);
+    os << format_value(v);
+    end_text(buf, pos);
+}
+
+/**
+ * \brief Write call site record.
+ *
+ * \param os    Output stream.
+ * \param site  Call site.
+ * \param types Type names of arguments [\p n].
+ * \param n     Number of arguments.
+ */
+inline void write_binary_site(std::ostream& os, const Site& site,
+    const std::string* const* types, size_t n) {
+    std::vector<std::string> names = split_arguments(site.get_arguments());
+    names.resize(n);
+
+    os.put(static_cast<char>(BinaryRecord::SITE));
+    write_raw(os, site.get_id());
+    write_raw(os, static_cast<int64_t>(site.get_file_line_number()));
+    write_string(os, site.get_file_path());
+    write_string(os, site.get_function_name());
+    write_raw(os, static_cast<uint32_t>(n));
+    for (size_t i = 0; i < n; ++i) {
+        write_string(os, names[i]);
+        write_string(os, *types[i]);
+    }
+}
+
 /**
- * \brief Hide this section from doxygen */
-#ifndef DOXYGEN_HIDDEN
+ * \brief Write start of message record: call site id, time and thread id.
+ *
+ * \param os   Output stream.
+ * \param r    Kind of record.
+ * \param site Call site.
+ */
+inline void write_binary_header(
+    std::ostream& os, BinaryRecord r, const Site& site) {
+    auto fmt = static_cast<time_format>(
+        config().timeFormat.load(std::memory_order_relaxed));
+    os.put(static_cast<char>(r));
+    write_raw(os, site.get_id());
+    os.put(static_cast<char>(fmt));
+    write_raw(os, current_time(fmt));
+    write_string(os, thread_id_text());
+}
+
+/**
+ * \brief Log variables as a binary record. Nothing but the variables that
+ * the binary format can't represent is formatted.
+ *
+ * The call site is announced in the first record of each session. That
+ * record is never dropped by overflow::DROP_NEWEST or overflow::DROP_OLDEST.
+ *
+ * \tparam T    Variable types. References if lvalues.
+ * \param site  Call site.
+ * \param v     Variables.
+ */
+template<class... T>
+void write_binary(const Site& site, T&&... v) {
+    uint32_t session  = binary_session().load(std::memory_order_relaxed);
+    bool     announce = site.get_session() != session;
+    {
+        Line          line;
+        std::ostream& os = line.stream();
+        if (announce) {
+            const std::string* types[] = {&cached_type_name<
+                typename std::remove_reference<T>::type>()...};
+            write_binary_site(os, site, types, sizeof...(T));
+            // Later records of the site can't be decoded without it
+            line.buffer().keep();
+        }
+        write_binary_header(os, BinaryRecord::VALUES, site);
+        int expand[] = {(write_binary_value(os, line.buffer(), v,
+                             BinaryTraits<typename std::remove_cv<
+                                 typename std::remove_reference<T>::type>::
+                                     type>()),
+            0)...};
+        static_cast<void>(expand);
+    }
+    // Announce again until a record carrying the site has been submitted
+    if (announce) {
+        site.set_session(session);
+    }
+}
+
+/**
+ * \brief Log array or matrix as a binary record of preformatted text.
+ *
+ * \param site Call site.
+ * \param type Type name.
+ * \param c    Array or Matrix.
+ */
+template<class C>
+void write_binary_body(const Site& site, const std::string& type, const C& c) {
+    uint32_t session  = binary_session().load(std::memory_order_relaxed);
+    bool     announce = site.get_session() != session;
+    {
+        Line          line;
+        std::ostream& os = line.stream();
+        if (announce) {
+            const std::string* types[] = {&type};
+            write_binary_site(os, site, types, 1);
+            line.buffer().keep();
+        }
+        write_binary_header(os, BinaryRecord::TEXT, site);
+        size_t pos = begin_text(os, line.buffer());
+        write_values(os, c);
+        end_text(line.buffer(), pos);
+    }
+    if (announce) {
+        site.set_session(session);
+    }
+}
+
+/**
+ * \brief Log array as a binary record.
+ *
+ * \tparam U Value type.
+ * \param site Call site.
+ * \param a    Array.
+ */
+template<class U>
+void write_binary_text(const Site& site, const Array<U>& a) {
+    write_binary_body(site, cached_type_name<U>(), a);
+}
+
+/**
+ * \brief Log matrix as a binary record.
+ *
+ * \tparam U Value type.
+ * \param site Call site.
+ * \param m    Matrix.
+ */
+template<class U>
+void write_binary_text(const Site& site, const Matrix<U>& m) {
+    write_binary_body(
+        site, cached_type_name<typename ShownType<U>::type>(), m);
+}
+
+/**
+ * \brief Log bytes as a binary record.
+ *
+ * \param site Call site.
+ * \param c    Bytes.
+ */
+inline void write_binary_text(const Site& site, const Bytes& c) {
+    write_binary_body(site, cached_type_name<unsigned char>(), c);
+}
+
+/**
+ * \brief How a variable is written in format::JSON and format::CSV.
+ */
+enum class FieldType : uint8_t {
+    RAW,      /**< Formatted value is a JSON literal, e.g. 1 or true. */
+    FLOATING, /**< Like RAW, unless infinite or NaN. */
+    STRING,   /**< Formatted value is a string in double quotes. */
+    TEXT      /**< Other formatted value. Written as a string. */
+};
+
+/**
+ * \brief Field type of a variable type. Types that aren't listed are TEXT.
+ *
+ * \tparam T Variable type, without const and volatile.
+ */
+template<class T, class Enable = void>
+struct FieldTraits : std::integral_constant<FieldType, FieldType::TEXT> {};
+template<class T>
+struct FieldTraits<T,
+    typename std::enable_if<std::is_integral<T>::value>::type>
+    : std::integral_constant<FieldType, FieldType::RAW> {};
+template<class T>
+struct FieldTraits<T,
+    typename std::enable_if<std::is_floating_point<T>::value>::type>
+    : std::integral_constant<FieldType, FieldType::FLOATING> {};
+template<>
+struct FieldTraits<char>
+    : std::integral_constant<FieldType, FieldType::TEXT> {};
+template<>
+struct FieldTraits<signed char>
+    : std::integral_constant<FieldType, FieldType::TEXT> {};
+template<>
+struct FieldTraits<unsigned char>
+    : std::integral_constant<FieldType, FieldType::TEXT> {};
+template<>
+struct FieldTraits<char16_t>
+    : std::integral_constant<FieldType, FieldType::TEXT> {};
+template<>
+struct FieldTraits<char32_t>
+    : std::integral_constant<FieldType, FieldType::TEXT> {};
+template<>
+struct FieldTraits<wchar_t>
+    : std::integral_constant<FieldType, FieldType::TEXT> {};
+template<>
+struct FieldTraits<char*>
+    : std::integral_constant<FieldType, FieldType::STRING> {};
+template<>
+struct FieldTraits<const char*>
+    : std::integral_constant<FieldType, FieldType::STRING> {};
+template<>
+struct FieldTraits<std::string>
+    : std::integral_constant<FieldType, FieldType::STRING> {};
+template<size_t N>
+struct FieldTraits<char[N]>
+    : std::integral_constant<FieldType, FieldType::STRING> {};
+
+/**
+ * \brief Escape end of text for use in a JSON string.
+ *
+ * \param text Text.
+ * \param pos  Position of first character to escape.
+ */
+inline void escape_json(std::string& text, size_t pos) {
+    size_t i = pos;
+    while (i < text.size() && text[i] != '"' && text[i] != '\\' &&
+           static_cast<unsigned char>(text[i]) >= 0x20) {
+        ++i;
+    }
+    if (i == text.size()) {
+        return;
+    }
+
+    // Rare, so allocating is fine
+    static const char hex[] = "0123456789abcdef";
+    std::string       esc;
+    for (size_t j = i; j < text.size(); ++j) {
+        const char c = text[j];
+        switch (c) {
+        case '"':
+            esc += "\\\"";
+            break;
+        case '\\':
+            esc += "\\\\";
+            break;
+        case '\n':
+            esc += "\\n";
+            break;
+        case '\r':
+            esc += "\\r";
+            break;
+        case '\t':
+            esc += "\\t";
+            break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                esc += "\\u00";
+                esc += hex[(c >> 4) & 0xF];
+                esc += hex[c & 0xF];
+            } else {
+                esc += c;
+            }
+            break;
+        }
+    }
+    text.replace(i, std::string::npos, esc);
+}
+
+/**
+ * \brief Quote end of text as a CSV field, if needed.
+ *
+ * \param text Text.
+ * \param pos  Position of field.
+ */
+inline void quote_csv(std::string& text, size_t pos) {
+    if (text.find_first_of(",\"\r\n", pos) == std::string::npos) {
+        return;
+    }
+    std::string q(1, '"');
+    for (size_t j = pos; j < text.size(); ++j) {
+        if (text[j] == '"') {
+            q += '"';
+        }
+        q += text[j];
+    }
+    q += '"';
+    text.replace(pos, std::string::npos, q);
+}
+
+/**
+ * \brief Turn formatted text at end of message into a string field.
+ *
+ * \param text Message text.
+ * \param pos  Position of text. In format::JSON, preceded by '"'.
+ * \param json \c true if format::JSON, otherwise format::CSV.
+ */
+inline void end_text_field(std::string& text, size_t pos, bool json) {
+    if (json) {
+        escape_json(text, pos);
+        text += '"';
+    } else {
+        quote_csv(text, pos);
+    }
+}
+
+/**
+ * \brief Start a field.
+ *
+ * \param os   Output stream writing to \p text.
+ * \param text Message text.
+ * \param json \c true if format::JSON, otherwise format::CSV.
+ * \param sep  \c true if preceded by another field.
+ * \param name Name in format::JSON. Not null terminated.
+ * \param n    Length of \p name.
+ */
+inline void begin_field(std::ostream& os, bool json, bool sep,
+    const char* name, size_t n) {
+    if (sep) {
+        os.put(',');
+    }
+    if (json) {
+        os.put('"');
+        os.write(name, static_cast<std::streamsize>(n));
+        os.write("\":", 2);
+    }
+}
+
+/**
+ * \brief Write start of record: "{" and prefixes in format::JSON, and
+ * prefixes in format::CSV.
+ *
+ * \param os   Output stream writing to \p text.
+ * \param text Message text.
+ * \param site Call site.
+ * \param json \c true if format::JSON, otherwise format::CSV.
+ * \return \c true if any prefix was written.
+ */
+inline bool write_record_start(
+    std::ostream& os, std::string& text, const Site& site, bool json) {
+    const prefix p   = current_prefixes();
+    bool         sep = false;
+    if (json) {
+        os.put('{');
+    }
+    if ((p & prefix::FILE) != prefix::NONE) {
+        begin_field(os, json, sep, "file", 4);
+        if (json) {
+            os.put('"');
+        }
+        size_t pos = text.size();
+        os << site.get_file_name();
+        end_text_field(text, pos, json);
+        sep = true;
+    }
+    if ((p & prefix::LINE) != prefix::NONE) {
+        begin_field(os, json, sep, "line", 4);
+        os << site.get_file_line_number();
+        sep = true;
+    }
+    if ((p & prefix::FUNCTION) != prefix::NONE) {
+        begin_field(os, json, sep, "function", 8);
+        if (json) {
+            os.put('"');
+        }
+        size_t pos = text.size();
+        os << site.get_function_name();
+        end_text_field(text, pos, json);
+        sep = true;
+    }
+    if ((p & prefix::TIME) != prefix::NONE) {
+        auto fmt = static_cast<time_format>(
+            config().timeFormat.load(std::memory_order_relaxed));
+        char   buf[32];
+        size_t len = render_time(buf, fmt, current_time(fmt));
+        begin_field(os, json, sep, "time", 4);
+        if (json) {
+            os.put('"');
+        }
+        os.write(buf, static_cast<std::streamsize>(len));
+        if (json) {
+            os.put('"');
+        }
+        sep = true;
+    }
+    if ((p & prefix::THREAD) != prefix::NONE) {
+        const std::string& tid = thread_id_text();
+        begin_field(os, json, sep, "thread", 6);
+        if (json) {
+            os.put('"');
+        }
+        os.write(tid.data(), static_cast<std::streamsize>(tid.size()));
+        if (json) {
+            os.put('"');
+        }
+        sep = true;
+    }
+    if (json) {
+        begin_field(os, json, sep, "values", 6);
+        os.put('{');
+    }
+    return sep && !json;
+}
+
+/**
+ * \brief Write end of record: number of suppressed messages and "}" in
+ * format::JSON, and newline.
+ *
+ * \param os         Output stream.
+ * \param json       \c true if format::JSON, otherwise format::CSV.
+ * \param suppressed Number of suppressed messages before this one.
+ */
+inline void write_record_end(std::ostream& os, bool json, uint64_t suppressed) {
+    if (json) {
+        os.put('}');
+        if (suppressed != 0 &&
+            config().suppressedSummary.load(std::memory_order_relaxed)) {
+            os << ",\"suppressed\":" << suppressed;
+        }
+        os.put('}');
+    }
+    os << GL_NEWLINE;
+}
+
+/**
+ * \brief Write name of variable as key in format::JSON, or field in
+ * format::CSV.
+ *
+ * \param os   Output stream writing to \p text.
+ * \param text Message text.
+ * \param json \c true if format::JSON, otherwise format::CSV.
+ * \param sep  \c true if preceded by another field.
+ * \param plan Plan of call site, without type names.
+ * \param k    Index of variable.
+ */
+inline void write_field_name(std::ostream& os, std::string& text, bool json,
+    bool sep, const FormatPlan& plan, size_t k) {
+    if (sep) {
+        os.put(',');
+    }
+    if (json) {
+        os.put('"');
+    }
+    size_t pos = text.size();
+    plan.write_name(os, k);
+    end_text_field(text, pos, json);
+    os.put(json ? ':' : ',');
+}
+
+/**
+ * \brief Write value that is formatted as a literal.
+ *
+ * \param os Output stream.
+ * \param v  Value.
+ */
+template<class T>
+void write_field_value(std::ostream& os, std::string& /*text*/,
+    bool /*json*/, T& v,
+    std::integral_constant<FieldType, FieldType::RAW> /*type*/) {
+    os << format_value(v);
+}
+
+/**
+ * \brief Write value formatted as text, in a JSON string or CSV field.
+ *
+ * \param os   Output stream writing to \p text.
+ * \param text Message text.
+ * \param json \c true if format::JSON, otherwise format::CSV.
+ * \param v    Value.
+ */
+template<class T>
+void write_field_value(std::ostream& os, std::string& text, bool json, T& v,
+    std::integral_constant<FieldType, FieldType::TEXT> /*type*/) {
+    if (json) {
+        os.put('"');
+    }
+    size_t pos = text.size();
+    os << format_value(v);
+    end_text_field(text, pos, json);
+}
+
+/**
+ * \brief Write floating point value. Infinity and NaN are written as text,
+ * since JSON has no literals for them.
+ *
+ * \param os   Output stream writing to \p text.
+ * \param text Message text.
+ * \param json \c true if format::JSON, otherwise format::CSV.
+ * \param v    Value.
+ */
+template<class T>
+void write_field_value(std::ostream& os, std::string& text, bool json, T& v,
+    std::integral_constant<FieldType, FieldType::FLOATING> /*type*/) {
+    if (std::isfinite(v)) {
+        os << format_value(v);
+    } else {
+        write_field_value(os, text, json, v,
+            std::integral_constant<FieldType, FieldType::TEXT>());
+    }
+}
+
+/**
+ * \brief Write string value, without the double quotes of format::TEXT.
+ *
+ * \param os   Output stream writing to \p text.
+ * \param text Message text.
+ * \param json \c true if format::JSON, otherwise format::CSV.
+ * \param v    Value.
+ */
+template<class T>
+void write_field_value(std::ostream& os, std::string& text, bool json, T& v,
+    std::integral_constant<FieldType, FieldType::STRING> /*type*/) {
+    size_t pos = text.size() + 1;
+    os << format_value(v);
+    text.pop_back();
+    if (!json) {
+        text.erase(pos - 1, 1);
+        --pos;
+    }
+    end_text_field(text, pos, json);
+}
+
+/**
+ * \brief Write C string value. \c nullptr is written as an empty string.
+ *
+ * \param os   Output stream writing to \p text.
+ * \param text Message text.
+ * \param json \c true if format::JSON, otherwise format::CSV.
+ * \param v    C string.
+ * \param type String field type.
+ */
+inline void write_field_value(std::ostream& os, std::string& text, bool json,
+    const char* v, std::integral_constant<FieldType, FieldType::STRING> type) {
+    if (v == nullptr) {
+        if (json) {
+            os << "\"\"";
+        }
+        return;
+    }
+    write_field_value<const char*>(os, text, json, v, type);
+}
+
+/**
+ * \brief Write C string value. \c nullptr is written as an empty string.
+ *
+ * \param os   Output stream writing to \p text.
+ * \param text Message text.
+ * \param json \c true if format::JSON, otherwise format::CSV.
+ * \param v    C string.
+ * \param type String field type.
+ */
+inline void write_field_value(std::ostream& os, std::string& text, bool json,
+    char* v, std::integral_constant<FieldType, FieldType::STRING> type) {
+    write_field_value(os, text, json, static_cast<const char*>(v), type);
+}
+
+/**
+ * \brief Write character array, like the pointer to its first character.
+ *
+ * \param os   Output stream writing to \p text.
+ * \param text Message text.
+ * \param json \c true if format::JSON, otherwise format::CSV.
+ * \param v    Character array.
+ * \param type String field type.
+ */
+template<class C, size_t N>
+void write_field_value(std::ostream& os, std::string& text, bool json,
+    C (&v)[N], std::integral_constant<FieldType, FieldType::STRING> type) {
+    const char* p = v;
+    write_field_value(os, text, json, p, type);
+}
+
+/**
+ * \brief Write variable as a field.
+ *
+ * \param os   Output stream writing to \p text.
+ * \param text Message text.
+ * \param json \c true if format::JSON, otherwise format::CSV.
+ * \param sep  \c true if preceded by another field.
+ * \param plan Plan of call site, without type names.
+ * \param k    Index of variable. Incremented.
+ * \param v    Variable.
+ */
+template<class T>
+void write_field(std::ostream& os, std::string& text, bool json, bool sep,
+    const FormatPlan& plan, size_t& k, T& v) {
+    write_field_name(os, text, json, sep || k != 0, plan, k);
+    write_field_value(os, text, json, v,
+        FieldTraits<typename std::remove_cv<T>::type>());
+    ++k;
+}
+
+/**
+ * \brief Log variables as one JSON object or CSV row.
+ *
+ * \tparam T         Variable types. References if lvalues.
+ * \param site       Call site.
+ * \param suppressed Number of suppressed messages before this one.
+ * \param v          Variables.
+ */
+template<class... T>
+void write_structured(const Site& site, uint64_t suppressed, T&&... v) {
+    const bool json = config().format.load(std::memory_order_relaxed) ==
+                      static_cast<uint32_t>(format::JSON);
+    Line               line;
+    std::ostream&      os   = line.stream();
+    std::string&       text = line.buffer().text();
+    const bool         sep  = write_record_start(os, text, site, json);
+    const FormatPlan&  plan = site.get_plan(false, &make_plan<T...>);
+    size_t             k    = 0;
+    int expand[] = {(write_field(os, text, json, sep, plan, k, v), 0)...};
+    static_cast<void>(expand);
+    write_record_end(os, json, suppressed);
+}
+
+/**
+ * \return Length of the name and separator that write_values() starts
+ * output of an Array with.
+ *
+ * \param a Array.
+ */
+template<class U>
+size_t name_length(const Array<U>& a) noexcept {
+    return std::strlen(a.get_name()) + 3;
+}
+
+/**
+ * \return Length of the name and separator that write_values() starts
+ * output of a Matrix with.
+ *
+ * \param m Matrix.
+ */
+template<class U>
+size_t name_length(const Matrix<U>& m) noexcept {
+    return std::strlen(m.get_name()) + 2;
+}
+
+/**
+ * \return Length of the name and separator that write_values() starts
+ * output of Bytes with.
+ *
+ * \param c Bytes.
+ */
+inline size_t name_length(const Bytes& c) noexcept {
+    return std::strlen(c.get_name()) + 3;
+}
+
+/**
+ * \brief Log array, matrix or bytes as one JSON object or CSV row, with its
+ * values as text.
+ *
+ * \param site Call site.
+ * \param c    Array, Matrix or Bytes.
+ */
+template<class C>
+void write_structured_text(const Site& site, const C& c) {
+    const bool json = config().format.load(std::memory_order_relaxed) ==
+                      static_cast<uint32_t>(format::JSON);
+    Line          line;
+    std::ostream& os   = line.stream();
+    std::string&  text = line.buffer().text();
+    const bool    sep  = write_record_start(os, text, site, json);
+    write_field_name(
+        os, text, json, sep, site.get_plan(false, &make_plan<C>), 0);
+    if (json) {
+        os.put('"');
+    }
+    size_t pos = text.size();
+    write_values(os, c);
+    text.erase(pos, name_length(c));
+    end_text_field(text, pos, json);
+    write_record_end(os, json, 0);
+}
+
+/**
+ * \brief Call site read from binary output.
+ */
+struct DecodedSite {
+    /**
+     * \brief Constructor.
+     */
+    DecodedSite() : text(), names(), types() {
+    }
+
+    std::string              text;  /**< Rendered prefix, see Site. */
+    std::vector<std::string> names; /**< Argument names. */
+    std::vector<std::string> types; /**< Argument type names. */
+};
+
+/**
+ * \brief Read bytes of value in native byte order.
+ *
+ * \param in Input stream.
+ * \param v  Output value.
+ * \throw std::runtime_error if input ends.
+ */
+template<class T>
+void read_raw(std::istream& in, T& v) {
+    if (!in.read(reinterpret_cast<char*>(&v), sizeof(v))) {
+        throw std::runtime_error("Binary log: Truncated record");
+    }
+}
+
+/**
+ * \brief Read length prefixed string.
+ *
+ * \param in Input stream.
+ * \return String.
+ * \throw std::runtime_error if input ends.
+ */
+inline std::string read_string(std::istream& in) {
+    uint32_t n = 0;
+    read_raw(in, n);
+    std::string s(n, '\0');
+    if (n != 0 && !in.read(&s[0], static_cast<std::streamsize>(n))) {
+        throw std::runtime_error("Binary log: Truncated record");
+    }
+    return s;
+}
+
+/**
+ * \brief Read raw value and format it like l() does.
+ *
+ * \tparam T Value type.
+ * \param in  Input stream.
+ * \param out Output stream.
+ */
+template<class T>
+void decode_raw(std::istream& in, std::ostream& out) {
+    T v;
+    read_raw(in, v);
+    out << format_value(v);
+}
+
+/**
+ * \brief Read argument and format it like l() does.
+ *
+ * \param in  Input stream.
+ * \param out Output stream.
+ * \throw std::runtime_error if input is malformed.
+ */
+inline void decode_value(std::istream& in, std::ostream& out) {
+    char t = '\0';
+    read_raw(in, t);
+    switch (static_cast<BinaryType>(t)) {
+    case BinaryType::TEXT:
+        out << read_string(in);
+        break;
+    case BinaryType::STRING: {
+        std::string s = read_string(in);
+        out << format_value(s);
+        break;
+    }
+    case BinaryType::BOOL:
+        decode_raw<bool>(in, out);
+        break;
+    case BinaryType::CHAR:
+        decode_raw<char>(in, out);
+        break;
+    case BinaryType::SIGNED_CHAR:
+        decode_raw<signed char>(in, out);
+        break;
+    case BinaryType::UNSIGNED_CHAR:
+        decode_raw<unsigned char>(in, out);
+        break;
+    case BinaryType::CHAR16:
+        decode_raw<char16_t>(in, out);
+        break;
+    case BinaryType::CHAR32:
+        decode_raw<char32_t>(in, out);
+        break;
+    case BinaryType::WCHAR:
+        decode_raw<wchar_t>(in, out);
+        break;
+    case BinaryType::INT16:
+        decode_raw<int16_t>(in, out);
+        break;
+    case BinaryType::UINT16:
+        decode_raw<uint16_t>(in, out);
+        break;
+    case BinaryType::INT32:
+        decode_raw<int32_t>(in, out);
+        break;
+    case BinaryType::UINT32:
+        decode_raw<uint32_t>(in, out);
+        break;
+    case BinaryType::INT64:
+        decode_raw<int64_t>(in, out);
+        break;
+    case BinaryType::UINT64:
+        decode_raw<uint64_t>(in, out);
+        break;
+    case BinaryType::FLOAT:
+        decode_raw<float>(in, out);
+        break;
+    case BinaryType::DOUBLE:
+        decode_raw<double>(in, out);
+        break;
+    case BinaryType::LONG_DOUBLE:
+        decode_raw<long double>(in, out);
+        break;
+    default:
+        throw std::runtime_error("Binary log: Unknown argument type");
+    }
+}
+
+
+/**
+ * \brief State of an l_every_n() call site.
+ */
+class EveryN {
+  public:
+    /**
+     * \brief Constructor. Can be evaluated at compile time.
+     */
+    constexpr EveryN() noexcept : m_count(0) {
+    }
+
+    EveryN(const EveryN&) = delete;
+    EveryN& operator=(const EveryN&) = delete;
+
+    /**
+     * \brief Check if a message passes.
+     *
+     * \param n Interval. 0 is treated as 1.
+     * \return 0 if suppressed. Otherwise 1 + number of messages suppressed
+     * since the previous one that passed.
+     */
+    uint64_t pass(uint64_t n) noexcept {
+        uint64_t c = m_count.fetch_add(1, std::memory_order_relaxed);
+        if (n <= 1) {
+            return 1;
+        }
+        if (c % n != 0) {
+            return 0;
+        }
+        return c == 0 ? 1 : n;
+    }
+
+  private:
+    std::atomic<uint64_t> m_count; /**< Number of calls. */
+};
 
 /**
- * \brief Functionality in this namespace is for internal use
+ * \brief State of an l_every_ms() call site.
  */
-namespace internal {
+class EveryMs {
+  public:
+    /**
+     * \brief Constructor. Can be evaluated at compile time.
+     */
+    constexpr EveryMs() noexcept : m_last(never), m_suppressed(0) {
+    }
+
+    EveryMs(const EveryMs&) = delete;
+    EveryMs& operator=(const EveryMs&) = delete;
+
+    /**
+     * \brief Check if a message passes.
+     *
+     * \param ms Minimum interval in milliseconds.
+     * \return 0 if suppressed. Otherwise 1 + number of messages suppressed
+     * since the previous one that passed.
+     */
+    uint64_t pass(int64_t ms) noexcept {
+        int64_t now  = current_time(time_format::MONOTONIC);
+        int64_t last = m_last.load(std::memory_order_relaxed);
+        if ((last != never && now - last < ms * 1000000) ||
+            !m_last.compare_exchange_strong(
+                last, now, std::memory_order_relaxed)) {
+            // Count only if reported, to keep this path cheap
+            if (config().suppressedSummary.load(std::memory_order_relaxed)) {
+                m_suppressed.fetch_add(1, std::memory_order_relaxed);
+            }
+            return 0;
+        }
+        return 1 + m_suppressed.exchange(0, std::memory_order_relaxed);
+    }
+
+  private:
+    /** Value of \p m_last before first message. */
+    static constexpr int64_t never = std::numeric_limits<int64_t>::min();
+
+    std::atomic<int64_t>  m_last;       /**< Time of last message in ns. */
+    std::atomic<uint64_t> m_suppressed; /**< Suppressed since last. */
+};
 
-#ifdef __GNUC__
 /**
- * \brief Demangler of variable type names.
+ * \brief State of an l_once() call site.
  */
-class Demangler {
+class Once {
   public:
     /**
-     * \brief Constructor.
+     * \brief Constructor. Can be evaluated at compile time.
      */
-    Demangler() : m_buf(nullptr), m_buf_len(0) {
+    constexpr Once() noexcept : m_done(false) {
     }
 
+    Once(const Once&) = delete;
+    Once& operator=(const Once&) = delete;
+
     /**
-     * \brief Destructor. Free any allocated memory.
+     * \brief Check if a message passes.
+     *
+     * \return 1 the first time, otherwise 0.
      */
-    ~Demangler() {
-        // OK even if buf = nullptr
-        free(m_buf);
+    uint64_t pass() noexcept {
+        if (m_done.load(std::memory_order_relaxed) ||
+            m_done.exchange(true, std::memory_order_relaxed)) {
+            return 0;
+        }
+        return 1;
     }
 
+  private:
+    std::atomic<bool> m_done; /**< \c true if a message has passed. */
+};
+
+/**
+ * \brief State of an l_when() call site.
+ */
+class When {
+  public:
     /**
-     * \brief Demangle type name.
-     *
-     * \param type_name Mangled type name.
-     * \return Demangled type name.
+     * \brief Constructor. Can be evaluated at compile time.
      */
-    const char* demangle(const char* type_name) {
-        // Demangle name
-        int status = 0;
-        m_buf      = abi::__cxa_demangle(type_name, m_buf, &m_buf_len, &status);
+    constexpr When() noexcept : m_suppressed(0) {
+    }
 
-        // Check success
-        switch (status) {
-        case 0:
-            // Success. Do nothing.
-            break;
-        case -1: {
-            m_buf     = nullptr;
-            m_buf_len = 0;
-            std::stringstream ss;
-            ss << "Demangle: Invalid type name '" << type_name << '\'';
-            throw std::runtime_error(ss.str());
-            break;
-        }
-        case -2:
-            m_buf     = nullptr;
-            m_buf_len = 0;
-            throw std::runtime_error("Demangle: Memory allocation failure");
-            break;
-        case -3:
-            m_buf     = nullptr;
-            m_buf_len = 0;
-            throw std::runtime_error("Demangle: Invalid argument");
-            break;
-        default:
-            m_buf     = nullptr;
-            m_buf_len = 0;
-            throw std::runtime_error("Demangle: Unknown error");
-            break;
-        }
+    When(const When&) = delete;
+    When& operator=(const When&) = delete;
 
-        return m_buf;
+    /**
+     * \brief Check if a message passes.
+     *
+     * \param cond Condition.
+     * \return 0 if suppressed. Otherwise 1 + number of messages suppressed
+     * since the previous one that passed.
+     */
+    uint64_t pass(bool cond) noexcept {
+        if (!cond) {
+            // Count only if reported, to keep this path cheap
+            if (config().suppressedSummary.load(std::memory_order_relaxed)) {
+                m_suppressed.fetch_add(1, std::memory_order_relaxed);
+            }
+            return 0;
+        }
+        return 1 + m_suppressed.exchange(0, std::memory_order_relaxed);
     }
 
   private:
-    char*  m_buf;     /**< Demangle name buffer. Allocated with malloc. */
-    size_t m_buf_len; /**< Demangle name buffer length. */
+    std::atomic<uint64_t> m_suppressed; /**< Suppressed since last. */
 };
-#endif // __GNUC__
-
-/** Current prefixes */
-static prefix curPrefixes = prefix::FILE | prefix::LINE;
-/** \c true if output is enabled */
-static bool outputEnabled = true;
-/** \c true if colored output is enabled */
-static bool colorEnabled = false;
-#ifdef __GNUC__
-static Demangler demangler;
-#endif // __GNUC__
 
 /**
- * \brief Prefix formatter. */
-class PrefixFormatter {
+ * \brief 64 bit FNV-1a hash of bytes. Also a stream buffer, to hash the
+ * formatted form of values.
+ */
+class Hasher : public std::streambuf {
   public:
     /**
      * \brief Constructor.
-     *
-     * \param file_path File path including name.
-     * \param file_line Line number in file.
-     * \param func      Function name.
-     *
      */
-    PrefixFormatter(
-        const char* file_path, long file_line, const char* func) noexcept :
-        m_file_path(file_path),
-        m_file_line(file_line), m_func(func) {
+    Hasher() noexcept : m_hash(offset) {
     }
 
-    friend std::ostream& operator<<(
-        std::ostream& os, const PrefixFormatter& p) noexcept;
+    /**
+     * \brief Add bytes to hash.
+     *
+     * \param p Bytes [\p n].
+     * \param n Number of bytes.
+     */
+    void add(const void* p, size_t n) noexcept {
+        const auto* b = static_cast<const unsigned char*>(p);
+        for (size_t i = 0; i < n; ++i) {
+            m_hash = (m_hash ^ b[i]) * prime;
+        }
+    }
 
     /**
-     * \return File path including name.
+     * \return Hash of bytes added so far.
      */
-    const char* get_file_path() const noexcept {
-        return m_file_path;
+    uint64_t get() const noexcept {
+        return m_hash;
     }
 
+  protected:
     /**
-     * \return Line number in file.
+     * \brief Add character.
+     *
+     * \param c Character.
+     * \return \p c.
      */
-    long get_file_line_number() const noexcept {
-        return m_file_line;
+    int_type overflow(int_type c) override {
+        if (!traits_type::eq_int_type(c, traits_type::eof())) {
+            const char ch = traits_type::to_char_type(c);
+            add(&ch, 1);
+        }
+        return traits_type::not_eof(c);
     }
 
     /**
-     * \return Function name.
+     * \brief Add characters.
+     *
+     * \param s Characters [\p n].
+     * \param n Number of characters.
+     * \return \p n.
      */
-    const char* get_function_name() const noexcept {
-        return m_func;
+    std::streamsize xsputn(const char* s, std::streamsize n) override {
+        add(s, static_cast<size_t>(n));
+        return n;
     }
 
   private:
-    const char* m_file_path; /**< File path including name. */
-    const long  m_file_line; /**< Line number in file. */
-    const char* m_func;      /**< Function name. */
+    static constexpr uint64_t offset = 14695981039346656037ULL; /**< Basis. */
+    static constexpr uint64_t prime  = 1099511628211ULL;        /**< Prime. */
+
+    uint64_t m_hash; /**< Hash so far. */
 };
 
 /**
- * \brief Write to stream.
- *
- * \param os Output stream.
- * \param p  PrefixFormatter to output.
- * \return Output stream.
+ * \brief Priority of hash_value() overloads. Higher is tried first.
  *
+ * \tparam N Priority.
  */
-std::ostream& operator<<(std::ostream& os, const PrefixFormatter& p) noexcept {
-    /** Number of prefixes written */
-    uint32_t cnt = 0;
+template<int N>
+struct Priority : Priority<N - 1> {};
 
-    // FILE
-    if ((curPrefixes & prefix::FILE) != prefix::NONE) {
-        /** Platform dependent path separator */
-        const char sep =
-#ifdef _WIN32
-            '\\';
-#else
-            '/';
-#endif // _WIN32
+/**
+ * \brief Lowest priority.
+ */
+template<>
+struct Priority<0> {};
 
-        /** File path */
-        const char* path = p.get_file_path();
-
-        // Get index of last file path separator
-        /** Length of string */
-        size_t str_len = std::strlen(path);
-        /** File path separator index */
-        size_t sep_idx = std::numeric_limits<size_t>::max();
-        // No need to check for str_len = 0 here, since that
-        // will stop the for loop anyway
-        for (size_t i = str_len - 1; i != std::numeric_limits<size_t>::max();
-             --i) {
-            if (path[i] == sep) {
-                sep_idx = i;
-                break;
-            }
-        }
+template<class T>
+typename std::enable_if<std::is_integral<T>::value ||
+                        std::is_enum<T>::value ||
+                        std::is_same<T, float>::value ||
+                        std::is_same<T, double>::value>::type
+hash_value(Hasher& h, const T& v, Priority<2> /*p*/) noexcept;
+template<class C, class Tr, class A>
+void hash_value(Hasher& h, const std::basic_string<C, Tr, A>& v,
+    Priority<2> /*p*/) noexcept;
+template<class U, class V>
+void hash_value(Hasher& h, const std::pair<U, V>& v, Priority<2> /*p*/);
+template<class T>
+auto hash_value(Hasher& h, const T& v, Priority<1> /*p*/)
+    -> decltype(std::begin(v), std::end(v), void());
+template<class T>
+void hash_value(Hasher& h, const T& v, Priority<0> /*p*/);
 
-        // Output
-        os << (sep_idx == std::numeric_limits<size_t>::max() ?
-                   path :
-                   path + sep_idx + 1);
+/**
+ * \brief Hash number or enum by its bytes.
+ *
+ * \param h Hash.
+ * \param v Value.
+ */
+template<class T>
+typename std::enable_if<std::is_integral<T>::value ||
+                        std::is_enum<T>::value ||
+                        std::is_same<T, float>::value ||
+                        std::is_same<T, double>::value>::type
+hash_value(Hasher& h, const T& v, Priority<2> /*p*/) noexcept {
+    h.add(&v, sizeof(v));
+}
 
-        ++cnt;
-    }
+/**
+ * \brief Hash string by its characters, without formatting it.
+ *
+ * \param h Hash.
+ * \param v String.
+ */
+template<class C, class Tr, class A>
+void hash_value(Hasher& h, const std::basic_string<C, Tr, A>& v,
+    Priority<2> /*p*/) noexcept {
+    const size_t n = v.size();
+    h.add(v.data(), n * sizeof(C));
+    h.add(&n, sizeof(n));
+}
 
-    // LINE
-    if ((curPrefixes & prefix::LINE) != prefix::NONE) {
-        // Output 'Line' prefix only if file name has not been
-        // output
-        if (cnt == 0) {
-            os << "Line: ";
-        } else {
-            os << ":";
-        }
-        os << p.get_file_line_number();
+/**
+ * \brief Hash pair, e.g. an element of a std::map.
+ *
+ * \param h Hash.
+ * \param v Pair.
+ */
+template<class U, class V>
+void hash_value(Hasher& h, const std::pair<U, V>& v, Priority<2> /*p*/) {
+    hash_value(h, v.first, Priority<2>());
+    hash_value(h, v.second, Priority<2>());
+}
 
-        ++cnt;
+/**
+ * \brief Hash container, or other range defined by begin() and end(), by its
+ * elements. Also elements that wouldn't be output.
+ *
+ * \param h Hash.
+ * \param v Range.
+ */
+template<class T>
+auto hash_value(Hasher& h, const T& v, Priority<1> /*p*/)
+    -> decltype(std::begin(v), std::end(v), void()) {
+    size_t n = 0;
+    for (const auto& e : v) {
+        hash_value(h, e, Priority<2>());
+        ++n;
     }
+    h.add(&n, sizeof(n));
+}
 
-    // FUNCTION
-    if ((curPrefixes & prefix::FUNCTION) != prefix::NONE) {
-        if (cnt != 0) {
-            os << ", ";
-        }
-        os << p.get_function_name() << "()";
-        ++cnt;
+/**
+ * \brief Hash other value by its formatted form.
+ *
+ * \param h Hash.
+ * \param v Value.
+ */
+template<class T>
+void hash_value(Hasher& h, const T& v, Priority<0> /*p*/) {
+    std::ostream os(&h);
+    os << format_value(v);
+}
+
+/**
+ * \brief Hash values of a logging message.
+ *
+ * \tparam T Variable types.
+ * \param v  Variables.
+ * \return Hash.
+ */
+template<class... T>
+uint64_t hash_values(const T&... v) {
+    Hasher h;
+    int    expand[] = {(hash_value(h, v, Priority<2>()), 0)...};
+    static_cast<void>(expand);
+    return h.get();
+}
+
+/**
+ * \brief State of an l_changed() call site.
+ */
+class Changed {
+  public:
+    /**
+     * \brief Constructor.
+     */
+    Changed() :
+        m_hash(0), m_suppressed(0), m_stored(false), m_mutex(), m_previous() {
     }
 
-    // TIME
-    if ((curPrefixes & prefix::TIME) != prefix::NONE) {
-        // Get time
-        auto now = std::chrono::system_clock::now();
-
-        // Convert
-        std::time_t sinceEpoch = std::chrono::system_clock::to_time_t(now);
-        auto        ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-                      now.time_since_epoch()) %
-                  1000;
-        std::tm* local = std::localtime(&sinceEpoch);
-
-        if (local != nullptr) {
-            if (cnt != 0) {
-                os << ", ";
+    Changed(const Changed&) = delete;
+    Changed& operator=(const Changed&) = delete;
+
+    /**
+     * \brief Check if a message passes.
+     *
+     * \param hash Hash of variables, see hash_values().
+     * \return 0 if suppressed. Otherwise 1 + number of messages suppressed
+     * since the previous one that passed.
+     */
+    uint64_t pass(uint64_t hash) noexcept {
+        hash |= 1; // Never 0, which means that no message has passed
+        if (m_hash.load(std::memory_order_relaxed) == hash ||
+            m_hash.exchange(hash, std::memory_order_relaxed) == hash) {
+            // Count only if reported, to keep this path cheap
+            if (config().suppressedSummary.load(std::memory_order_relaxed)) {
+                m_suppressed.fetch_add(1, std::memory_order_relaxed);
             }
-            // Format and output
-            os << std::put_time(local, "%H:%M:%S") << '.' << std::setfill('0')
-               << std::setw(3) << ms.count();
-            ++cnt;
+            return 0;
         }
+        return 1 + m_suppressed.exchange(0, std::memory_order_relaxed);
     }
 
-    // THREAD
-    if ((curPrefixes & prefix::THREAD) != prefix::NONE) {
-        if (cnt != 0) {
-            os << ", ";
+    /**
+     * \return Mutex protecting get_previous().
+     */
+    std::mutex& get_mutex() noexcept {
+        return m_mutex;
+    }
+
+    /**
+     * \return Formatted variables of the previous message in format::TEXT.
+     * Must be locked by get_mutex().
+     */
+    std::vector<std::string>& get_previous() noexcept {
+        m_stored.store(true, std::memory_order_relaxed);
+        return m_previous;
+    }
+
+    /**
+     * \brief Forget formatted variables of the previous message, if any, so
+     * that stale ones aren't output once previous values are enabled again.
+     */
+    void clear_previous() {
+        if (m_stored.load(std::memory_order_relaxed)) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_previous.clear();
+            m_stored.store(false, std::memory_order_relaxed);
         }
-        os << "TID: " << std::this_thread::get_id();
-        ++cnt;
     }
 
-    // Final separator, if any
-    if (cnt != 0) {
-        os << ": ";
+  private:
+    std::atomic<uint64_t>    m_hash;       /**< Hash of last message, or 0. */
+    std::atomic<uint64_t>    m_suppressed; /**< Suppressed since last. */
+    std::atomic<bool>        m_stored;     /**< \c true if m_previous set. */
+    std::mutex               m_mutex;      /**< Protects m_previous. */
+    std::vector<std::string> m_previous;   /**< Variables of last message. */
+};
+
+/**
+ * \brief Number of suppressed messages, written after the variables of a
+ * rate limited message.
+ */
+struct Suppressed {
+    uint64_t count; /**< Number of suppressed messages. */
+};
+
+/**
+ * \brief Write number of suppressed messages, if any and if enabled.
+ *
+ * \param os Output stream.
+ * \param s  Number of suppressed messages.
+ * \return Output stream.
+ */
+inline std::ostream& operator<<(std::ostream& os, Suppressed s) {
+    if (s.count != 0 &&
+        config().suppressedSummary.load(std::memory_order_relaxed)) {
+        os << " (" << s.count << " suppressed)";
     }
+    return os;
+}
+
+/**
+ * \brief Sequence of indices, for expanding a std::tuple.
+ *
+ * \tparam I Indices.
+ */
+template<size_t... I>
+struct Indices {};
+
+/**
+ * \brief Make Indices<0, 1, ..., N - 1>.
+ *
+ * \tparam N Number of indices.
+ * \tparam I Indices so far.
+ */
+template<size_t N, size_t... I>
+struct MakeIndices : MakeIndices<N - 1, N - 1, I...> {};
+template<size_t... I>
+struct MakeIndices<0, I...> {
+    using type = Indices<I...>; /**< Indices. */
+};
+
+/**
+ * \brief Type that a variable is copied to when deferred. Formats the same
+ * as the variable.
+ *
+ * \tparam T Variable type, without reference, const and volatile.
+ */
+template<class T>
+struct Snapshot {
+    using type = T; /**< Copy type. */
+};
+template<>
+struct Snapshot<char*> {
+    using type = std::string; /**< Copy type. */
+};
+template<>
+struct Snapshot<const char*> {
+    using type = std::string; /**< Copy type. */
+};
+
+/**
+ * \brief Copy variable for deferred formatting.
+ *
+ * \param v Variable.
+ * \return \p v.
+ */
+template<class T>
+const T& snapshot(const T& v) noexcept {
+    return v;
+}
 
-    return os;
+/**
+ * \brief Copy C string for deferred formatting.
+ *
+ * \param v C string.
+ * \return Copy of \p v. Empty if \p v is nullptr.
+ */
+inline std::string snapshot(const char* v) {
+    return v == nullptr ? std::string() : std::string(v);
 }
 
 /**
- * \brief Variable value formatter.
+ * \brief Copy C string for deferred formatting.
  *
- * \tparam T Value type.
+ * \param v C string.
+ * \return Copy of \p v. Empty if \p v is nullptr.
+ */
+inline std::string snapshot(char* v) {
+    return snapshot(static_cast<const char*>(v));
+}
+
+/**
+ * \brief Copy type of a variable type.
  *
+ * \tparam T Variable type. May be a reference.
  */
 template<class T>
-class ValueFormatter {
+using SnapshotType = typename Snapshot<typename std::remove_cv<
+    typename std::remove_reference<T>::type>::type>::type;
+
+/**
+ * \brief Check if all variable types are deferrable.
+ *
+ * \tparam T Variable types. May be references.
+ */
+template<class... T>
+struct AllDeferrable;
+template<>
+struct AllDeferrable<> : std::true_type {};
+template<class T, class... U>
+struct AllDeferrable<T, U...>
+    : std::integral_constant<bool,
+          is_deferrable<typename std::remove_cv<
+              typename std::remove_reference<T>::type>::type>::value &&
+              AllDeferrable<U...>::value> {};
+
+/**
+ * \brief Copies of the variables of a logging message.
+ *
+ * \tparam S Copy types.
+ */
+template<class... S>
+class DeferredValues : public DeferredRecord {
   public:
     /**
-     * \brief Constructor.
-     *
-     * \param val Value.
+     * \brief Constructor. Copies variables.
      *
+     * \param site       Call site.
+     * \param make       Function building the plan of the call site.
+     * \param suppressed Number of suppressed messages before this one.
+     * \param v          Variables.
      */
-    explicit ValueFormatter(T& val) noexcept : m_val(val) {
+    template<class... T>
+    DeferredValues(const Site& site, FormatPlan* (*make)(const char*, bool),
+        uint64_t suppressed, T&... v) :
+        m_site(site),
+        m_make(make), m_suppressed(suppressed), m_values(snapshot(v)...) {
     }
 
-    // Container value helper functions.
-    std::ostream& sequence(std::ostream& os) const noexcept;
-    std::ostream& map(std::ostream& os) const noexcept;
-    std::ostream& stack(std::ostream& os) const noexcept;
-    std::ostream& queue(std::ostream& os) const noexcept;
-
-    template<class U>
-    friend std::ostream& operator<<(
-        std::ostream& os, const ValueFormatter<U>& f) noexcept;
-
     /**
-     * \return Value to format.
+     * \brief Write variables, number of suppressed messages and newline.
+     *
+     * \param os Output stream.
      */
-    T& get_value() const {
-        return m_val;
+    void format(std::ostream& os) override {
+        format(os, typename MakeIndices<sizeof...(S)>::type());
     }
 
   private:
-    T& m_val; /**< Value to format. Use non-const reference in case operator<<
-                 isn't const. */
+    /**
+     * \brief Write variables, number of suppressed messages and newline.
+     *
+     * \param os Output stream.
+     */
+    template<size_t... I>
+    void format(std::ostream& os, Indices<I...> /*indices*/) {
+        write_planned(os, m_site, m_make, std::get<I>(m_values)...)
+            << Suppressed{m_suppressed} << color_end << GL_NEWLINE;
+    }
+
+    const Site& m_site; /**< Call site. */
+    /** Function building the plan of the call site. */
+    FormatPlan* (*m_make)(const char*, bool);
+    uint64_t         m_suppressed; /**< Suppressed messages before. */
+    std::tuple<S...> m_values;     /**< Copies of variables. */
 };
 
 /**
- * \brief Create ValueFormatter with the right template type.
- *  This solves the error "cannot refer to class template
- * 'ValueFormatter' without a template argument list".
+ * \brief Variables that aren't all deferrable are never deferred.
  *
- * \tparam T Value type.
- * \param val Value.
- * \return New ValueFormatter.
+ * \return \c false.
  */
-template<class T>
-ValueFormatter<T> format_value(T& val) {
-    return ValueFormatter<T>(val);
-};
+template<class... T>
+bool defer(const Site& /*site*/, uint64_t /*suppressed*/,
+    std::false_type /*deferrable*/, T&... /*v*/) {
+    return false;
+}
 
 /**
- * \brief Write a sequence, defined by begin() and end(), to stream.
- *
- * \tparam T Value type.
- * \param os Output stream.
- * \return Output stream.
- *
+ * \brief Copy variables to a record that the writer thread formats.
+ *
+ * \tparam T         Variable types. References if lvalues.
+ * \param site       Call site.
+ * \param suppressed Number of suppressed messages before this one.
+ * \param v          Variables.
+ * \return \c false if not deferred, since the writer thread isn't running,
+ * sinks were added by gl::add_sink() or the copies are too large.
  */
-template<class T>
-std::ostream& ValueFormatter<T>::sequence(std::ostream& os) const noexcept {
-    os << '{';
-    // Print first object without comma
-    auto it = std::begin(m_val);
-    if (it != std::end(m_val)) {
-        os << format_value(*it);
-        ++it;
+template<class... T>
+bool defer(const Site& site, uint64_t suppressed,
+    std::true_type /*deferrable*/, T&... v) {
+    using R = DeferredValues<SnapshotType<T>...>;
+    if (sizeof(R) > DeferArena::maxSize ||
+        alignof(R) > alignof(std::max_align_t)) {
+        return false;
     }
-    // Print the rest
-    for (; it != std::end(m_val); ++it) {
-        os << ", " << format_value(*it);
+    AsyncWriter& w = async_writer();
+    // Sinks added by gl::add_sink() need the formatted text
+    if (!w.is_running() || is_fanout()) {
+        return false;
+    }
+    void* mem = defer_arena().allocate(sizeof(R));
+    R*    rec = nullptr;
+    try {
+        rec = new (mem) R(site, &make_plan<T...>, suppressed, v...);
+    } catch (...) {
+        DeferArena::release(mem);
+        throw;
     }
-    os << '}';
 
-    return os;
+    Line          line;
+    std::ostream& os = line.stream();
+    os << color_start << PrefixFormatter(site);
+    LineBuffer& buf = line.buffer();
+    if (w.push(buf.data(), buf.size(), false, rec)) {
+        buf.clear();
+    } else {
+        // Writer thread stopped meanwhile
+        rec->format(os);
+        release_record(rec);
+    }
+    return true;
 }
 
 /**
- * \brief Write a map, defined by begin() and end(), to stream.
- *
- * \tparam T Value type.
- * \param os Output stream.
- * \return Output stream.
+ * \brief Log variables as text.
  *
+ * \tparam T         Variable types. References if lvalues.
+ * \param site       Call site.
+ * \param suppressed Number of suppressed messages before this one.
+ * \param v          Variables.
  */
-template<class T>
-std::ostream& ValueFormatter<T>::map(std::ostream& os) const noexcept {
-    os << '{';
-    // Print first object without comma
-    auto it = m_val.begin();
-    if (it != m_val.end()) {
-        os << format_value(it->first) << ": " << format_value(it->second);
-        ++it;
-    }
-    // Print the rest
-    for (; it != m_val.end(); ++it) {
-        os << ", " << format_value(it->first) << ": "
-           << format_value(it->second);
-    }
-    os << '}';
-
-    return os;
+template<class... T>
+void write_text(const Site& site, uint64_t suppressed, T&&... v) {
+    write_variables(Line().stream() << color_start << PrefixFormatter(site),
+        site, v...)
+        << Suppressed{suppressed} << color_end << (GL_NEWLINE);
 }
 
 /**
- * \brief Write a stack, defined by top(), to stream.
- *
- * \tparam T Value type.
- * \param os Output stream.
- * \return Output stream.
+ * \brief Log variables in another way than plain format::TEXT.
  *
+ * \tparam T         Variable types. References if lvalues.
+ * \param site       Call site.
+ * \param suppressed Number of suppressed messages before this one.
+ * \param v          Variables.
  */
-template<class T>
-std::ostream& ValueFormatter<T>::stack(std::ostream& os) const noexcept {
-    // Only print first element, if available
-    os << '{';
-    if (m_val.size() == 1) {
-        os << format_value(m_val.top());
-    } else if (!m_val.empty()) {
-        os << format_value(m_val.top()) << ", ...";
+template<class... T>
+void write_record(const Site& site, uint64_t suppressed, T&&... v) {
+    const auto f = static_cast<format>(
+        config().format.load(std::memory_order_relaxed));
+    if (f == format::BINARY) {
+        write_binary(site, v...);
+    } else if (f != format::TEXT) {
+        write_structured(site, suppressed, v...);
+    } else if (!defer(site, suppressed, AllDeferrable<T...>(), v...)) {
+        write_text(site, suppressed, v...);
     }
-    os << '}';
-
-    return os;
 }
 
 /**
- * \brief Write a queue, defined by front() and back(), to stream.
- *
- * \tparam T Value type.
- * \param os Output stream.
- * \return Output stream.
+ * \brief Log array, matrix or bytes in another way than plain format::TEXT.
+ * Never deferred, since the values are in memory of the caller.
  *
+ * \param site Call site.
+ * \param c    Array, Matrix or Bytes.
  */
-template<class T>
-std::ostream& ValueFormatter<T>::queue(std::ostream& os) const noexcept {
-    // Only print first element, if available
-    os << '{';
-    if (m_val.size() == 1) {
-        os << format_value(m_val.front());
-    } else if (m_val.size() == 2) {
-        os << format_value(m_val.front()) << ", " << format_value(m_val.back());
-    } else if (!m_val.empty() != 0) {
-        os << format_value(m_val.front()) << ", ..., "
-           << format_value(m_val.back());
-    }
-    os << '}';
-
-    return os;
+template<class C>
+void write_record_text(const Site& site, const C& c) {
+    const auto f = static_cast<format>(
+        config().format.load(std::memory_order_relaxed));
+    if (f == format::BINARY) {
+        write_binary_text(site, c);
+    } else if (f != format::TEXT) {
+        write_structured_text(site, c);
+    } else {
+        Line().stream() << c;
+    }
 }
 
 /**
- * \brief General value formatter.
- *
- * \tparam T Value type.
- * \param os Output stream.
- * \param f  ValueFormatter.
- * \return Output stream.
- *
+ * \brief Write name and value of a variable of an l_changed() message, and
+ * its previous value if changed and enabled.
+ *
+ * \param os       Output stream writing to \p buf.
+ * \param buf      Message.
+ * \param plan     Plan.
+ * \param k        Index of variable. Incremented.
+ * \param previous Previous values, formatted. Updated. nullptr if previous
+ * values are disabled, since changes are then detected by hash alone.
+ * \param v        Variable.
  */
 template<class T>
-std::ostream& operator<<(
-    std::ostream& os, const ValueFormatter<T>& f) noexcept {
-    return os << f.m_val;
+void write_change(std::ostream& os, LineBuffer& buf, const FormatPlan& plan,
+    size_t& k, std::vector<std::string>* previous, T& v) {
+    plan.write_fragment(os, k);
+    const size_t pos = buf.size();
+    os << format_value(v);
+    std::string& text = buf.text();
+    if (previous == nullptr) {
+        // Nothing to keep
+    } else if (k == previous->size()) {
+        previous->emplace_back(text, pos);
+    } else if (text.compare(pos, std::string::npos, (*previous)[k]) != 0) {
+        std::string old = std::move((*previous)[k]);
+        (*previous)[k].assign(text, pos, std::string::npos);
+        text.insert(pos, old.append(" -> "));
+    }
+    ++k;
 }
 
 /**
- * \brief Format std::pair.
- *
- * \tparam U First type of pair.
- * \tparam V Second type of pair.
- * \param os Output stream.
- * \param f  ValueFormatter.
- * \return Output stream.
- *
+ * \brief Log variables of an l_changed() message as text.
+ *
+ * \tparam T         Variable types.
+ * \param site       Call site.
+ * \param state      Call site state.
+ * \param make       Function building the plan of the call site.
+ * \param suppressed Number of suppressed messages before this one.
+ * \param v          Variables.
  */
-template<class U, class V>
-std::ostream& operator<<(
-    std::ostream& os, const ValueFormatter<std::pair<U, V>>& f) noexcept {
-    return os << '{' << format_value(f.get_value().first) << ", "
-              << format_value(f.get_value().second) << '}';
+template<class... T>
+void write_changes(const Site& site, Changed& state,
+    FormatPlan* (*make)(const char*, bool), uint64_t suppressed, T&... v) {
+    bool typed = (current_prefixes() & prefix::TYPE_NAME) == prefix::TYPE_NAME;
+    const FormatPlan& plan = site.get_plan(typed, make);
+
+    Line          line;
+    std::ostream& os  = line.stream();
+    LineBuffer&   buf = line.buffer();
+    size_t        k   = 0;
+    os << color_start << PrefixFormatter(site);
+    if (config().previousValues.load(std::memory_order_relaxed)) {
+        std::lock_guard<std::mutex> lock(state.get_mutex());
+        std::vector<std::string>*   prev = &state.get_previous();
+        int expand[] = {(write_change(os, buf, plan, k, prev, v), 0)...};
+        static_cast<void>(expand);
+    } else {
+        state.clear_previous();
+        std::vector<std::string>* prev = nullptr;
+        int expand[] = {(write_change(os, buf, plan, k, prev, v), 0)...};
+        static_cast<void>(expand);
+    }
+    os << Suppressed{suppressed} << color_end << (GL_NEWLINE);
 }
 
 /**
- * \brief Format std::tuple.
- *
- * \tparam U First type of tuple.
- * \tparam V Second type of tuple.
- * \param os Output stream.
- * \param f  ValueFormatter.
- * \return Output stream.
+ * \brief Log variables if they changed since the previous message of the
+ * call site. Evaluates each argument once.
  *
+ * \tparam T    Variable types. References if lvalues.
+ * \param site  Call site.
+ * \param state Call site state.
+ * \param v     Variables.
  */
-template<class U, class V>
-std::ostream& operator<<(
-    std::ostream& os, const ValueFormatter<std::tuple<U, V>>& f) noexcept {
-    return os << '{' << format_value(std::get<0>(f.get_value())) << ", "
-              << format_value(std::get<1>(f.get_value())) << '}';
+template<class... T>
+void log_changed(const Site& site, Changed& state, T&&... v) {
+    const uint64_t pass = state.pass(hash_values(v...));
+    if (pass == 0) {
+        count_suppressed();
+        return;
+    }
+    StatsScope stats(site);
+    if (GL_UNLIKELY(!is_plain_text())) {
+        write_record(site, pass - 1, v...);
+    } else {
+        write_changes(site, state, &make_plan<T...>, pass - 1, v...);
+    }
 }
 
 /**
- * \brief Format std::unique_ptr.
+ * \brief Elapsed time of an l_scope() message.
+ */
+struct Elapsed {
+    uint64_t ns; /**< Nanoseconds. */
+};
+
+/**
+ * \brief Write duration in the largest unit that keeps it at least 1, with
+ * three decimals, e.g. "12.345 us".
  *
- * \tparam U Pointer type.
  * \param os Output stream.
- * \param f  ValueFormatter.
- * \return Output stream.
- *
+ * \param ns Nanoseconds.
  */
-template<class U>
-std::ostream& operator<<(
-    std::ostream& os, const ValueFormatter<std::unique_ptr<U>>& f) noexcept {
-    return os << f.get_value().get();
+inline void write_duration(std::ostream& os, uint64_t ns) {
+    static const char* const units[] = {" ns", " us", " ms", " s"};
+    if (ns < 1000) {
+        os << ns << units[0];
+        return;
+    }
+    uint64_t div = 1000;
+    size_t   u   = 1;
+    while (u < 3 && ns / div >= 1000) {
+        div *= 1000;
+        ++u;
+    }
+    const uint64_t f       = ns % div / (div / 1000);
+    const char     frac[4] = {static_cast<char>('0' + f / 100),
+        static_cast<char>('0' + f / 10 % 10), static_cast<char>('0' + f % 10),
+        '\0'};
+    os << ns / div << '.' << frac << units[u];
 }
 
 /**
- * \brief Format std::shared_ptr.
+ * \brief Write elapsed time.
  *
- * \tparam U Pointer type.
  * \param os Output stream.
- * \param f  ValueFormatter.
- * \return Output stream.
- *
+ * \param e  Elapsed time.
+ * \return \p os.
  */
-template<class U>
-std::ostream& operator<<(
-    std::ostream& os, const ValueFormatter<std::shared_ptr<U>>& f) noexcept {
-    return os << f.get_value().get();
+inline std::ostream& operator<<(std::ostream& os, const Elapsed& e) {
+    write_duration(os, e.ns);
+    return os;
 }
 
 /**
- * \brief Format std::weak_ptr.
+ * \brief Summary of the calls of an l_timer() call site.
+ */
+struct TimerSummary {
+    uint64_t calls; /**< Number of calls. */
+    uint64_t min;   /**< Shortest time in nanoseconds. */
+    uint64_t mean;  /**< Mean time in nanoseconds. */
+    uint64_t p99;   /**< 99th percentile in nanoseconds. */
+    uint64_t max;   /**< Longest time in nanoseconds. */
+};
+
+/**
+ * \brief Write summary, e.g.
+ * "1000 calls, min 1.000 us, mean 2.000 us, p99 5.000 us, max 9.000 us".
  *
- * \tparam U Pointer type.
  * \param os Output stream.
- * \param f  ValueFormatter.
- * \return Output stream.
- *
+ * \param t  Summary.
+ * \return \p os.
  */
-template<class U>
-std::ostream& operator<<(
-    std::ostream& os, const ValueFormatter<std::weak_ptr<U>>& f) noexcept {
-    // Convert to temporary shared_ptr in order to get value.
-    std::shared_ptr<U> tmp = f.get_value().lock();
-    return os << tmp.get();
+inline std::ostream& operator<<(std::ostream& os, const TimerSummary& t) {
+    os << t.calls << (t.calls == 1 ? " call, min " : " calls, min ");
+    write_duration(os, t.min);
+    os << ", mean ";
+    write_duration(os, t.mean);
+    os << ", p99 ";
+    write_duration(os, t.p99);
+    os << ", max ";
+    write_duration(os, t.max);
+    return os;
 }
 
+class Timer;
+
 /**
- * \brief Format std::complex.
- *
- * \tparam U Pointer type.
- * \param os Output stream.
- * \param f  ValueFormatter.
- * \return Output stream.
- *
+ * \return Head of list of l_timer() call sites that have been called.
  */
-template<class U>
-std::ostream& operator<<(
-    std::ostream& os, const ValueFormatter<std::complex<U>>& f) noexcept {
-    os << f.get_value().real();
-    if (f.get_value().imag() >= 0) {
-        os << " + " << f.get_value().imag();
-    } else {
-        os << " - " << -f.get_value().imag();
-    }
-    return os << 'i';
+inline std::atomic<Timer*>& timer_list() noexcept {
+    static std::atomic<Timer*> head(nullptr);
+    return head;
 }
 
 /**
- * \brief Format std::valarray.
- *
- * \tparam U Element type.
- * \param os Output stream.
- * \param f  ValueFormatter.
- * \return Output stream.
+ * \brief Times of an l_timer() call site, since its previous summary.
  *
+ * Times are counted in a histogram of 16 buckets per power of two, so
+ * percentiles are exact up to 15 ns and within 1/16 above.
  */
-template<class U>
-std::ostream& operator<<(
-    std::ostream& os, const ValueFormatter<std::valarray<U>>& f) noexcept {
-    return f.sequence(os);
-}
+class Timer {
+  public:
+    /** Bits of a time below its highest set bit that select a bucket. */
+    static constexpr unsigned subBits = 4;
+    /** Number of buckets. */
+    static constexpr size_t bucketCount = (64 - subBits + 1) << subBits;
+
+    /**
+     * \brief Constructor. Can be evaluated at compile time.
+     *
+     * \param site Call site.
+     */
+    constexpr explicit Timer(const Site& site) noexcept :
+        m_site(site), m_calls(0), m_sum(0),
+        m_min(std::numeric_limits<uint64_t>::max()), m_max(0), m_buckets{},
+        m_mutex(), m_next(nullptr), m_listed(false) {
+    }
+
+    Timer(const Timer&) = delete;
+    Timer& operator=(const Timer&) = delete;
+
+    /**
+     * \return Call site.
+     */
+    const Site& get_site() const noexcept {
+        return m_site;
+    }
+
+    /**
+     * \return Next timer in timer_list(), or nullptr if last.
+     */
+    Timer* get_next() const noexcept {
+        return m_next;
+    }
+
+    /**
+     * \brief Count a time. Adds the timer to timer_list() the first time.
+     *
+     * \param ns Nanoseconds.
+     * \param n  Calls per summary, or 0 for summaries on demand only.
+     * \return \c true if \p n calls have been counted since the previous
+     * summary.
+     */
+    bool add(uint64_t ns, uint64_t n) noexcept {
+        if (!m_listed.load(std::memory_order_relaxed) &&
+            !m_listed.exchange(true, std::memory_order_relaxed)) {
+            Timer* first = timer_list().load(std::memory_order_relaxed);
+            do {
+                m_next = first;
+            } while (!timer_list().compare_exchange_weak(
+                first, this, std::memory_order_release));
+        }
+        m_buckets[bucket(ns)].fetch_add(1, std::memory_order_relaxed);
+        m_sum.fetch_add(ns, std::memory_order_relaxed);
+        uint64_t v = m_min.load(std::memory_order_relaxed);
+        while (ns < v && !m_min.compare_exchange_weak(
+                             v, ns, std::memory_order_relaxed)) {
+        }
+        v = m_max.load(std::memory_order_relaxed);
+        while (ns > v && !m_max.compare_exchange_weak(
+                             v, ns, std::memory_order_relaxed)) {
+        }
+        const uint64_t c = m_calls.fetch_add(1, std::memory_order_relaxed);
+        return n != 0 && (c + 1) % n == 0;
+    }
+
+    /**
+     * \brief Summarize the times counted since the previous summary, and
+     * start over.
+     *
+     * Times counted meanwhile by other threads may end up in either summary.
+     *
+     * \param[out] t Summary.
+     * \return \c true if any time had been counted.
+     */
+    bool summarize(TimerSummary& t) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        uint64_t                    counts[bucketCount];
+        t.calls = 0;
+        for (size_t i = 0; i < bucketCount; ++i) {
+            counts[i] = m_buckets[i].exchange(0, std::memory_order_relaxed);
+            t.calls += counts[i];
+        }
+        const uint64_t sum = m_sum.exchange(0, std::memory_order_relaxed);
+        t.min  = m_min.exchange(
+            std::numeric_limits<uint64_t>::max(), std::memory_order_relaxed);
+        t.max  = m_max.exchange(0, std::memory_order_relaxed);
+        t.mean = t.calls == 0 ? 0 : sum / t.calls;
+        t.p99  = t.max;
+        if (t.calls == 0) {
+            return false;
+        }
+        // Smallest bucket that holds at least 99 % of the times
+        const uint64_t rank = t.calls - (t.calls / 100);
+        uint64_t       seen = 0;
+        for (size_t i = 0; i < bucketCount; ++i) {
+            seen += counts[i];
+            if (seen >= rank) {
+                t.p99 = std::min(t.max, std::max(t.min, upper_bound(i)));
+                break;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * \return Bucket of a time.
+     *
+     * \param ns Nanoseconds.
+     */
+    static size_t bucket(uint64_t ns) noexcept {
+        if (ns < (uint64_t(1) << subBits)) {
+            return static_cast<size_t>(ns);
+        }
+        unsigned e = highest_bit(ns);
+        return static_cast<size_t>(((e - subBits + 1) << subBits) +
+                                   ((ns >> (e - subBits)) &
+                                       ((uint64_t(1) << subBits) - 1)));
+    }
+
+    /**
+     * \return Largest time of a bucket.
+     *
+     * \param i Bucket.
+     */
+    static uint64_t upper_bound(size_t i) noexcept {
+        if (i < (size_t(1) << subBits)) {
+            return i;
+        }
+        const unsigned e   = static_cast<unsigned>(i >> subBits) + subBits - 1;
+        const uint64_t sub = i & ((size_t(1) << subBits) - 1);
+        const uint64_t width = uint64_t(1) << (e - subBits);
+        return (((uint64_t(1) << subBits) + sub) << (e - subBits)) + width - 1;
+    }
+
+  private:
+    /**
+     * \return Index of highest set bit.
+     *
+     * \param v Value, not 0.
+     */
+    static unsigned highest_bit(uint64_t v) noexcept {
+#ifdef __GNUC__
+        return 63 - static_cast<unsigned>(__builtin_clzll(v));
+#else
+        unsigned b = 0;
+        while (v >>= 1) {
+            ++b;
+        }
+        return b;
+#endif // __GNUC__
+    }
+
+    const Site&           m_site;  /**< Call site. */
+    std::atomic<uint64_t> m_calls; /**< Times counted in total. */
+    std::atomic<uint64_t> m_sum;   /**< Sum of times since summary. */
+    std::atomic<uint64_t> m_min;   /**< Shortest time since summary. */
+    std::atomic<uint64_t> m_max;   /**< Longest time since summary. */
+    /** Number of times per bucket since summary. */
+    std::atomic<uint64_t> m_buckets[bucketCount];
+    std::mutex            m_mutex;  /**< Serializes summaries. */
+    Timer*                m_next;   /**< Next in timer_list(). */
+    std::atomic<bool>     m_listed; /**< \c true if in timer_list(). */
+};
 
 /**
- * \brief Format bool.
- *
- * \param os Output stream.
- * \param f  ValueFormatter.
- * \return Output stream.
+ * \brief Log a value of an l_scope() or l_timer() call site.
  *
+ * \tparam T   Elapsed or TimerSummary.
+ * \param site Call site.
+ * \param v    Value.
  */
-template<>
-std::ostream& operator<<(
-    std::ostream& os, const ValueFormatter<bool>& f) noexcept {
-    return os << (f.m_val ? "true" : "false");
+template<class T>
+void write_timing(const Site& site, const T& v) {
+    StatsScope stats(site);
+    if (GL_UNLIKELY(!is_plain_text())) {
+        write_record(site, 0, v);
+    } else {
+        write_text(site, 0, v);
+    }
 }
 
-// 3.9.1 in C++ standard: Plain char, signed char, and unsigned
-// char are three distinct types
-
 /**
- * \brief Format char.
- *
- * \param os Output stream.
- * \param f  ValueFormatter.
- * \return Output stream.
+ * \brief Log the summary of an l_timer() call site, unless empty.
  *
+ * \param t Timer.
  */
-template<>
-std::ostream& operator<<(
-    std::ostream& os, const ValueFormatter<char>& f) noexcept {
-    return os << '\'' << f.m_val << '\'';
+inline void write_summary(Timer& t) {
+    TimerSummary s = {};
+    if (t.summarize(s) && t.get_site().is_selected()) {
+        write_timing(t.get_site(), s);
+    }
 }
 
 /**
- * \brief Format unsigned char.
- *
- * \param os Output stream.
- * \param f  ValueFormatter.
- * \return Output stream.
- *
+ * \brief Measures the time until destroyed for l_scope() and l_timer().
  */
-template<>
-std::ostream& operator<<(
-    std::ostream& os, const ValueFormatter<unsigned char>& f) noexcept {
-    return os << '\'' << f.m_val << '\'';
-}
+class Scope {
+  public:
+    /**
+     * \brief Constructor. Starts measuring if \p enabled and the call site
+     * is selected by set_filter().
+     *
+     * \param enabled \c true if output is enabled at the level of the site.
+     * \param site    Call site.
+     * \param timer   Timer to count the time in, or nullptr to log it.
+     * \param n       Calls of \p timer per summary. 0 for on demand only.
+     */
+    Scope(bool enabled, const Site& site, Timer* timer = nullptr,
+        uint64_t n = 0) :
+        m_site(enabled && site.is_selected() ? &site : nullptr),
+        m_timer(timer), m_n(n), m_start() {
+        if (m_site != nullptr) {
+            m_start = std::chrono::steady_clock::now();
+        }
+    }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+    /**
+     * \brief Destructor. Logs the elapsed time, or counts it in the timer
+     * and logs its summary every \p n calls.
+     */
+    ~Scope() {
+        if (m_site == nullptr) {
+            return;
+        }
+        const uint64_t ns = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - m_start)
+                .count());
+        try {
+            if (m_timer == nullptr) {
+                write_timing(*m_site, Elapsed{ns});
+            } else if (m_timer->add(ns, m_n)) {
+                write_summary(*m_timer);
+            }
+        } catch (...) {
+            // Don't throw from destructor, e.g. during stack unwinding
+        }
+    }
+
+  private:
+    const Site* m_site;  /**< Call site, or nullptr if not measuring. */
+    Timer*      m_timer; /**< Timer, or nullptr. */
+    uint64_t    m_n;     /**< Calls per summary. */
+    /** Time of construction. */
+    std::chrono::steady_clock::time_point m_start;
+};
+
+/**
+ * \brief Explicitly instantiate the logging of one variable of type \p T, as
+ * in l(v), and its formatting in messages of several variables.
+ *
+ * \param ext Empty for a definition, or \c extern for a declaration.
+ * \param T   Variable type, possibly const. */
+#define GL_INTERNAL_INSTANTIATE(ext, T)                            \
+    ext template std::ostream& write_variables<T&>(                \
+        std::ostream&, const Site&, T&);                           \
+    ext template void write_record<T&>(const Site&, uint64_t, T&); \
+    ext template void write_variable<T>(                           \
+        std::ostream&, const FormatPlan&, size_t&, T&);
+
+/**
+ * \brief Apply \p X to the commonly logged types, which the library built
+ * from src/goinglogging.cpp instantiates.
+ *
+ * \param X   Macro taking \p ext and a type.
+ * \param ext Passed to \p X. */
+#define GL_INTERNAL_COMMON_TYPES(X, ext)                                \
+    X(ext, bool) X(ext, const bool) X(ext, char) X(ext, const char)     \
+    X(ext, int) X(ext, const int) X(ext, unsigned int)                  \
+    X(ext, const unsigned int) X(ext, long) X(ext, const long)          \
+    X(ext, unsigned long) X(ext, const unsigned long) X(ext, long long) \
+    X(ext, const long long) X(ext, unsigned long long)                  \
+    X(ext, const unsigned long long) X(ext, float) X(ext, const float)  \
+    X(ext, double) X(ext, const double) X(ext, std::string)             \
+    X(ext, const std::string) X(ext, const char*) X(ext, const char* const)
+
+#ifdef GL_EXTERN_TEMPLATES
+GL_INTERNAL_COMMON_TYPES(GL_INTERNAL_INSTANTIATE, extern)
+#endif // GL_EXTERN_TEMPLATES
+
+} // namespace internal
+
+#endif // DOXYGEN_HIDDEN
 
 /**
- * \brief Format signed char.
  *
- * \param os Output stream.
- * \param f  ValueFormatter.
- * \return Output stream.
+ * \return Bitwise \c or of prefix settings.
+ *
+ * \sa prefix \sa set_prefixes()
  *
  */
-template<>
-std::ostream& operator<<(
-    std::ostream& os, const ValueFormatter<signed char>& f) noexcept {
-    return os << '\'' << f.m_val << '\'';
+inline prefix get_prefixes() noexcept {
+    return internal::current_prefixes();
 }
 
 /**
- * \brief Format char*.
+ * \brief Set prefixes of logging output.
  *
- * \param os Output stream.
- * \param f  ValueFormatter.
- * \return Output stream.
+ * Alters the output of \ref l(), \ref l_arr(), and \ref l_mat().
+ *
+ * \param p Bitwise \c or of prefix settings.
+ *
+ * Used as:
+ * \code
+ * gl::set_prefixes(gl::prefix::FILE | gl::prefix::LINE);
+ * \endcode
+ * to also log current file and line number.
+ *
+ * \note Defaults to prefix::FILE | prefix::LINE.
+ *
+ * \sa prefix \sa get_prefixes()
  *
  */
-template<>
-std::ostream& operator<<(
-    std::ostream& os, const ValueFormatter<char*>& f) noexcept {
-    return os << '\"' << f.m_val << '\"';
+inline void set_prefixes(prefix p) noexcept {
+    internal::config().prefixes.store(
+        static_cast<uint32_t>(p), std::memory_order_relaxed);
 }
 
 /**
- * \brief Format const char*.
  *
- * \param os Output stream.
- * \param f  ValueFormatter.
- * \return Output stream.
+ * \return \c true if output is enabled.
+ *
+ * \sa set_output_enabled()
  *
  */
-template<>
-std::ostream& operator<<(
-    std::ostream& os, const ValueFormatter<const char*>& f) noexcept {
-    return os << '\"' << f.m_val << '\"';
+inline bool is_output_enabled() noexcept {
+    return internal::config().userOutputEnabled.load(
+        std::memory_order_relaxed);
 }
 
 /**
- * \brief Format std::tm.
+ * \brief Enable or disable output.
  *
- * \param os Output stream.
- * \param f  ValueFormatter.
- * \return Output stream.
+ * \param e \c true if output shall be enabled.
+ *
+ * \note Defaults to enabled.
+ *
+ * \sa is_output_enabled()
  *
  */
-template<>
-std::ostream& operator<<(
-    std::ostream& os, const ValueFormatter<std::tm>& f) noexcept {
-    // Format as "YYYY-MM-DD HH:MM:SS", including null pointer
-    char buf[20];
-    if (std::strftime(buf, sizeof(buf), "%F %T", &f.m_val) == 0) {
-        os << "std::tm format error";
-    } else {
-        os << buf;
-    }
-    return os;
+inline void set_output_enabled(bool e) noexcept {
+    internal::config().userOutputEnabled.store(e, std::memory_order_relaxed);
+    internal::update_level_gate();
 }
 
 /**
- * \brief Format std::div_t.
+ * \brief Set format of prefix::TIME.
  *
- * \param os Output stream.
- * \param f  ValueFormatter.
- * \return Output stream.
+ * \param f Format.
+ *
+ * \note Defaults to time_format::LOCAL_MILLISECONDS.
+ *
+ * \sa get_time_format() \sa prefix
  *
  */
-template<>
-std::ostream& operator<<(
-    std::ostream& os, const ValueFormatter<std::div_t>& f) noexcept {
-    return os << "{quot = " << f.m_val.quot << ", rem = " << f.m_val.rem << '}';
+inline void set_time_format(time_format f) noexcept {
+    internal::config().timeFormat.store(
+        static_cast<uint32_t>(f), std::memory_order_relaxed);
 }
 
 /**
- * \brief Format std::ldiv_t.
  *
- * \param os Output stream.
- * \param f  ValueFormatter.
- * \return Output stream.
+ * \return Format of prefix::TIME.
+ *
+ * \sa set_time_format()
  *
  */
-template<>
-std::ostream& operator<<(
-    std::ostream& os, const ValueFormatter<std::ldiv_t>& f) noexcept {
-    return os << "{quot = " << f.m_val.quot << ", rem = " << f.m_val.rem << '}';
+inline time_format get_time_format() noexcept {
+    return static_cast<time_format>(
+        internal::config().timeFormat.load(std::memory_order_relaxed));
 }
 
 /**
- * \brief Format std::lldiv_t.
+ * \brief Set lowest level of logging output at runtime.
  *
- * \param os Output stream.
- * \param f  ValueFormatter.
- * \return Output stream.
+ * Affects e.g. \ref l_debug(), but not \ref l(). Checking the level is a
+ * single relaxed atomic load.
+ *
+ * \param lvl Level. level::L_OFF disables all leveled logging.
+ *
+ * \note Defaults to level::L_TRACE.
+ * \note Levels lower than GL_ACTIVE_LEVEL are never output.
+ *
+ * \sa get_level() \sa GL_ACTIVE_LEVEL
  *
  */
-template<>
-std::ostream& operator<<(
-    std::ostream& os, const ValueFormatter<std::lldiv_t>& f) noexcept {
-    return os << "{quot = " << f.m_val.quot << ", rem = " << f.m_val.rem << '}';
+inline void set_level(level lvl) noexcept {
+    internal::config().userLevel.store(
+        static_cast<uint32_t>(lvl), std::memory_order_relaxed);
+    internal::update_level_gate();
 }
 
 /**
- * \brief Format std::ratio.
  *
- * \param os Output stream.
- * \param f  ValueFormatter.
- * \return Output stream.
+ * \return Lowest level of logging output.
+ *
+ * \sa set_level()
  *
  */
-template<std::intmax_t U, std::intmax_t V>
-std::ostream& operator<<(
-    std::ostream& os, const ValueFormatter<std::ratio<U, V>>& f) noexcept {
-    return os << f.get_value().num << " / " << f.get_value().den;
+inline level get_level() noexcept {
+    return static_cast<level>(
+        internal::config().userLevel.load(std::memory_order_relaxed));
 }
 
 /**
- * \brief Format std::stringbuf.
+ * \brief Only output logging messages of some files and functions.
  *
- * \param os Output stream.
- * \param f  ValueFormatter.
- * \return Output stream.
+ * The filter is a comma separated list of file patterns, each optionally
+ * followed by ':' and a function pattern. In patterns, '*' matches any
+ * characters and '?' one character. A file pattern is matched with the file
+ * name, or with the file path if it contains a path separator. A message is
+ * output if its call site matches any of them. Use as:
+ * \code
+ * gl::set_filter("motor_*.cpp, main.cpp:run");
+ * \endcode
+ *
+ * Each call site matches a new filter once, so a filtered message costs
+ * about as much as a check of the level.
+ *
+ * \param f Filter. Empty to output all messages.
+ *
+ * \note Defaults to empty.
+ * \note Arguments of filtered messages are not evaluated.
+ *
+ * \sa get_filter()
  *
  */
-template<>
-std::ostream& operator<<(
-    std::ostream& os, const ValueFormatter<std::stringbuf>& f) noexcept {
-    return os << '\"' << f.m_val.str() << '\"';
+inline void set_filter(const std::string& f) {
+    std::shared_ptr<const internal::Filter> filt =
+        std::make_shared<internal::Filter>(f);
+    internal::FilterHolder&     h = internal::filter_holder();
+    std::lock_guard<std::mutex> lock(h.mutex);
+    h.filter = std::move(filt);
+    // 31 bits, and never 0, which means that no filter has been set
+    std::atomic<uint32_t>& gen = internal::config().filterGeneration;
+    gen.store(gen.load(std::memory_order_relaxed) % 0x7FFFFFFF + 1,
+        std::memory_order_release);
 }
 
 /**
- * \brief Format std::wstringbuf.
  *
- * \param os Output stream.
- * \param f  ValueFormatter.
- * \return Output stream.
+ * \return Filter of call sites.
+ *
+ * \sa set_filter()
  *
  */
-template<>
-std::ostream& operator<<(
-    std::ostream& os, const ValueFormatter<std::wstringbuf>& f) noexcept {
-    std::wstring_convert<std::codecvt_utf8<wchar_t>, wchar_t> converter;
-    return os << '\"' << converter.to_bytes(f.m_val.str()) << '\"';
+inline std::string get_filter() {
+    internal::FilterHolder&     h = internal::filter_holder();
+    std::lock_guard<std::mutex> lock(h.mutex);
+    return h.filter == nullptr ? std::string() : h.filter->get_text();
 }
 
 /**
- * \brief Format std::ostringstream.
+ * \brief Enable or disable ANSI color output.
  *
- * \param os Output stream.
- * \param f  ValueFormatter.
- * \return Output stream.
+ * \param e \c true if output shall be colored.
+ *
+ * \note Defaults to disabled.
+ *
+ * \sa is_color_enabled()
  *
  */
-template<>
-std::ostream& operator<<(
-    std::ostream& os, const ValueFormatter<std::ostringstream>& f) noexcept {
-    return os << '\"' << f.m_val.str() << '\"';
+inline void set_color_enabled(bool e) noexcept {
+    internal::config().colorEnabled.store(e, std::memory_order_relaxed);
 }
 
 /**
- * \brief Format std::wostringstream.
  *
- * \param os Output stream.
- * \param f  ValueFormatter.
- * \return Output stream.
+ * \return \c true if ANSI color output is enabled.
+ *
+ * \sa set_color_enabled()
  *
  */
-template<>
-std::ostream& operator<<(
-    std::ostream& os, const ValueFormatter<std::wostringstream>& f) noexcept {
-    std::wstring_convert<std::codecvt_utf8<wchar_t>, wchar_t> converter;
-    return os << '\"' << converter.to_bytes(f.m_val.str()) << '\"';
+inline bool is_color_enabled() noexcept {
+    return internal::config().colorEnabled.load(std::memory_order_relaxed);
 }
 
 /**
- * \brief Format std::stringstream.
+ * \brief Enable or disable asynchronous output.
  *
- * \param os Output stream.
- * \param f  ValueFormatter.
- * \return Output stream.
+ * When enabled, \ref l(), \ref l_arr() and \ref l_mat() hand off each logging
+ * message to a bounded lock-free queue. A background thread writes the
+ * messages in batches. Disabling writes all queued messages and stops the
+ * background thread.
+ *
+ * \param e \c true if output shall be asynchronous.
+ *
+ * \note Defaults to disabled.
+ *
+ * \sa is_async_enabled() \sa set_async_capacity() \sa set_async_overflow()
  *
  */
-template<>
-std::ostream& operator<<(
-    std::ostream& os, const ValueFormatter<std::stringstream>& f) noexcept {
-    return os << '\"' << f.m_val.str() << '\"';
+inline void set_async_enabled(bool e) {
+    if (e) {
+        internal::async_writer().start();
+    } else {
+        internal::async_writer().stop();
+    }
 }
 
 /**
- * \brief Format std::wstringstream.
  *
- * \param os Output stream.
- * \param f  ValueFormatter.
- * \return Output stream.
+ * \return \c true if output is asynchronous.
+ *
+ * \sa set_async_enabled()
  *
  */
-template<>
-std::ostream& operator<<(
-    std::ostream& os, const ValueFormatter<std::wstringstream>& f) noexcept {
-    std::wstring_convert<std::codecvt_utf8<wchar_t>, wchar_t> converter;
-    return os << '\"' << converter.to_bytes(f.m_val.str()) << '\"';
+inline bool is_async_enabled() noexcept {
+    return internal::async_writer().is_running();
 }
 
 /**
- * \brief Format std::locale.
+ * \brief Set maximum number of queued messages in asynchronous mode.
  *
- * \param os Output stream.
- * \param f  ValueFormatter.
- * \return Output stream.
+ * \param c Capacity. Rounded up to a power of two.
+ *
+ * \note Takes effect the next time asynchronous output is enabled.
+ * \note Defaults to 1024.
+ *
+ * \sa get_async_capacity() \sa set_async_enabled()
  *
  */
-template<>
-std::ostream& operator<<(
-    std::ostream& os, const ValueFormatter<std::locale>& f) noexcept {
-    return os << '"' << f.m_val.name() << '"';
+inline void set_async_capacity(size_t c) noexcept {
+    internal::async_writer().set_capacity(c);
 }
 
 /**
- * \brief Format std::string.
  *
- * \param os Output stream.
- * \param f  ValueFormatter.
- * \return Output stream.
+ * \return Maximum number of queued messages in asynchronous mode.
+ *
+ * \sa set_async_capacity()
  *
  */
-template<>
-std::ostream& operator<<(
-    std::ostream& os, const ValueFormatter<std::string>& f) noexcept {
-    return os << '\"' << f.m_val << '\"';
+inline size_t get_async_capacity() noexcept {
+    return internal::async_writer().get_capacity();
 }
 
 /**
- * \brief Format std::u16string.
+ * \brief Set what to do when the asynchronous queue is full.
  *
- * \param os Output stream.
- * \param f  ValueFormatter.
- * \return Output stream.
+ * \param o Overflow policy.
+ *
+ * \note Defaults to overflow::BLOCK.
+ *
+ * \sa overflow \sa get_async_overflow() \sa get_dropped_count()
  *
  */
-template<>
-std::ostream& operator<<(
-    std::ostream& os, const ValueFormatter<std::u16string>& f) noexcept {
-    std::wstring_convert<std::codecvt_utf8<char16_t>, char16_t> converter;
-    return os << '\"' << converter.to_bytes(f.m_val) << '\"';
+inline void set_async_overflow(overflow o) noexcept {
+    internal::async_writer().set_overflow(o);
 }
 
 /**
- * \brief Format std::u32string.
  *
- * \param os Output stream.
- * \param f  ValueFormatter.
- * \return Output stream.
+ * \return What to do when the asynchronous queue is full.
+ *
+ * \sa set_async_overflow()
  *
  */
-template<>
-std::ostream& operator<<(
-    std::ostream& os, const ValueFormatter<std::u32string>& f) noexcept {
-    std::wstring_convert<std::codecvt_utf8<char32_t>, char32_t> converter;
-    return os << '\"' << converter.to_bytes(f.m_val) << '\"';
+inline overflow get_async_overflow() noexcept {
+    return internal::async_writer().get_overflow();
 }
 
 /**
- * \brief Format std::wstring.
  *
- * \param os Output stream.
- * \param f  ValueFormatter.
- * \return Output stream.
+ * \return Number of logging messages dropped since start of program, because
+ * the asynchronous queue or the queue of a sink added by add_sink() was full.
+ *
+ * \sa set_async_overflow()
  *
  */
-template<>
-std::ostream& operator<<(
-    std::ostream& os, const ValueFormatter<std::wstring>& f) noexcept {
-    std::wstring_convert<std::codecvt_utf8<wchar_t>, wchar_t> converter;
-    return os << '\"' << converter.to_bytes(f.m_val) << '\"';
+inline uint64_t get_dropped_count() noexcept {
+    uint64_t n = internal::async_writer().get_dropped();
+    for (const auto& a : internal::added_sinks()) {
+        n += a->writer.get_dropped();
+    }
+    return n;
 }
 
 /**
- * \brief Format std::array.
+ * \brief Enable or disable deferred formatting of \ref l().
+ *
+ * When enabled and the asynchronous writer runs, the variables of a message
+ * are copied to memory recycled per thread, and formatted by the writer
+ * thread. This keeps formatting of e.g. containers and strings off the
+ * calling thread. Messages with a variable that isn't deferrable, see
+ * is_deferrable, or whose copies are too large, are formatted when logged.
+ *
+ * \param e \c true if formatting shall be deferred.
  *
- * \tparam U Value type.
- * \tparam N Number of elements.
- * \param os Output stream.
- * \param f  ValueFormatter.
- * \return Output stream.
+ * \note Defaults to disabled.
+ * \note Only applies to format::TEXT. \ref l_arr() and \ref l_mat() are
+ * formatted when logged.
+ * \note Copying a container or a long string still allocates.
+ * \note A C string that is nullptr is logged as "".
+ *
+ * \sa is_deferred_enabled() \sa set_async_enabled() \sa is_deferrable
  *
  */
-template<class U, size_t N>
-std::ostream& operator<<(
-    std::ostream& os, const ValueFormatter<std::array<U, N>>& f) noexcept {
-    return f.sequence(os);
+inline void set_deferred_enabled(bool e) noexcept {
+    internal::config().deferred.store(e, std::memory_order_relaxed);
+    internal::update_plain_text();
 }
 
 /**
- * \brief Format std::vector.
  *
- * \tparam U Value type.
- * \param os Output stream.
- * \param f  ValueFormatter.
- * \return Output stream.
+ * \return \c true if formatting of \ref l() is deferred.
+ *
+ * \sa set_deferred_enabled()
  *
  */
-template<class U>
-std::ostream& operator<<(
-    std::ostream& os, const ValueFormatter<std::vector<U>>& f) noexcept {
-    return f.sequence(os);
+inline bool is_deferred_enabled() noexcept {
+    return internal::config().deferred.load(std::memory_order_relaxed);
 }
 
 /**
- * \brief Format std::deque.
+ * \brief Set destination of logging output.
  *
- * \tparam U Value type.
- * \param os Output stream.
- * \param f  ValueFormatter.
- * \return Output stream.
+ * Used as:
+ * \code
+ * gl::set_sink(std::make_shared<gl::BufferedFileSink>("log.txt"));
+ * \endcode
+ * to log to file without affecting std::cout.
+ *
+ * \param s Sink. \c nullptr means std::cout.
+ *
+ * \note Defaults to an OstreamSink writing to std::cout.
+ * \note Queued asynchronous messages are written to the previous sink first.
+ *
+ * \warning Must not be called while other threads log.
+ *
+ * \sa get_sink() \sa Sink
  *
  */
-template<class U>
-std::ostream& operator<<(
-    std::ostream& os, const ValueFormatter<std::deque<U>>& f) noexcept {
-    return f.sequence(os);
+inline void set_sink(std::shared_ptr<Sink> s) {
+    if (!s) {
+        s = std::make_shared<OstreamSink>(std::cout);
+    }
+
+    // Write queued messages to previous sink
+    bool async = is_async_enabled();
+    if (async) {
+        set_async_enabled(false);
+    }
+    {
+        std::lock_guard<std::mutex> lock(internal::flush_timer().get_mutex());
+        internal::flush_policy().flush(internal::sink_holder().sink());
+        internal::sink_holder().set(std::move(s));
+    }
+    internal::update_level_gate();
+    // Announce call sites again in binary output of new sink
+    internal::binary_session().fetch_add(1);
+
+    if (async) {
+        set_async_enabled(true);
+    }
 }
 
 /**
- * \brief Format std::forward_list.
  *
- * \tparam U Value type.
- * \param os Output stream.
- * \param f  ValueFormatter.
- * \return Output stream.
+ * \return Destination of logging output.
+ *
+ * \sa set_sink()
  *
  */
-template<class U>
-std::ostream& operator<<(
-    std::ostream& os, const ValueFormatter<std::forward_list<U>>& f) noexcept {
-    return f.sequence(os);
+inline std::shared_ptr<Sink> get_sink() {
+    return internal::sink_holder().get();
 }
 
 /**
- * \brief Format std::list.
+ * \brief Also write logging output to another sink, with prefixes and color
+ * of its own.
  *
- * \tparam U Value type.
- * \param os Output stream.
- * \param f  ValueFormatter.
- * \return Output stream.
+ * Used as:
+ * \code
+ * gl::add_sink(std::make_shared<gl::BufferedFileSink>("log.txt"),
+ *     gl::prefix::TIME | gl::prefix::FILE | gl::prefix::LINE);
+ * \endcode
+ * to keep short messages on std::cout, and a detailed log in a file.
+ *
+ * Each added sink has a writer thread of its own, so a slow sink delays
+ * neither logging threads nor other sinks. The message is formatted once,
+ * and each writer only adds its prefixes and color.
+ *
+ * \param s     Sink.
+ * \param p     Prefixes of messages written to \p s.
+ * \param color \c true if messages written to \p s are colored.
+ *
+ * \note The main sink set by set_sink() keeps the settings of
+ * set_prefixes() and set_color_enabled().
+ * \note prefix::TYPE_NAME follows set_prefixes(), since it is part of the
+ * message.
+ * \note The queue capacity and overflow policy are those of
+ * set_async_capacity() and set_async_overflow() when the sink is added.
+ * \note Output of a format other than format::TEXT is written unchanged.
+ * \note Formatting isn't deferred while sinks are added, see
+ * set_deferred_enabled().
+ *
+ * \warning Must not be called while other threads log.
+ *
+ * \sa remove_sink() \sa set_sink()
  *
  */
-template<class U>
-std::ostream& operator<<(
-    std::ostream& os, const ValueFormatter<std::list<U>>& f) noexcept {
-    return f.sequence(os);
+inline void add_sink(std::shared_ptr<Sink> s, prefix p, bool color = false) {
+    if (!s) {
+        return;
+    }
+    internal::register_flush_at_exit();
+
+    std::unique_ptr<internal::AddedSink> a(
+        new internal::AddedSink(std::move(s), p, color));
+    a->writer.set_capacity(internal::async_writer().get_capacity());
+    a->writer.set_overflow(internal::async_writer().get_overflow());
+    a->writer.start();
+    internal::added_sinks().push_back(std::move(a));
+
+    internal::config().fanout.store(true, std::memory_order_relaxed);
+    internal::update_level_gate();
+    // Announce call sites again in binary output
+    internal::binary_session().fetch_add(1);
 }
 
 /**
- * \brief Format std::set.
+ * \brief Stop writing logging output to a sink added by add_sink().
  *
- * \tparam U Value type.
- * \param os Output stream.
- * \param f  ValueFormatter.
- * \return Output stream.
+ * Queued messages are written to the sink, and it is flushed.
+ *
+ * \param s Sink.
+ *
+ * \warning Must not be called while other threads log.
+ *
+ * \sa add_sink()
  *
  */
-template<class U>
-std::ostream& operator<<(
-    std::ostream& os, const ValueFormatter<std::set<U>>& f) noexcept {
-    return f.sequence(os);
+inline void remove_sink(const std::shared_ptr<Sink>& s) {
+    auto& sinks = internal::added_sinks();
+    for (auto it = sinks.begin(); it != sinks.end(); ++it) {
+        if ((*it)->sink == s) {
+            (*it)->writer.stop();
+            (*it)->sink->flush();
+            sinks.erase(it);
+            break;
+        }
+    }
+
+    internal::config().fanout.store(!sinks.empty(), std::memory_order_relaxed);
+    internal::update_level_gate();
 }
 
 /**
- * \brief Format std::map.
+ * \brief Write all logging output so far, and flush the sink.
  *
- * \tparam U Key type.
- * \tparam V Value type.
- * \param os Output stream.
- * \param f  ValueFormatter.
- * \return Output stream.
+ * Waits until messages queued for asynchronous output are written.
+ *
+ * \sa set_flush_bytes() \sa set_flush_interval()
  *
  */
-template<class U, class V>
-std::ostream& operator<<(
-    std::ostream& os, const ValueFormatter<std::map<U, V>>& f) noexcept {
-    return f.map(os);
+inline void flush() {
+    internal::flush_all();
 }
 
 /**
- * \brief Format std::multiset.
+ * \brief Flush the sink once this many bytes were written since the last
+ * flush.
  *
- * \tparam U Value type.
- * \param os Output stream.
- * \param f  ValueFormatter.
- * \return Output stream.
+ * Together with set_flush_interval(), this batches flushes of many
+ * messages. Output is then almost as durable as with one flush per message,
+ * at almost the cost of none.
+ *
+ * \param n Number of bytes, or 0 for no limit.
+ *
+ * \note Defaults to 0.
+ * \note While neither this nor set_flush_interval() is set, asynchronous
+ * output is flushed after each batch, and synchronous output only when a
+ * message asks for it, see GL_NEWLINE.
+ * \note Output is also flushed at exit.
+ *
+ * \sa get_flush_bytes() \sa set_flush_interval() \sa flush()
  *
  */
-template<class U>
-std::ostream& operator<<(
-    std::ostream& os, const ValueFormatter<std::multiset<U>>& f) noexcept {
-    return f.sequence(os);
+inline void set_flush_bytes(size_t n) {
+    internal::register_flush_at_exit();
+    internal::flush_policy().set_bytes(n);
 }
 
 /**
- * \brief Format std::multimap.
  *
- * \tparam U Key type.
- * \tparam V Value type.
- * \param os Output stream.
- * \param f  ValueFormatter.
- * \return Output stream.
+ * \return Number of bytes after which the sink is flushed, or 0 for no
+ * limit.
+ *
+ * \sa set_flush_bytes()
  *
  */
-template<class U, class V>
-std::ostream& operator<<(
-    std::ostream& os, const ValueFormatter<std::multimap<U, V>>& f) noexcept {
-    return f.map(os);
+inline size_t get_flush_bytes() noexcept {
+    return internal::flush_policy().get_bytes();
 }
 
 /**
- * \brief Format std::unordered_set.
+ * \brief Flush the sink at most this long after output was written to it.
  *
- * \tparam U Value type.
- * \param os Output stream.
- * \param f  ValueFormatter.
- * \return Output stream.
+ * A background thread flushes output that has waited for the interval.
+ * For example:
+ * \code
+ * gl::set_flush_bytes(64 * 1024);
+ * gl::set_flush_interval(5);
+ * \endcode
+ * flushes when 64 KiB are pending, or output is 5 ms old.
+ *
+ * \param ms Interval in milliseconds, or 0 for no limit.
+ *
+ * \note Defaults to 0.
+ * \note Output is also flushed at exit.
+ *
+ * \sa get_flush_interval() \sa set_flush_bytes() \sa flush()
  *
  */
-template<class U>
-std::ostream& operator<<(
-    std::ostream& os, const ValueFormatter<std::unordered_set<U>>& f) noexcept {
-    return f.sequence(os);
+inline void set_flush_interval(int64_t ms) {
+    internal::register_flush_at_exit();
+    internal::flush_policy().set_interval(ms);
+    if (ms > 0) {
+        internal::flush_timer().start();
+    } else {
+        internal::flush_timer().stop();
+    }
 }
 
 /**
- * \brief Format std::unordered_map.
  *
- * \tparam U Key type.
- * \tparam V Value type.
- * \param os Output stream.
- * \param f  ValueFormatter.
- * \return Output stream.
+ * \return Milliseconds after which output is flushed, or 0 for no limit.
+ *
+ * \sa set_flush_interval()
  *
  */
-template<class U, class V>
-std::ostream& operator<<(std::ostream&              os,
-    const ValueFormatter<std::unordered_map<U, V>>& f) noexcept {
-    return f.map(os);
+inline int64_t get_flush_interval() noexcept {
+    return internal::flush_policy().get_interval();
 }
 
 /**
- * \brief Format std::unordered_multiset.
+ * \brief Enable or disable flushing the sink when the process crashes.
  *
- * \tparam U Value type.
- * \param os Output stream.
- * \param f  ValueFormatter.
- * \return Output stream.
+ * When enabled, handlers of SIGABRT, SIGSEGV, SIGFPE, SIGILL and, where
+ * available, SIGBUS flush the sink. They then restore the previous handler
+ * and raise the signal again.
+ *
+ * \param e \c true if the sink shall be flushed on crashes.
+ *
+ * \note Defaults to disabled.
+ * \note Best effort. Flushing isn't async signal safe, and messages still
+ * queued for asynchronous output are lost.
+ *
+ * \sa is_crash_flush_enabled() \sa flush()
  *
  */
-template<class U>
-std::ostream& operator<<(std::ostream&                os,
-    const ValueFormatter<std::unordered_multiset<U>>& f) noexcept {
-    return f.sequence(os);
+inline void set_crash_flush_enabled(bool e) {
+    internal::CrashHandlers&    h = internal::crash_handlers();
+    std::lock_guard<std::mutex> lock(h.mutex);
+    if (e == h.installed) {
+        return;
+    }
+    for (size_t i = 0; i < internal::CrashHandlers::count; ++i) {
+        const int sig = internal::CrashHandlers::signals()[i];
+        if (e) {
+            h.previous[i] = std::signal(sig, &internal::crash_handler);
+        } else {
+            std::signal(sig, h.previous[i]);
+        }
+    }
+    h.installed = e;
 }
 
 /**
- * \brief Format std::unordered_multimap.
  *
- * \tparam U Key type.
- * \tparam V Value type.
- * \param os Output stream.
- * \param f  ValueFormatter.
- * \return Output stream.
+ * \return \c true if the sink is flushed when the process crashes.
+ *
+ * \sa set_crash_flush_enabled()
  *
  */
-template<class U, class V>
-std::ostream& operator<<(std::ostream&                   os,
-    const ValueFormatter<std::unordered_multimap<U, V>>& f) noexcept {
-    return f.map(os);
+inline bool is_crash_flush_enabled() {
+    internal::CrashHandlers&    h = internal::crash_handlers();
+    std::lock_guard<std::mutex> lock(h.mutex);
+    return h.installed;
 }
 
 /**
- * \brief Format std::stack.
+ * \brief Set format of logging output.
  *
- * \tparam U Value type.
- * \param os Output stream.
- * \param f  ValueFormatter.
- * \return Output stream.
+ * In format::BINARY, \ref l() writes a record of a call site id, a timestamp,
+ * the thread id and the raw bytes of each variable. Only variables of other
+ * types than arithmetic types, C strings and std::string are formatted when
+ * logged. \ref l_arr() and \ref l_mat() are formatted when logged. The
+ * first record of each call site is preceded by a description of the call
+ * site. Render the output as text with decode_binary().
+ *
+ * In format::JSON, each message is one JSON object on a line of its own:
+ * \code
+ * {"file":"main.cpp","line":12,"values":{"i":1,"s":"s"}}
+ * \endcode
+ * In format::CSV, each message is one row of the file, line, function, time
+ * and thread prefixes that are enabled, followed by the name and value of
+ * each variable:
+ * \code
+ * main.cpp,12,i,1,s,s
+ * \endcode
+ * Integers, bool and finite floating point values are written as numbers
+ * and literals. Other values are formatted like in format::TEXT and written
+ * as strings, so that e.g. a container is "{1, 2}".
+ *
+ * \param f Format.
+ *
+ * \note Defaults to format::TEXT.
+ * \note Binary output is in native byte order, and GL_NEWLINE doesn't apply.
+ * \note prefix::TYPE_NAME and color don't apply to format::JSON and
+ * format::CSV.
+ *
+ * \warning Must not be called while other threads log.
+ *
+ * \sa get_format() \sa decode_binary()
  *
  */
-template<class U>
-std::ostream& operator<<(
-    std::ostream& os, const ValueFormatter<std::stack<U>>& f) noexcept {
-    return f.stack(os);
+inline void set_format(format f) noexcept {
+    internal::config().format.store(
+        static_cast<uint32_t>(f), std::memory_order_relaxed);
+    internal::binary_session().fetch_add(1);
+    internal::update_plain_text();
 }
 
 /**
- * \brief Format std::queue.
  *
- * \tparam U Value type.
- * \param os Output stream.
- * \param f  ValueFormatter.
- * \return Output stream.
+ * \return Format of logging output.
+ *
+ * \sa set_format()
  *
  */
-template<class U>
-std::ostream& operator<<(
-    std::ostream& os, const ValueFormatter<std::queue<U>>& f) noexcept {
-    return f.queue(os);
+inline format get_format() noexcept {
+    return static_cast<format>(
+        internal::config().format.load(std::memory_order_relaxed));
 }
 
 /**
- * \brief Format std::priority_queue.
+ * \brief Set formatting of float and double values.
  *
- * \tparam U Value type.
- * \param os Output stream.
- * \param f  ValueFormatter.
- * \return Output stream.
+ * \param f Float format.
+ *
+ * Used as:
+ * \code
+ * gl::set_float_format(gl::float_format::ROUND_TRIP);
+ * l(0.1); // Logs 0.1
+ * l(1.0 / 3.0); // Logs 0.3333333333333333
+ * \endcode
+ *
+ * \note Defaults to float_format::DEFAULT.
+ *
+ * \sa get_float_format()
  *
  */
-template<class U>
-std::ostream& operator<<(std::ostream&            os,
-    const ValueFormatter<std::priority_queue<U>>& f) noexcept {
-    return f.stack(os);
+inline void set_float_format(float_format f) noexcept {
+    internal::config().floatFormat.store(
+        static_cast<uint32_t>(f), std::memory_order_relaxed);
 }
 
 /**
- * \brief Write ANSI color start code to stream, if color is enabled.
  *
- * \param os Output stream.
- * \return Output stream.
+ * \return Formatting of float and double values.
+ *
+ * \sa set_float_format()
  *
  */
-std::ostream& color_start(std::ostream& os) noexcept {
-    if (colorEnabled) {
-        // Red
-        os << "\033[0;31m";
-    }
-    return os;
+inline float_format get_float_format() noexcept {
+    return static_cast<float_format>(
+        internal::config().floatFormat.load(std::memory_order_relaxed));
 }
 
 /**
- * \brief Write ANSI color end code to stream, if color is enabled.
+ * \brief Set maximum number of elements of containers, arrays and matrices
+ * to output. Longer ones are shortened as set by set_truncation().
  *
- * \param os Output stream.
- * \return Output stream.
+ * \param n Maximum number of elements, or 0 for all.
+ *
+ * Used as:
+ * \code
+ * gl::set_max_elements(4);
+ * std::vector<int> v(100);
+ * std::iota(v.begin(), v.end(), 0);
+ * l(v); // Logs v = {0, 1, ... (96 more), 98, 99}
+ * \endcode
+ *
+ * \note Defaults to 0.
+ * \note Stacks and queues only ever output their first and last element.
+ *
+ * \sa get_max_elements() \sa l_arr_n() \sa l_mat_n()
  *
  */
-std::ostream& color_end(std::ostream& os) noexcept {
-    if (colorEnabled) {
-        os << "\033[0m";
-    }
-    return os;
+inline void set_max_elements(size_t n) noexcept {
+    internal::config().maxElements.store(n, std::memory_order_relaxed);
 }
 
 /**
- * \brief Variable type formatter.
  *
- * \tparam T Variable type.
- * \param os Output stream.
- * \return Output stream.
+ * \return Maximum number of elements of containers, arrays and matrices to
+ * output, or 0 for all.
+ *
+ * \sa set_max_elements()
+ *
  */
-template<class T>
-std::ostream& type_name(std::ostream& os) {
-    if ((curPrefixes & prefix::TYPE_NAME) == prefix::TYPE_NAME) {
-        const char* tn     = typeid(T).name();
-        const char* output = nullptr;
-#ifndef __GNUC__
-        output = tn;
-#else
-        output = demangler.demangle(tn);
-#endif // __GNUC__
-
-        os << output << ' ';
-    }
-    return os;
+inline size_t get_max_elements() noexcept {
+    return internal::config().maxElements.load(std::memory_order_relaxed);
 }
 
 /**
- * \brief Array.
+ * \brief Set how to shorten containers, arrays and matrices with more
+ * elements than set_max_elements().
  *
- * \tparam T Value type.
+ * \param t Truncation.
+ *
+ * Used as:
+ * \code
+ * gl::set_max_elements(4);
+ * gl::set_truncation(gl::truncation::SUMMARIZE);
+ * std::vector<int> v(100);
+ * std::iota(v.begin(), v.end(), 0);
+ * l(v); // Logs v = {100 values, min = 0, max = 99, mean = 49.5}
+ * \endcode
+ *
+ * \note Defaults to truncation::ELIDE.
+ *
+ * \sa get_truncation()
  *
  */
-template<class T>
-class Array {
-  public:
-    /**
-     * \brief Constructor.
-     *
-     * \param name      Name.
-     * \param val       Values [\p len].
-     * \param len       Number of values.
-     * \param prefixFmt PrefixFormatter.
-     *
-     */
-    explicit Array(const char* name, T& val, size_t len,
-        const PrefixFormatter& prefixFmt) noexcept :
-        m_name(name),
-        m_val(val), m_len(len), m_prefixFmt(prefixFmt) {
-    }
-
-    template<class U>
-    friend std::ostream& operator<<(
-        std::ostream& os, const Array<U>& a) noexcept;
-
-    /**
-     * \return Name.
-     */
-    const char* get_name() const noexcept {
-        return m_name;
-    }
-
-    /**
-     * \return Values.
-     */
-    T& get_values() const noexcept {
-        return m_val;
-    }
-
-    /**
-     * \return Number of values.
-     */
-    size_t get_number_of_values() const noexcept {
-        return m_len;
-    }
-
-    /**
-     * \return PrefixFormatter.
-     */
-    const PrefixFormatter& get_prefix_formatter() const noexcept {
-        return m_prefixFmt;
-    }
-
-  private:
-    const char*            m_name;      /**< Name. */
-    T&                     m_val;       /**< Values. */
-    const size_t           m_len;       /**< Number of values. */
-    const PrefixFormatter& m_prefixFmt; /**< PrefixFormatter. */
-};
+inline void set_truncation(truncation t) noexcept {
+    internal::config().truncation.store(
+        static_cast<uint32_t>(t), std::memory_order_relaxed);
+}
 
 /**
- * \brief Write Array to stream.
  *
- * \tparam U Value type.
- * \param os Output stream.
- * \param a  Array.
- * \return Output stream.
+ * \return How to shorten containers, arrays and matrices.
+ *
+ * \sa set_truncation()
  *
  */
-template<class U>
-std::ostream& operator<<(std::ostream& os, const Array<U>& a) noexcept {
-    if (outputEnabled) {
-        os << color_start << a.get_prefix_formatter()
-           << type_name<U> << a.get_name() << " = {";
-        // Print first object without comma
-        if (a.get_number_of_values() > 0) {
-            os << format_value(a.get_values()[0]);
-        }
-        // Print the rest
-        for (size_t i = 1; i < a.get_number_of_values(); ++i) {
-            os << ", " << format_value(a.get_values()[i]);
-        }
-        os << '}' << color_end << GL_NEWLINE;
-    }
-
-    return os;
+inline truncation get_truncation() noexcept {
+    return static_cast<truncation>(
+        internal::config().truncation.load(std::memory_order_relaxed));
 }
 
 /**
- * \brief Create array.
- *  This solves the error "cannot refer to class template 'Array' without a
- * template argument list".
+ * \brief Set formatting of \ref l_mat() and \ref l_mat_flat().
  *
- * \tparam T Value type.
- * \param name      Name.
- * \param val       Values.
- * \param len       Number of values.
- * \param prefixFmt PrefixFormatter.
- * \return Array.
+ * \param f Matrix format.
+ *
+ * Used as:
+ * \code
+ * gl::set_matrix_format(gl::matrix_format::GRID);
+ * int m[2][3] = {{1, 2, 3}, {4, 5, 6}};
+ * l_mat(m, 3, 2);
+ * \endcode
+ *
+ * Which outputs:
+ * \code
+ * m: 2 x 3
+ * 1 2 3
+ * 4 5 6
+ * \endcode
+ *
+ * \note Defaults to matrix_format::INDEXED.
+ * \note matrix_format::GRID leaves out rows in the middle of matrices with
+ * more elements than set_max_elements().
+ *
+ * \sa get_matrix_format()
  *
  */
-template<class T>
-Array<T> make_array(
-    const char* name, T& val, size_t len, const PrefixFormatter& prefixFmt) {
-    return Array<T>(name, val, len, prefixFmt);
-};
+inline void set_matrix_format(matrix_format f) noexcept {
+    internal::config().matrixFormat.store(
+        static_cast<uint32_t>(f), std::memory_order_relaxed);
+}
 
 /**
- * \brief Matrix.
  *
- * \tparam T Value type.
+ * \return Formatting of matrices.
+ *
+ * \sa set_matrix_format()
  *
  */
-template<class T>
-class Matrix {
-  public:
-    /**
-     * \brief Constructor.
-     *
-     * \param name      Name.
-     * \param val       Values [\p cols x \p rows].
-     * \param cols      Number of columns.
-     * \param rows      Number of rows.
-     * \param prefixFmt PrefixFormatter.
-     *
-     */
-    explicit Matrix(const char* name, T& val, size_t cols, size_t rows,
-        const PrefixFormatter& prefixFmt) noexcept :
-        m_name(name),
-        m_val(val), m_cols(cols), m_rows(rows), m_prefixFmt(prefixFmt) {
-    }
-
-    template<class U>
-    friend std::ostream& operator<<(
-        std::ostream& os, const Matrix<U>& a) noexcept;
-
-    /**
-     * \return Name.
-     */
-    const char* get_name() const noexcept {
-        return m_name;
-    }
-
-    /**
-     * \return Values.
-     */
-    T& get_values() const noexcept {
-        return m_val;
-    }
-
-    /**
-     * \return Number of columns.
-     */
-    size_t get_number_of_columns() const noexcept {
-        return m_cols;
-    }
-
-    /**
-     * \return Number of rows.
-     */
-    size_t get_number_of_rows() const noexcept {
-        return m_rows;
-    }
-
-    /**
-     * \return PrefixFormatter.
-     */
-    const PrefixFormatter& get_prefix_formatter() const noexcept {
-        return m_prefixFmt;
-    }
+inline matrix_format get_matrix_format() noexcept {
+    return static_cast<matrix_format>(
+        internal::config().matrixFormat.load(std::memory_order_relaxed));
+}
 
-  private:
-    const char*            m_name;      /**< Name. */
-    T&                     m_val;       /**< Values. */
-    const size_t           m_cols;      /**< Number of columns. */
-    const size_t           m_rows;      /**< Number of rows. */
-    const PrefixFormatter& m_prefixFmt; /**< PrefixFormatter. */
-};
+/**
+ * \brief Set number of bytes per line of \ref l_hex().
+ *
+ * \param w Bytes per line. 0 is treated as 16, and more than 64 as 64.
+ *
+ * \note Defaults to 16, as "hexdump -C".
+ *
+ * \sa get_hex_width() \sa l_hex()
+ *
+ */
+inline void set_hex_width(size_t w) noexcept {
+    internal::config().hexWidth.store(w, std::memory_order_relaxed);
+}
 
 /**
- * \brief Write Matrix to stream.
  *
- * \tparam U Value type.
- * \param os Output stream.
- * \param m  Matrix.
- * \return Output stream.
+ * \return Number of bytes per line of \ref l_hex().
+ *
+ * \sa set_hex_width()
  *
  */
-template<class U>
-std::ostream& operator<<(std::ostream& os, const Matrix<U>& m) noexcept {
-    if (outputEnabled) {
-        os << color_start << m.get_prefix_formatter()
-           << type_name<U> << m.get_name() << ": ";
-        if (m.get_number_of_columns() <= 0 || m.get_number_of_rows() <= 0) {
-            os << "{}";
-        } else {
-            os << "[0,0] = " << format_value(m.get_values()[0][0]);
-            for (size_t j = 1; j < m.get_number_of_columns(); ++j) {
-                os << ", "
-                   << "[0," << j
-                   << "] = " << format_value(m.get_values()[0][j]);
-            }
-            for (size_t i = 1; i < m.get_number_of_rows(); ++i) {
-                for (size_t j = 0; j < m.get_number_of_columns(); ++j) {
-                    os << ", "
-                       << "[" << i << ',' << j
-                       << "] = " << format_value(m.get_values()[i][j]);
-                }
-            }
-        }
-        os << color_end << GL_NEWLINE;
-    }
+inline size_t get_hex_width() noexcept {
+    return internal::hex_width();
+}
 
-    return os;
+/**
+ * \brief Set maximum number of bytes that \ref l_hex() and \ref l_bytes()
+ * output. Bytes in the middle are left out of longer ones.
+ *
+ * \param n Maximum number of bytes, or 0 for all. \ref l_hex() leaves out
+ * whole lines, so may output up to a line more.
+ *
+ * \note Defaults to 0.
+ *
+ * \sa get_max_bytes() \sa set_max_elements()
+ *
+ */
+inline void set_max_bytes(size_t n) noexcept {
+    internal::config().maxBytes.store(n, std::memory_order_relaxed);
 }
 
 /**
- * \brief Create matrix.
- *  This solves the error "cannot refer to class template 'Matrix' without a
- * template argument list".
  *
- * \tparam T Value type.
- * \param name      Name.
- * \param val       Values.
- * \param cols      Number of columns.
- * \param rows      Number of rows.
- * \param prefixFmt PrefixFormatter.
+ * \return Maximum number of bytes that \ref l_hex() and \ref l_bytes()
+ * output, or 0 for all.
  *
- * \return New matrix.
+ * \sa set_max_bytes()
  *
  */
-template<class T>
-Matrix<T> make_matrix(const char* name, T& val, size_t cols, size_t rows,
-    const PrefixFormatter& prefixFmt) {
-    return Matrix<T>(name, val, cols, rows, prefixFmt);
-};
+inline size_t get_max_bytes() noexcept {
+    return internal::config().maxBytes.load(std::memory_order_relaxed);
+}
 
-} // namespace internal
+/**
+ * \brief Enable or disable reporting of suppressed messages.
+ *
+ * When enabled, a message of \ref l_every_n(), \ref l_every_ms() or
+ * \ref l_when() that follows suppressed messages ends with their number:
+ * \code
+ * i = 5 (4 suppressed)
+ * \endcode
+ *
+ * \param e \c true if suppressed messages shall be reported.
+ *
+ * \note Defaults to disabled.
+ * \note Not reported in format::BINARY.
+ *
+ * \sa is_suppressed_summary_enabled()
+ *
+ */
+inline void set_suppressed_summary_enabled(bool e) noexcept {
+    internal::config().suppressedSummary.store(e, std::memory_order_relaxed);
+}
 
-#endif // DOXYGEN_HIDDEN
+/**
+ *
+ * \return \c true if suppressed messages are reported.
+ *
+ * \sa set_suppressed_summary_enabled()
+ *
+ */
+inline bool is_suppressed_summary_enabled() noexcept {
+    return internal::config().suppressedSummary.load(std::memory_order_relaxed);
+}
 
 /**
+ * \brief Enable or disable output of previous values by \ref l_changed().
  *
- * \return Bitwise \c or of prefix settings.
+ * When enabled, each variable that changed is output with its value in the
+ * previous message of the call site:
+ * \code
+ * state = 1 -> 2, tick = 7
+ * \endcode
  *
- * \sa prefix \sa set_prefixes()
+ * \param e \c true if previous values shall be output.
+ *
+ * \note Defaults to disabled.
+ * \note Only in format::TEXT, and not if formatting is deferred.
+ * \note Formatted values are only kept while enabled. Otherwise changes
+ * are detected by a hash of the values alone, so the first message after
+ * enabling has no previous values.
+ *
+ * \sa is_previous_values_enabled() \sa l_changed()
  *
  */
-prefix get_prefixes() noexcept {
-    return internal::curPrefixes;
+inline void set_previous_values_enabled(bool e) noexcept {
+    internal::config().previousValues.store(e, std::memory_order_relaxed);
 }
 
 /**
- * \brief Set prefixes of logging output.
  *
- * Alters the output of \ref l(), \ref l_arr(), and \ref l_mat().
+ * \return \c true if \ref l_changed() outputs previous values.
  *
- * \param p Bitwise \c or of prefix settings.
+ * \sa set_previous_values_enabled()
+ *
+ */
+inline bool is_previous_values_enabled() noexcept {
+    return internal::config().previousValues.load(std::memory_order_relaxed);
+}
+
+/**
+ * \brief Log a summary of each l_timer() call site that has been called
+ * since its previous summary, and start over.
  *
  * Used as:
  * \code
- * gl::set_prefixes(gl::prefix::FILE | gl::prefix::LINE);
+ * for (const Request& r : requests) {
+ *     l_timer("handle", 0);
+ *     handle(r);
+ * }
+ * gl::log_timers();
  * \endcode
- * to also log current file and line number.
  *
- * \note Defaults to prefix::FILE | prefix::LINE.
+ * \note Call sites are listed the latest first called first. Summaries of a
+ * call site that isn't selected by set_filter() are discarded.
  *
- * \sa prefix \sa get_prefixes()
+ * \sa l_timer()
  *
  */
-void set_prefixes(prefix p) noexcept {
-    internal::curPrefixes = p;
+inline void log_timers() {
+    if (!internal::is_level_enabled(GL_LEVEL_OFF)) {
+        return;
+    }
+    internal::Timer* t =
+        internal::timer_list().load(std::memory_order_acquire);
+    for (; t != nullptr; t = t->get_next()) {
+        internal::write_summary(*t);
+    }
 }
 
 /**
+ * \brief Enable or disable counting of logging.
  *
- * \return \c true if output is enabled.
+ * When enabled, each logging message counts its call site, bytes of output
+ * and the time spent on it. Counters are kept per thread and only summed by
+ * get_stats().
  *
- * \sa set_output_enabled()
+ * \param e \c true if logging shall be counted.
+ *
+ * \note Defaults to disabled.
+ * \note Time includes evaluation of the logged expressions, but not of
+ * output from the asynchronous thread.
+ *
+ * \sa is_stats_enabled() \sa get_stats() \sa write_stats()
  *
  */
-bool is_output_enabled() noexcept {
-    return internal::outputEnabled;
+inline void set_stats_enabled(bool e) noexcept {
+    internal::config().statsEnabled.store(e, std::memory_order_relaxed);
 }
 
 /**
- * \brief Enable or disable output.
  *
- * \param e \c true if output shall be enabled.
+ * \return \c true if logging is counted.
  *
- * \note Defaults to enabled.
+ * \sa set_stats_enabled()
  *
- * \sa is_output_enabled()
+ */
+inline bool is_stats_enabled() noexcept {
+    return internal::is_stats_enabled();
+}
+
+/**
+ * \brief Sum counters of all threads and call sites.
+ *
+ * \return Counters since start of program, while counting was enabled.
+ * Counters of threads that are logging at the same time may be slightly
+ * behind.
+ *
+ * \sa set_stats_enabled() \sa write_stats()
  *
  */
-void set_output_enabled(bool e) noexcept {
-    internal::outputEnabled = e;
+inline Stats get_stats() {
+    Stats st;
+    for (const internal::ThreadStats* t =
+             internal::thread_owned_list<internal::ThreadStats>().load(
+                 std::memory_order_acquire);
+         t != nullptr; t = t->next) {
+        st.calls += t->calls.load(std::memory_order_relaxed);
+        st.bytes += t->bytes.load(std::memory_order_relaxed);
+        st.suppressed += t->suppressed.load(std::memory_order_relaxed);
+        st.nanoseconds += t->nanoseconds.load(std::memory_order_relaxed);
+        st.maxNanoseconds = std::max(st.maxNanoseconds,
+            t->maxNanoseconds.load(std::memory_order_relaxed));
+    }
+    st.dropped = internal::async_writer().get_dropped();
+
+    for (const internal::Site* s =
+             internal::site_list().load(std::memory_order_acquire);
+         s != nullptr; s = s->get_next()) {
+        st.sites.push_back({s->get_file_name(), s->get_file_line_number(),
+            s->get_function_name(), s->get_calls(), s->get_bytes()});
+    }
+    std::stable_sort(st.sites.begin(), st.sites.end(),
+        [](const SiteStats& a, const SiteStats& b) {
+            return a.calls > b.calls;
+        });
+    return st;
 }
 
 /**
- * \brief Enable or disable ANSI color output.
+ * \brief Write counters and the most called call sites.
  *
- * \param e \c true if output shall be colored.
+ * Used as:
+ * \code
+ * gl::write_stats(std::cerr, 2);
+ * \endcode
+ * Which outputs, for example:
+ * \code
+ * calls = 1001, bytes = 9905, dropped = 0, suppressed = 0, ns = 312005,
+ * max ns = 5120
+ * main.cpp:12 loop(): calls = 1000, bytes = 9890
+ * main.cpp:20 main(): calls = 1, bytes = 15
+ * \endcode
+ * where the first two lines are one.
  *
- * \note Defaults to disabled.
+ * \param os  Output stream.
+ * \param top Maximum number of call sites.
  *
- * \sa is_color_enabled()
+ * \sa get_stats()
  *
  */
-void set_color_enabled(bool e) noexcept {
-    internal::colorEnabled = e;
+inline void write_stats(std::ostream& os, size_t top = 10) {
+    const Stats st = get_stats();
+    os << "calls = " << st.calls << ", bytes = " << st.bytes
+       << ", dropped = " << st.dropped << ", suppressed = " << st.suppressed
+       << ", ns = " << st.nanoseconds << ", max ns = " << st.maxNanoseconds
+       << '\n';
+    for (size_t i = 0; i < st.sites.size() && i < top; ++i) {
+        const SiteStats& s = st.sites[i];
+        os << s.file << ':' << s.line << ' ' << s.function
+           << "(): calls = " << s.calls << ", bytes = " << s.bytes << '\n';
+    }
 }
 
 /**
+ * \brief Render binary logging output as text.
  *
- * \return \c true if ANSI color output is enabled.
+ * Output is identical to what format::TEXT would have written, without
+ * color. Must run on a machine with the same byte order and type sizes as
+ * the one that logged.
  *
- * \sa set_color_enabled()
+ * \param in  Binary output, from start of a session.
+ * \param out Text output.
+ * \param p   Prefixes to render with.
+ * \throw std::runtime_error if \p in is malformed.
+ *
+ * \sa set_format()
  *
  */
-bool is_color_enabled() noexcept {
-    return internal::colorEnabled;
+inline void decode_binary(std::istream& in, std::ostream& out,
+    prefix p = prefix::FILE | prefix::LINE) {
+    std::unordered_map<uint32_t, internal::DecodedSite> sites;
+    const bool types = (p & prefix::TYPE_NAME) != prefix::NONE;
+    char       r     = '\0';
+    while (in.get(r)) {
+        if (r != static_cast<char>(internal::BinaryRecord::SITE) &&
+            r != static_cast<char>(internal::BinaryRecord::VALUES) &&
+            r != static_cast<char>(internal::BinaryRecord::TEXT)) {
+            throw std::runtime_error("Binary log: Unknown record");
+        }
+        uint32_t id = 0;
+        internal::read_raw(in, id);
+
+        // Call site
+        if (r == static_cast<char>(internal::BinaryRecord::SITE)) {
+            int64_t line = 0;
+            internal::read_raw(in, line);
+            std::string path = internal::read_string(in);
+            std::string func = internal::read_string(in);
+            uint32_t    n    = 0;
+            internal::read_raw(in, n);
+
+            internal::DecodedSite& d = sites[id];
+            d.text = internal::render_site(p,
+                internal::file_name(path.c_str(), path.c_str()),
+                static_cast<long>(line), func.c_str());
+            d.names.resize(n);
+            d.types.resize(n);
+            for (uint32_t i = 0; i < n; ++i) {
+                d.names[i] = internal::read_string(in);
+                d.types[i] = internal::read_string(in);
+            }
+            continue;
+        }
+
+        auto it = sites.find(id);
+        if (it == sites.end()) {
+            throw std::runtime_error("Binary log: Unknown call site");
+        }
+        const internal::DecodedSite& d = it->second;
+
+        // Prefix
+        char    fmt = '\0';
+        int64_t ns  = 0;
+        internal::read_raw(in, fmt);
+        internal::read_raw(in, ns);
+        std::string tid = internal::read_string(in);
+        internal::write_prefix(
+            out, d.text, p, static_cast<time_format>(fmt), ns, tid);
+
+        // Values
+        if (r == static_cast<char>(internal::BinaryRecord::TEXT)) {
+            if (types && !d.types.empty()) {
+                out << d.types[0] << ' ';
+            }
+            out << internal::read_string(in);
+        } else {
+            for (size_t i = 0; i < d.names.size(); ++i) {
+                if (i != 0) {
+                    out << ", ";
+                }
+                if (types) {
+                    out << d.types[i] << ' ';
+                }
+                out << d.names[i] << " = ";
+                internal::decode_value(in, out);
+            }
+        }
+        out << '\n';
+    }
 }
 
 #ifndef DOXYGEN_HIDDEN
 
 /**
- * \brief Helper function for l(). Dispatch to the right macro depending on
- * number of arguments.
- *
+ * \brief Level of \ref l(), \ref l_arr() and \ref l_mat(). Passes unless
+ * output is disabled.
  */
-#define GL_INTERNAL_L_DISPATCH(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, \
-    _12, _13, _14, _15, _16, NAME, ...)                                      \
-    NAME
+#define GL_INTERNAL_LEVEL_ALWAYS GL_LEVEL_OFF
 
 /**
- * \brief Output variable name and value. */
-#define GL_INTERNAL_LX(v)                                 \
-    gl::internal::type_name<decltype(v)> << (#v) << " = " \
-                                         << ::gl::internal::format_value((v))
+ * \brief Call site of variables, and skip the message unless the call site is
+ * selected by set_filter(). */
+#define GL_INTERNAL_L_SITE(...)                      \
+    static ::gl::internal::Site gl_internal_site(    \
+        __FILE__, __LINE__, __func__, #__VA_ARGS__); \
+    if (!gl_internal_site.is_selected()) {           \
+        break;                                       \
+    }
 
-#define GL_INTERNAL_L1(v1) GL_INTERNAL_LX(v1)
+/**
+ * \brief Log variables of gl_internal_site, once the message is known to
+ * pass. Followed by the number of suppressed messages, if any. */
+#define GL_INTERNAL_L_PASSED(suppressed, ...)                                \
+    ::gl::internal::StatsScope gl_internal_stats(gl_internal_site);          \
+    if (GL_UNLIKELY(!::gl::internal::is_plain_text())) {                     \
+        ::gl::internal::write_record(                                        \
+            gl_internal_site, suppressed, __VA_ARGS__);                      \
+        break;                                                               \
+    }                                                                        \
+    ::gl::internal::write_variables(::gl::internal::Line().stream()          \
+                                        << gl::internal::color_start         \
+                                        << gl::internal::PrefixFormatter(    \
+                                               gl_internal_site),            \
+        gl_internal_site, __VA_ARGS__)                                       \
+        << ::gl::internal::Suppressed{suppressed} << gl::internal::color_end \
+        << (GL_NEWLINE);
 
-#define GL_INTERNAL_L2(v1, v2) GL_INTERNAL_L1(v1) << ", " << GL_INTERNAL_LX(v2)
+/**
+ * \brief Log variables at a level. */
+#define GL_INTERNAL_L(lvl, ...)                      \
+    do {                                             \
+        if (::gl::internal::is_level_enabled(lvl)) { \
+            GL_INTERNAL_L_SITE(__VA_ARGS__)          \
+            GL_INTERNAL_L_PASSED(0, __VA_ARGS__)     \
+        }                                            \
+    } while (false)
 
-#define GL_INTERNAL_L3(v1, v2, v3) \
-    GL_INTERNAL_L2(v1, v2) << ", " << GL_INTERNAL_LX(v3)
+/**
+ * \brief Log variables if call site state passes the message.
+ *
+ * \param state Type of call site state, e.g. ::gl::internal::EveryN.
+ * \param args  Parenthesized arguments for state. */
+#define GL_INTERNAL_L_RATE(state, args, ...)                               \
+    do {                                                                   \
+        if (::gl::internal::is_level_enabled(GL_INTERNAL_LEVEL_ALWAYS)) {  \
+            GL_INTERNAL_L_SITE(__VA_ARGS__)                                \
+            static state   gl_internal_state;                              \
+            const uint64_t gl_internal_pass = gl_internal_state.pass args; \
+            if (gl_internal_pass != 0) {                                   \
+                GL_INTERNAL_L_PASSED(gl_internal_pass - 1, __VA_ARGS__)    \
+            } else {                                                       \
+                ::gl::internal::count_suppressed();                        \
+            }                                                              \
+        }                                                                  \
+    } while (false)
 
-#define GL_INTERNAL_L4(v1, v2, v3, v4) \
-    GL_INTERNAL_L3(v1, v2, v3) << ", " << GL_INTERNAL_LX(v4)
+/**
+ * \brief Log variables if they changed since the previous message of the
+ * call site. */
+#define GL_INTERNAL_L_CHANGED(...)                                        \
+    do {                                                                  \
+        if (::gl::internal::is_level_enabled(GL_INTERNAL_LEVEL_ALWAYS)) { \
+            GL_INTERNAL_L_SITE(__VA_ARGS__)                               \
+            static ::gl::internal::Changed gl_internal_state;             \
+            ::gl::internal::log_changed(                                  \
+                gl_internal_site, gl_internal_state, __VA_ARGS__);        \
+        }                                                                 \
+    } while (false)
 
-#define GL_INTERNAL_L5(v1, v2, v3, v4, v5) \
-    GL_INTERNAL_L4(v1, v2, v3, v4) << ", " << GL_INTERNAL_LX(v5)
+/**
+ * \brief Concatenate after expanding macros. */
+#define GL_INTERNAL_CAT(a, b) GL_INTERNAL_CAT_EXPANDED(a, b)
 
-#define GL_INTERNAL_L6(v1, v2, v3, v4, v5, v6) \
-    GL_INTERNAL_L5(v1, v2, v3, v4, v5) << ", " << GL_INTERNAL_LX(v6)
+/**
+ * \brief Concatenate. */
+#define GL_INTERNAL_CAT_EXPANDED(a, b) a##b
 
-#define GL_INTERNAL_L7(v1, v2, v3, v4, v5, v6, v7) \
-    GL_INTERNAL_L6(v1, v2, v3, v4, v5, v6) << ", " << GL_INTERNAL_LX(v7)
+/**
+ * \brief Measure the enclosing scope of an l_scope() or l_timer() call site.
+ *
+ * \param site  Call site.
+ * \param timer Timer, or nullptr.
+ * \param n     Calls per summary of \p timer. */
+#define GL_INTERNAL_L_SCOPE_AT(site, timer, n)                              \
+    ::gl::internal::Scope GL_INTERNAL_CAT(gl_internal_scope_, __LINE__)(    \
+        ::gl::internal::is_level_enabled(GL_INTERNAL_LEVEL_ALWAYS), (site), \
+        (timer), (n))
 
-#define GL_INTERNAL_L8(v1, v2, v3, v4, v5, v6, v7, v8) \
-    GL_INTERNAL_L7(v1, v2, v3, v4, v5, v6, v7) << ", " << GL_INTERNAL_LX(v8)
+/**
+ * \brief Log the time spent in the enclosing scope. */
+#define GL_INTERNAL_L_SCOPE(name, timer, n)                                   \
+    static ::gl::internal::Site GL_INTERNAL_CAT(gl_internal_site_, __LINE__)( \
+        __FILE__, __LINE__, __func__, name);                                  \
+    GL_INTERNAL_L_SCOPE_AT(                                                   \
+        GL_INTERNAL_CAT(gl_internal_site_, __LINE__), timer, n)
 
-#define GL_INTERNAL_L9(v1, v2, v3, v4, v5, v6, v7, v8, v9) \
-    GL_INTERNAL_L8(v1, v2, v3, v4, v5, v6, v7, v8) << ", " << GL_INTERNAL_LX(v9)
+/**
+ * \brief Count the time spent in the enclosing scope, and log a summary every
+ * \p n calls. */
+#define GL_INTERNAL_L_TIMER(name, n)                                          \
+    static ::gl::internal::Site GL_INTERNAL_CAT(gl_internal_site_, __LINE__)( \
+        __FILE__, __LINE__, __func__, name);                                  \
+    static ::gl::internal::Timer GL_INTERNAL_CAT(                             \
+        gl_internal_timer_, __LINE__)(                                        \
+        GL_INTERNAL_CAT(gl_internal_site_, __LINE__));                        \
+    GL_INTERNAL_L_SCOPE_AT(GL_INTERNAL_CAT(gl_internal_site_, __LINE__),      \
+        &GL_INTERNAL_CAT(gl_internal_timer_, __LINE__), (n))
 
-#define GL_INTERNAL_L10(v1, v2, v3, v4, v5, v6, v7, v8, v9, v10) \
-    GL_INTERNAL_L9(v1, v2, v3, v4, v5, v6, v7, v8, v9)           \
-        << ", " << GL_INTERNAL_LX(v10)
+/**
+ * \brief Log array at a level. */
+#define GL_INTERNAL_L_ARR(lvl, v, len) \
+    GL_INTERNAL_L_ARR_N(lvl, v, len, ::gl::get_max_elements())
 
-#define GL_INTERNAL_L11(v1, v2, v3, v4, v5, v6, v7, v8, v9, v10, v11) \
-    GL_INTERNAL_L10(v1, v2, v3, v4, v5, v6, v7, v8, v9, v10)          \
-        << ", " << GL_INTERNAL_LX(v11)
+/**
+ * \brief Log at most \p max elements of array at a level. */
+#define GL_INTERNAL_L_ARR_N(lvl, v, len, max)                                \
+    do {                                                                     \
+        if (::gl::internal::is_level_enabled(lvl)) {                         \
+            static ::gl::internal::Site gl_internal_site(                    \
+                __FILE__, __LINE__, __func__, #v);                           \
+            if (!gl_internal_site.is_selected()) {                           \
+                break;                                                       \
+            }                                                                \
+            ::gl::internal::StatsScope gl_internal_stats(gl_internal_site);  \
+            if (GL_UNLIKELY(!::gl::internal::is_plain_text())) {             \
+                ::gl::internal::write_record_text(gl_internal_site,          \
+                    ::gl::internal::make_array((#v), (v), (len), (max),      \
+                        ::gl::internal::PrefixFormatter(gl_internal_site))); \
+                break;                                                       \
+            }                                                                \
+            ::gl::internal::Line().stream()                                  \
+                << ::gl::internal::make_array((#v), (v), (len), (max),       \
+                       ::gl::internal::PrefixFormatter(gl_internal_site));   \
+        }                                                                    \
+    } while (false)
 
-#define GL_INTERNAL_L12(v1, v2, v3, v4, v5, v6, v7, v8, v9, v10, v11, v12) \
-    GL_INTERNAL_L11(v1, v2, v3, v4, v5, v6, v7, v8, v9, v10, v11)          \
-        << ", " << GL_INTERNAL_LX(v12)
+/**
+ * \brief Log bytes, as lines if \p dump is \c true. */
+#define GL_INTERNAL_L_BYTES(p, len, dump)                                    \
+    do {                                                                     \
+        if (::gl::internal::is_level_enabled(GL_INTERNAL_LEVEL_ALWAYS)) {    \
+            static ::gl::internal::Site gl_internal_site(                    \
+                __FILE__, __LINE__, __func__, #p);                           \
+            if (!gl_internal_site.is_selected()) {                           \
+                break;                                                       \
+            }                                                                \
+            ::gl::internal::StatsScope gl_internal_stats(gl_internal_site);  \
+            if (GL_UNLIKELY(!::gl::internal::is_plain_text())) {             \
+                ::gl::internal::write_record_text(gl_internal_site,          \
+                    ::gl::internal::Bytes((#p), (p), (len), (dump),          \
+                        ::gl::internal::PrefixFormatter(gl_internal_site))); \
+                break;                                                       \
+            }                                                                \
+            ::gl::internal::Line().stream() << ::gl::internal::Bytes((#p),   \
+                (p), (len), (dump),                                          \
+                ::gl::internal::PrefixFormatter(gl_internal_site));          \
+        }                                                                    \
+    } while (false)
 
-#define GL_INTERNAL_L13(                                               \
-    v1, v2, v3, v4, v5, v6, v7, v8, v9, v10, v11, v12, v13)            \
-    GL_INTERNAL_L12(v1, v2, v3, v4, v5, v6, v7, v8, v9, v10, v11, v12) \
-        << ", " << GL_INTERNAL_LX(v13)
+/**
+ * \brief Log matrix at a level. */
+#define GL_INTERNAL_L_MAT(lvl, m, cols, rows) \
+    GL_INTERNAL_L_MAT_N(lvl, m, cols, rows, ::gl::get_max_elements())
 
-#define GL_INTERNAL_L14(                                                    \
-    v1, v2, v3, v4, v5, v6, v7, v8, v9, v10, v11, v12, v13, v14)            \
-    GL_INTERNAL_L13(v1, v2, v3, v4, v5, v6, v7, v8, v9, v10, v11, v12, v13) \
-        << ", " << GL_INTERNAL_LX(v14)
+/**
+ * \brief Log at most \p max elements of matrix at a level. */
+#define GL_INTERNAL_L_MAT_N(lvl, m, cols, rows, max) \
+    GL_INTERNAL_L_MAT_NAMED(lvl, #m, m, cols, rows, max)
 
-#define GL_INTERNAL_L15(                                              \
-    v1, v2, v3, v4, v5, v6, v7, v8, v9, v10, v11, v12, v13, v14, v15) \
-    GL_INTERNAL_L14(                                                  \
-        v1, v2, v3, v4, v5, v6, v7, v8, v9, v10, v11, v12, v13, v14)  \
-        << ", " << GL_INTERNAL_LX(v15)
+/**
+ * \brief Log at most \p max elements of matrix with a name at a level. */
+#define GL_INTERNAL_L_MAT_NAMED(lvl, name, m, cols, rows, max)               \
+    do {                                                                     \
+        if (::gl::internal::is_level_enabled(lvl)) {                         \
+            static ::gl::internal::Site gl_internal_site(                    \
+                __FILE__, __LINE__, __func__, name);                         \
+            if (!gl_internal_site.is_selected()) {                           \
+                break;                                                       \
+            }                                                                \
+            ::gl::internal::StatsScope gl_internal_stats(gl_internal_site);  \
+            if (GL_UNLIKELY(!::gl::internal::is_plain_text())) {             \
+                ::gl::internal::write_record_text(gl_internal_site,          \
+                    ::gl::internal::make_matrix((name), (m), (cols), (rows), \
+                        (max),                                               \
+                        ::gl::internal::PrefixFormatter(gl_internal_site))); \
+                break;                                                       \
+            }                                                                \
+            ::gl::internal::Line().stream()                                  \
+                << ::gl::internal::make_matrix((name), (m), (cols), (rows),  \
+                       (max),                                                \
+                       ::gl::internal::PrefixFormatter(gl_internal_site));   \
+        }                                                                    \
+    } while (false)
 
-#define GL_INTERNAL_L16(                                                   \
-    v1, v2, v3, v4, v5, v6, v7, v8, v9, v10, v11, v12, v13, v14, v15, v16) \
-    GL_INTERNAL_L15(                                                       \
-        v1, v2, v3, v4, v5, v6, v7, v8, v9, v10, v11, v12, v13, v14, v15)  \
-        << ", " << GL_INTERNAL_LX(v16)
+/**
+ * \brief Log matrix in a flat buffer at a level. */
+#define GL_INTERNAL_L_MAT_FLAT(lvl, p, cols, rows, stride, lay)       \
+    GL_INTERNAL_L_MAT_NAMED(lvl, #p,                                  \
+        ::gl::internal::make_matrix_view((p), (stride), (lay)), cols, \
+        rows, ::gl::get_max_elements())
 
 #endif // DOXYGEN_HIDDEN
 
 } // namespace gl
 
+#ifndef GL_CORE_ONLY
+#include "goinglogging_containers.h"
+#include "goinglogging_streams.h"
+#include "goinglogging_wide.h"
+#endif // GL_CORE_ONLY
+
 #endif // INCLUDE_GOINGLOGGING_H_
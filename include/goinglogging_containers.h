@@ -0,0 +1,494 @@
+/** \file
+ *
+ * \brief Formatting of standard library containers, std::complex and
+ * std::valarray. Included by goinglogging.h unless GL_CORE_ONLY is defined.
+ *
+ */
+
+#include "goinglogging.h"
+
+#ifndef INCLUDE_GOINGLOGGING_CONTAINERS_H_
+#define INCLUDE_GOINGLOGGING_CONTAINERS_H_
+
+#include <array>
+#include <complex>
+#include <deque>
+#include <forward_list>
+#include <list>
+#include <map>
+#include <queue>
+#include <set>
+#include <stack>
+#include <unordered_map>
+#include <unordered_set>
+#include <valarray>
+#include <vector>
+
+namespace gl {
+
+#ifndef DOXYGEN_HIDDEN
+
+template<class T, size_t N>
+struct is_deferrable<std::array<T, N>> : is_deferrable<T> {};
+template<class T, class A>
+struct is_deferrable<std::vector<T, A>> : is_deferrable<T> {};
+template<class T, class A>
+struct is_deferrable<std::deque<T, A>> : is_deferrable<T> {};
+template<class T, class A>
+struct is_deferrable<std::list<T, A>> : is_deferrable<T> {};
+template<class T, class A>
+struct is_deferrable<std::forward_list<T, A>> : is_deferrable<T> {};
+template<class T, class C, class A>
+struct is_deferrable<std::set<T, C, A>> : is_deferrable<T> {};
+template<class T, class C, class A>
+struct is_deferrable<std::multiset<T, C, A>> : is_deferrable<T> {};
+template<class K, class V, class C, class A>
+struct is_deferrable<std::map<K, V, C, A>>
+    : std::integral_constant<bool,
+          is_deferrable<K>::value && is_deferrable<V>::value> {};
+template<class K, class V, class C, class A>
+struct is_deferrable<std::multimap<K, V, C, A>>
+    : std::integral_constant<bool,
+          is_deferrable<K>::value && is_deferrable<V>::value> {};
+template<class T, class H, class E, class A>
+struct is_deferrable<std::unordered_set<T, H, E, A>> : is_deferrable<T> {};
+template<class K, class V, class H, class E, class A>
+struct is_deferrable<std::unordered_map<K, V, H, E, A>>
+    : std::integral_constant<bool,
+          is_deferrable<K>::value && is_deferrable<V>::value> {};
+template<class T>
+struct is_deferrable<std::complex<T>> : is_deferrable<T> {};
+
+namespace internal {
+
+/**
+ * \brief Write a sequence, defined by begin() and end(), to stream.
+ *
+ * \tparam T Value type.
+ * \param os Output stream.
+ * \return Output stream.
+ *
+ */
+template<class T>
+std::ostream& ValueFormatter<T>::sequence(std::ostream& os) const noexcept {
+    using E = typename std::remove_cv<typename std::remove_reference<decltype(
+        *std::begin(m_val))>::type>::type;
+    os << '{';
+    auto         it  = std::begin(m_val);
+    const size_t max = config().maxElements.load(std::memory_order_relaxed);
+    const size_t n =
+        max == 0 ? 0 : static_cast<size_t>(std::distance(it, std::end(m_val)));
+    if (n > max) {
+        Summary<E> s;
+        if (s.is_enabled()) {
+            for (; it != std::end(m_val); ++it) {
+                s.add(*it);
+            }
+            return s.write(os) << '}';
+        }
+        const size_t head = elision_head(n, max);
+        const size_t tail = elision_tail(n, max);
+        os << format_value(*it);
+        for (size_t i = 1; i < head; ++i) {
+            os << ", " << format_value(*++it);
+        }
+        write_gap(os, n - head - tail);
+        std::advance(it, n - head - tail + 1);
+        for (; it != std::end(m_val); ++it) {
+            os << ", " << format_value(*it);
+        }
+        return os << '}';
+    }
+    // Print first object without comma
+    if (it != std::end(m_val)) {
+        os << format_value(*it);
+        ++it;
+    }
+    // Print the rest
+    for (; it != std::end(m_val); ++it) {
+        os << ", " << format_value(*it);
+    }
+    os << '}';
+
+    return os;
+}
+
+/**
+ * \brief Write a map, defined by begin() and end(), to stream.
+ *
+ * \tparam T Value type.
+ * \param os Output stream.
+ * \return Output stream.
+ *
+ */
+template<class T>
+std::ostream& ValueFormatter<T>::map(std::ostream& os) const noexcept {
+    os << '{';
+    auto         it  = m_val.begin();
+    const size_t max = config().maxElements.load(std::memory_order_relaxed);
+    const size_t n   = max == 0 ? 0 : m_val.size();
+    if (n > max) {
+        const size_t head = elision_head(n, max);
+        const size_t tail = elision_tail(n, max);
+        for (size_t i = 0; i < head; ++i, ++it) {
+            os << (i == 0 ? "" : ", ") << format_value(it->first) << ": "
+               << format_value(it->second);
+        }
+        write_gap(os, n - head - tail);
+        std::advance(it, n - head - tail);
+        for (; it != m_val.end(); ++it) {
+            os << ", " << format_value(it->first) << ": "
+               << format_value(it->second);
+        }
+        return os << '}';
+    }
+    // Print first object without comma
+    if (it != m_val.end()) {
+        os << format_value(it->first) << ": " << format_value(it->second);
+        ++it;
+    }
+    // Print the rest
+    for (; it != m_val.end(); ++it) {
+        os << ", " << format_value(it->first) << ": "
+           << format_value(it->second);
+    }
+    os << '}';
+
+    return os;
+}
+
+/**
+ * \brief Write a stack, defined by top(), to stream.
+ *
+ * \tparam T Value type.
+ * \param os Output stream.
+ * \return Output stream.
+ *
+ */
+template<class T>
+std::ostream& ValueFormatter<T>::stack(std::ostream& os) const noexcept {
+    // Only print first element, if available
+    os << '{';
+    if (m_val.size() == 1) {
+        os << format_value(m_val.top());
+    } else if (!m_val.empty()) {
+        os << format_value(m_val.top()) << ", ...";
+    }
+    os << '}';
+
+    return os;
+}
+
+/**
+ * \brief Write a queue, defined by front() and back(), to stream.
+ *
+ * \tparam T Value type.
+ * \param os Output stream.
+ * \return Output stream.
+ *
+ */
+template<class T>
+std::ostream& ValueFormatter<T>::queue(std::ostream& os) const noexcept {
+    // Only print first element, if available
+    os << '{';
+    if (m_val.size() == 1) {
+        os << format_value(m_val.front());
+    } else if (m_val.size() == 2) {
+        os << format_value(m_val.front()) << ", " << format_value(m_val.back());
+    } else if (!m_val.empty() != 0) {
+        os << format_value(m_val.front()) << ", ..., "
+           << format_value(m_val.back());
+    }
+    os << '}';
+
+    return os;
+}
+
+/**
+ * \brief Format std::complex.
+ *
+ * \tparam U Pointer type.
+ * \param os Output stream.
+ * \param f  ValueFormatter.
+ * \return Output stream.
+ *
+ */
+template<class U>
+std::ostream& operator<<(
+    std::ostream& os, const ValueFormatter<std::complex<U>>& f) noexcept {
+    os << f.get_value().real();
+    if (f.get_value().imag() >= 0) {
+        os << " + " << f.get_value().imag();
+    } else {
+        os << " - " << -f.get_value().imag();
+    }
+    return os << 'i';
+}
+
+/**
+ * \brief Format std::valarray.
+ *
+ * \tparam U Element type.
+ * \param os Output stream.
+ * \param f  ValueFormatter.
+ * \return Output stream.
+ *
+ */
+template<class U>
+std::ostream& operator<<(
+    std::ostream& os, const ValueFormatter<std::valarray<U>>& f) noexcept {
+    return f.sequence(os);
+}
+
+/**
+ * \brief Format std::array.
+ *
+ * \tparam U Value type.
+ * \tparam N Number of elements.
+ * \param os Output stream.
+ * \param f  ValueFormatter.
+ * \return Output stream.
+ *
+ */
+template<class U, size_t N>
+std::ostream& operator<<(
+    std::ostream& os, const ValueFormatter<std::array<U, N>>& f) noexcept {
+    return f.sequence(os);
+}
+
+/**
+ * \brief Format std::vector.
+ *
+ * \tparam U Value type.
+ * \param os Output stream.
+ * \param f  ValueFormatter.
+ * \return Output stream.
+ *
+ */
+template<class U>
+std::ostream& operator<<(
+    std::ostream& os, const ValueFormatter<std::vector<U>>& f) noexcept {
+    return f.sequence(os);
+}
+
+/**
+ * \brief Format std::deque.
+ *
+ * \tparam U Value type.
+ * \param os Output stream.
+ * \param f  ValueFormatter.
+ * \return Output stream.
+ *
+ */
+template<class U>
+std::ostream& operator<<(
+    std::ostream& os, const ValueFormatter<std::deque<U>>& f) noexcept {
+    return f.sequence(os);
+}
+
+/**
+ * \brief Format std::forward_list.
+ *
+ * \tparam U Value type.
+ * \param os Output stream.
+ * \param f  ValueFormatter.
+ * \return Output stream.
+ *
+ */
+template<class U>
+std::ostream& operator<<(
+    std::ostream& os, const ValueFormatter<std::forward_list<U>>& f) noexcept {
+    return f.sequence(os);
+}
+
+/**
+ * \brief Format std::list.
+ *
+ * \tparam U Value type.
+ * \param os Output stream.
+ * \param f  ValueFormatter.
+ * \return Output stream.
+ *
+ */
+template<class U>
+std::ostream& operator<<(
+    std::ostream& os, const ValueFormatter<std::list<U>>& f) noexcept {
+    return f.sequence(os);
+}
+
+/**
+ * \brief Format std::set.
+ *
+ * \tparam U Value type.
+ * \param os Output stream.
+ * \param f  ValueFormatter.
+ * \return Output stream.
+ *
+ */
+template<class U>
+std::ostream& operator<<(
+    std::ostream& os, const ValueFormatter<std::set<U>>& f) noexcept {
+    return f.sequence(os);
+}
+
+/**
+ * \brief Format std::map.
+ *
+ * \tparam U Key type.
+ * \tparam V Value type.
+ * \param os Output stream.
+ * \param f  ValueFormatter.
+ * \return Output stream.
+ *
+ */
+template<class U, class V>
+std::ostream& operator<<(
+    std::ostream& os, const ValueFormatter<std::map<U, V>>& f) noexcept {
+    return f.map(os);
+}
+
+/**
+ * \brief Format std::multiset.
+ *
+ * \tparam U Value type.
+ * \param os Output stream.
+ * \param f  ValueFormatter.
+ * \return Output stream.
+ *
+ */
+template<class U>
+std::ostream& operator<<(
+    std::ostream& os, const ValueFormatter<std::multiset<U>>& f) noexcept {
+    return f.sequence(os);
+}
+
+/**
+ * \brief Format std::multimap.
+ *
+ * \tparam U Key type.
+ * \tparam V Value type.
+ * \param os Output stream.
+ * \param f  ValueFormatter.
+ * \return Output stream.
+ *
+ */
+template<class U, class V>
+std::ostream& operator<<(
+    std::ostream& os, const ValueFormatter<std::multimap<U, V>>& f) noexcept {
+    return f.map(os);
+}
+
+/**
+ * \brief Format std::unordered_set.
+ *
+ * \tparam U Value type.
+ * \param os Output stream.
+ * \param f  ValueFormatter.
+ * \return Output stream.
+ *
+ */
+template<class U>
+std::ostream& operator<<(
+    std::ostream& os, const ValueFormatter<std::unordered_set<U>>& f) noexcept {
+    return f.sequence(os);
+}
+
+/**
+ * \brief Format std::unordered_map.
+ *
+ * \tparam U Key type.
+ * \tparam V Value type.
+ * \param os Output stream.
+ * \param f  ValueFormatter.
+ * \return Output stream.
+ *
+ */
+template<class U, class V>
+std::ostream& operator<<(std::ostream&              os,
+    const ValueFormatter<std::unordered_map<U, V>>& f) noexcept {
+    return f.map(os);
+}
+
+/**
+ * \brief Format std::unordered_multiset.
+ *
+ * \tparam U Value type.
+ * \param os Output stream.
+ * \param f  ValueFormatter.
+ * \return Output stream.
+ *
+ */
+template<class U>
+std::ostream& operator<<(std::ostream&                os,
+    const ValueFormatter<std::unordered_multiset<U>>& f) noexcept {
+    return f.sequence(os);
+}
+
+/**
+ * \brief Format std::unordered_multimap.
+ *
+ * \tparam U Key type.
+ * \tparam V Value type.
+ * \param os Output stream.
+ * \param f  ValueFormatter.
+ * \return Output stream.
+ *
+ */
+template<class U, class V>
+std::ostream& operator<<(std::ostream&                   os,
+    const ValueFormatter<std::unordered_multimap<U, V>>& f) noexcept {
+    return f.map(os);
+}
+
+/**
+ * \brief Format std::stack.
+ *
+ * \tparam U Value type.
+ * \param os Output stream.
+ * \param f  ValueFormatter.
+ * \return Output stream.
+ *
+ */
+template<class U>
+std::ostream& operator<<(
+    std::ostream& os, const ValueFormatter<std::stack<U>>& f) noexcept {
+    return f.stack(os);
+}
+
+/**
+ * \brief Format std::queue.
+ *
+ * \tparam U Value type.
+ * \param os Output stream.
+ * \param f  ValueFormatter.
+ * \return Output stream.
+ *
+ */
+template<class U>
+std::ostream& operator<<(
+    std::ostream& os, const ValueFormatter<std::queue<U>>& f) noexcept {
+    return f.queue(os);
+}
+
+/**
+ * \brief Format std::priority_queue.
+ *
+ * \tparam U Value type.
+ * \param os Output stream.
+ * \param f  ValueFormatter.
+ * \return Output stream.
+ *
+ */
+template<class U>
+std::ostream& operator<<(std::ostream&            os,
+    const ValueFormatter<std::priority_queue<U>>& f) noexcept {
+    return f.stack(os);
+}
+
+} // namespace internal
+
+#endif // DOXYGEN_HIDDEN
+
+} // namespace gl
+
+#endif // INCLUDE_GOINGLOGGING_CONTAINERS_H_
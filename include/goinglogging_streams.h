@@ -0,0 +1,232 @@
+/** \file
+ *
+ * \brief Formatting of string buffers, string streams and std::locale.
+ * Included by goinglogging.h unless GL_CORE_ONLY is defined.
+ *
+ */
+
+#include "goinglogging.h"
+
+#ifndef INCLUDE_GOINGLOGGING_STREAMS_H_
+#define INCLUDE_GOINGLOGGING_STREAMS_H_
+
+#include "goinglogging_wide.h"
+#include <locale>
+#include <sstream>
+
+namespace gl {
+
+#ifndef DOXYGEN_HIDDEN
+
+namespace internal {
+
+#if __cplusplus >= 202002L || (defined(_MSVC_LANG) && _MSVC_LANG >= 202002L)
+/** std::basic_stringbuf::view() is available. */
+#define GL_INTERNAL_STRINGBUF_VIEW
+#endif // __cplusplus
+
+#if !defined(GL_INTERNAL_STRINGBUF_VIEW) && defined(__GLIBCXX__)
+/**
+ * \brief Read access to the characters of a std::basic_stringbuf, without
+ * copying them like str() does.
+ *
+ * \note Only for libstdc++, which keeps the end of the characters in the
+ * put and get areas. Other libraries keep it in private members.
+ *
+ * \tparam C Character type.
+ */
+template<class C>
+class StringBufAccess : public std::basic_stringbuf<C> {
+  public:
+    /**
+     * \brief Get characters, the same as str() returns.
+     *
+     * \param b Buffer.
+     * \param n Number of characters. Set.
+     * \return Characters [\p n].
+     */
+    static const C* data(const std::basic_stringbuf<C>& b, size_t& n) noexcept {
+        // Protected members may be named through this class, and then
+        // called on any buffer
+        using Get         = C* (std::basic_streambuf<C>::*)() const;
+        const Get pbaseOf = &StringBufAccess::pbase;
+        const Get pptrOf  = &StringBufAccess::pptr;
+        const Get ebackOf = &StringBufAccess::eback;
+        const Get egptrOf = &StringBufAccess::egptr;
+        const C*  begin   = (b.*pbaseOf)();
+        const C*  end     = (b.*pptrOf)();
+        const C*  getEnd  = (b.*egptrOf)();
+        if (end == nullptr) {
+            // Input only
+            begin = (b.*ebackOf)();
+            end   = getEnd;
+        } else if (getEnd != nullptr && getEnd > end) {
+            // Written characters before the end of earlier ones
+            end = getEnd;
+        }
+        n = static_cast<size_t>(end - begin);
+        return begin;
+    }
+};
+#endif // GL_INTERNAL_STRINGBUF_VIEW
+
+/**
+ * \brief Write characters of a string buffer.
+ *
+ * \param os Output stream.
+ * \param s  Characters [\p n].
+ * \param n  Number of characters.
+ */
+inline void write_buffer_text(std::ostream& os, const char* s, size_t n) {
+    os.write(s, static_cast<std::streamsize>(n));
+}
+
+/**
+ * \brief Write characters of a wide string buffer as UTF-8.
+ *
+ * \tparam C Code unit type.
+ * \param os Output stream.
+ * \param s  Code units [\p n].
+ * \param n  Number of code units.
+ */
+template<class C>
+void write_buffer_text(std::ostream& os, const C* s, size_t n) {
+    write_utf8(os, s, n);
+}
+
+/**
+ * \brief Write quoted characters of a string buffer, wide ones as UTF-8.
+ *
+ * Uses view() if available, and on libstdc++ the put and get areas, so that
+ * the characters aren't copied. Otherwise falls back to str().
+ *
+ * \tparam C Character type.
+ * \param os Output stream.
+ * \param b  Buffer.
+ * \return Output stream.
+ */
+template<class C>
+std::ostream& write_quoted_buffer(
+    std::ostream& os, const std::basic_stringbuf<C>& b) {
+#if defined(GL_INTERNAL_STRINGBUF_VIEW)
+    const auto v = b.view();
+    const C*   s = v.data();
+    size_t     n = v.size();
+#elif defined(__GLIBCXX__)
+    size_t   n = 0;
+    const C* s = StringBufAccess<C>::data(b, n);
+#else
+    const std::basic_string<C> str = b.str();
+    const C*                   s   = str.data();
+    size_t                     n   = str.size();
+#endif // GL_INTERNAL_STRINGBUF_VIEW
+    os << '\"';
+    write_buffer_text(os, s, n);
+    return os << '\"';
+}
+
+/**
+ * \brief Format std::stringbuf.
+ *
+ * \param os Output stream.
+ * \param f  ValueFormatter.
+ * \return Output stream.
+ *
+ */
+template<>
+inline std::ostream& operator<<(
+    std::ostream& os, const ValueFormatter<std::stringbuf>& f) noexcept {
+    return write_quoted_buffer(os, f.m_val);
+}
+
+/**
+ * \brief Format std::wstringbuf.
+ *
+ * \param os Output stream.
+ * \param f  ValueFormatter.
+ * \return Output stream.
+ *
+ */
+template<>
+inline std::ostream& operator<<(
+    std::ostream& os, const ValueFormatter<std::wstringbuf>& f) noexcept {
+    return write_quoted_buffer(os, f.m_val);
+}
+
+/**
+ * \brief Format std::ostringstream.
+ *
+ * \param os Output stream.
+ * \param f  ValueFormatter.
+ * \return Output stream.
+ *
+ */
+template<>
+inline std::ostream& operator<<(
+    std::ostream& os, const ValueFormatter<std::ostringstream>& f) noexcept {
+    return write_quoted_buffer(os, *f.m_val.rdbuf());
+}
+
+/**
+ * \brief Format std::wostringstream.
+ *
+ * \param os Output stream.
+ * \param f  ValueFormatter.
+ * \return Output stream.
+ *
+ */
+template<>
+inline std::ostream& operator<<(
+    std::ostream& os, const ValueFormatter<std::wostringstream>& f) noexcept {
+    return write_quoted_buffer(os, *f.m_val.rdbuf());
+}
+
+/**
+ * \brief Format std::stringstream.
+ *
+ * \param os Output stream.
+ * \param f  ValueFormatter.
+ * \return Output stream.
+ *
+ */
+template<>
+inline std::ostream& operator<<(
+    std::ostream& os, const ValueFormatter<std::stringstream>& f) noexcept {
+    return write_quoted_buffer(os, *f.m_val.rdbuf());
+}
+
+/**
+ * \brief Format std::wstringstream.
+ *
+ * \param os Output stream.
+ * \param f  ValueFormatter.
+ * \return Output stream.
+ *
+ */
+template<>
+inline std::ostream& operator<<(
+    std::ostream& os, const ValueFormatter<std::wstringstream>& f) noexcept {
+    return write_quoted_buffer(os, *f.m_val.rdbuf());
+}
+
+/**
+ * \brief Format std::locale.
+ *
+ * \param os Output stream.
+ * \param f  ValueFormatter.
+ * \return Output stream.
+ *
+ */
+template<>
+inline std::ostream& operator<<(
+    std::ostream& os, const ValueFormatter<std::locale>& f) noexcept {
+    return os << '"' << f.m_val.name() << '"';
+}
+
+} // namespace internal
+
+#endif // DOXYGEN_HIDDEN
+
+} // namespace gl
+
+#endif // INCLUDE_GOINGLOGGING_STREAMS_H_
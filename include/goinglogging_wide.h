@@ -0,0 +1,215 @@
+/** \file
+ *
+ * \brief Formatting of std::u16string, std::u32string and std::wstring as
+ * UTF-8. Included by goinglogging.h unless GL_CORE_ONLY is defined.
+ *
+ */
+
+#include "goinglogging.h"
+
+#ifndef INCLUDE_GOINGLOGGING_WIDE_H_
+#define INCLUDE_GOINGLOGGING_WIDE_H_
+
+#include <string>
+
+namespace gl {
+
+#ifndef DOXYGEN_HIDDEN
+
+namespace internal {
+
+/**
+ * \brief Encode code point as UTF-8.
+ *
+ * \param out Output. At least 4 characters.
+ * \param cp  Code point. At most 0x10FFFF.
+ * \return Number of characters.
+ */
+inline size_t encode_utf8(char* out, uint32_t cp) noexcept {
+    if (cp < 0x80) {
+        out[0] = static_cast<char>(cp);
+        return 1;
+    }
+    if (cp < 0x800) {
+        out[0] = static_cast<char>(0xC0 | (cp >> 6));
+        out[1] = static_cast<char>(0x80 | (cp & 0x3F));
+        return 2;
+    }
+    if (cp < 0x10000) {
+        out[0] = static_cast<char>(0xE0 | (cp >> 12));
+        out[1] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out[2] = static_cast<char>(0x80 | (cp & 0x3F));
+        return 3;
+    }
+    out[0] = static_cast<char>(0xF0 | (cp >> 18));
+    out[1] = static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+    out[2] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+    out[3] = static_cast<char>(0x80 | (cp & 0x3F));
+    return 4;
+}
+
+/** Code point output in place of invalid UTF-16 and UTF-32. */
+constexpr uint32_t replacementCharacter = 0xFFFD;
+
+/**
+ * \brief Decode one code point of UTF-16.
+ *
+ * \param s Code units [\p n].
+ * \param n Number of code units. At least 1.
+ * \param i Index of code point. Moved past it.
+ * \return Code point, or replacementCharacter if unpaired surrogate.
+ */
+template<class C>
+uint32_t decode_code_point(const C* s, size_t n, size_t& i,
+    std::integral_constant<size_t, 2> /*unitSize*/) noexcept {
+    uint32_t c = static_cast<uint32_t>(s[i++]) & 0xFFFF;
+    if (c < 0xD800 || c > 0xDFFF) {
+        return c;
+    }
+    if (c <= 0xDBFF && i < n) {
+        uint32_t d = static_cast<uint32_t>(s[i]) & 0xFFFF;
+        if (d >= 0xDC00 && d <= 0xDFFF) {
+            ++i;
+            return 0x10000 + ((c - 0xD800) << 10) + (d - 0xDC00);
+        }
+    }
+    return replacementCharacter;
+}
+
+/**
+ * \brief Decode one code point of UTF-32.
+ *
+ * \param s Code units [\p n].
+ * \param i Index of code point. Moved past it.
+ * \return Code point, or replacementCharacter if invalid.
+ */
+template<class C>
+uint32_t decode_code_point(const C* s, size_t /*n*/, size_t& i,
+    std::integral_constant<size_t, 4> /*unitSize*/) noexcept {
+    uint32_t c = static_cast<uint32_t>(s[i++]);
+    if (c > 0x10FFFF || (c >= 0xD800 && c <= 0xDFFF)) {
+        return replacementCharacter;
+    }
+    return c;
+}
+
+/**
+ * \return Mask of bits that are set in a 64 bit word of UTF-16 code units
+ * if any of them isn't ASCII.
+ */
+inline constexpr uint64_t non_ascii_mask(
+    std::integral_constant<size_t, 2> /*unitSize*/) noexcept {
+    return 0xFF80FF80FF80FF80ULL;
+}
+
+/**
+ * \return Mask of bits that are set in a 64 bit word of UTF-32 code units
+ * if any of them isn't ASCII.
+ */
+inline constexpr uint64_t non_ascii_mask(
+    std::integral_constant<size_t, 4> /*unitSize*/) noexcept {
+    return 0xFFFFFF80FFFFFF80ULL;
+}
+
+/**
+ * \brief Write UTF-16 or UTF-32 string, depending on size of \p C, as
+ * UTF-8. Runs of ASCII are checked and narrowed 64 bits at a time.
+ *
+ * \tparam C Code unit type.
+ * \param os Output stream.
+ * \param s  Code units [\p n].
+ * \param n  Number of code units.
+ * \return Output stream.
+ */
+template<class C>
+std::ostream& write_utf8(std::ostream& os, const C* s, size_t n) {
+    using UnitSize = std::integral_constant<size_t, sizeof(C)>;
+    const size_t   perWord  = sizeof(uint64_t) / sizeof(C);
+    const uint64_t nonAscii = non_ascii_mask(UnitSize());
+
+    TextBlock b(os);
+    size_t    i = 0;
+    while (i < n) {
+        uint64_t w = nonAscii;
+        if (n - i >= perWord) {
+            std::memcpy(&w, s + i, sizeof(w));
+        }
+        char* out = b.reserve(perWord < 4 ? 4 : perWord);
+        if ((w & nonAscii) == 0) {
+            for (size_t j = 0; j < perWord; ++j) {
+                out[j] = static_cast<char>(s[i + j]);
+            }
+            b.commit(perWord);
+            i += perWord;
+        } else {
+            b.commit(encode_utf8(out, decode_code_point(s, n, i, UnitSize())));
+        }
+    }
+    return os;
+}
+
+/**
+ * \brief Write quoted wide string as UTF-8.
+ *
+ * \tparam C Code unit type.
+ * \param os Output stream.
+ * \param s  String.
+ * \return Output stream.
+ */
+template<class C>
+std::ostream& write_quoted_utf8(
+    std::ostream& os, const std::basic_string<C>& s) {
+    os << '\"';
+    write_utf8(os, s.data(), s.size());
+    return os << '\"';
+}
+
+/**
+ * \brief Format std::u16string.
+ *
+ * \param os Output stream.
+ * \param f  ValueFormatter.
+ * \return Output stream.
+ *
+ */
+template<>
+inline std::ostream& operator<<(
+    std::ostream& os, const ValueFormatter<std::u16string>& f) noexcept {
+    return write_quoted_utf8(os, f.m_val);
+}
+
+/**
+ * \brief Format std::u32string.
+ *
+ * \param os Output stream.
+ * \param f  ValueFormatter.
+ * \return Output stream.
+ *
+ */
+template<>
+inline std::ostream& operator<<(
+    std::ostream& os, const ValueFormatter<std::u32string>& f) noexcept {
+    return write_quoted_utf8(os, f.m_val);
+}
+
+/**
+ * \brief Format std::wstring.
+ *
+ * \param os Output stream.
+ * \param f  ValueFormatter.
+ * \return Output stream.
+ *
+ */
+template<>
+inline std::ostream& operator<<(
+    std::ostream& os, const ValueFormatter<std::wstring>& f) noexcept {
+    return write_quoted_utf8(os, f.m_val);
+}
+
+} // namespace internal
+
+#endif // DOXYGEN_HIDDEN
+
+} // namespace gl
+
+#endif // INCLUDE_GOINGLOGGING_WIDE_H_
@@ -0,0 +1,16 @@
+#include "goinglogging.h"
+
+/**
+ * \file
+ * Explicit instantiations of the logging of commonly logged types. Link to
+ * the library built from this file, and define GL_EXTERN_TEMPLATES, so that
+ * translation units don't instantiate them again.
+ */
+
+namespace gl {
+namespace internal {
+
+GL_INTERNAL_COMMON_TYPES(GL_INTERNAL_INSTANTIATE, )
+
+} // namespace internal
+} // namespace gl
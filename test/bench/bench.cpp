@@ -0,0 +1,458 @@
+#include "goinglogging.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * \file
+ * Benchmark of logging macros and value formatters.
+ *
+ * Measures time per call and calls per second against different sinks and
+ * numbers of threads, and writes a JSON report for regression tracking.
+ * Progress goes to stderr. Without --report, the report goes to stdout, and
+ * the stdout sink is skipped, since its output would be mixed in. With it,
+ * logging output of the stdout sink goes to stdout, so run as e.g.:
+ * \code
+ * bench/bench --report report.json > /dev/null
+ * \endcode
+ */
+
+#ifndef GL_BENCH_BUILD_TYPE
+/** CMake build type that the benchmark was compiled with. */
+#define GL_BENCH_BUILD_TYPE ""
+#endif // GL_BENCH_BUILD_TYPE
+
+/** File written by file sinks. */
+static const char* fileName = "tmp_bench_file.txt";
+
+/**
+ * \brief Sink discarding output, but unlike gl::NullSink, after formatting
+ * it.
+ */
+class DiscardSink : public gl::Sink {
+  public:
+    /**
+     * \brief Constructor.
+     */
+    DiscardSink() : m_bytes(0) {
+    }
+
+    /**
+     * \brief Count and discard output.
+     *
+     * \param len Number of characters.
+     */
+    void write(const char* /*data*/, size_t len) override {
+        m_bytes.fetch_add(len, std::memory_order_relaxed);
+    }
+
+  private:
+    std::atomic<uint64_t> m_bytes; /**< Number of discarded characters. */
+};
+
+/**
+ * \brief Benchmark settings.
+ */
+struct Options {
+    /**
+     * \brief Constructor. Set defaults.
+     */
+    Options() : iterations(100000), maxThreads(4), filter(), report() {
+    }
+
+    uint64_t    iterations; /**< Calls per thread in simple cases. */
+    unsigned    maxThreads; /**< Largest number of threads. */
+    std::string filter;     /**< Only run cases containing this. */
+    std::string report;     /**< Report file. Empty for stderr. */
+};
+
+/**
+ * \brief Result of one benchmark case.
+ */
+struct Result {
+    /**
+     * \brief Constructor.
+     */
+    Result() :
+        name(), sink(), prefixes(), threads(0), calls(0), nsPerCall(0),
+        callsPerSec(0) {
+    }
+
+    std::string name;        /**< Case name. */
+    std::string sink;        /**< Sink name. */
+    std::string prefixes;    /**< Prefix names. */
+    unsigned    threads;     /**< Number of threads. */
+    uint64_t    calls;       /**< Total number of calls. */
+    double      nsPerCall;   /**< Time per call and thread. */
+    double      callsPerSec; /**< Total calls per second. */
+};
+
+/** Benchmark body. Logs the given number of times. */
+using Body = std::function<void(uint64_t)>;
+
+/**
+ * \brief Benchmark case.
+ */
+struct Case {
+    std::string name;  /**< Name. */
+    uint64_t    scale; /**< Divisor of iterations, for expensive cases. */
+    Body        body;  /**< Body. */
+};
+
+/**
+ * \brief Set sink by name.
+ *
+ * \param name One of "null", "discard", "file", "async_file" and "stdout".
+ */
+static void set_sink(const std::string& name) {
+    gl::set_async_enabled(false);
+    if (name == "null") {
+        gl::set_sink(std::make_shared<gl::NullSink>());
+    } else if (name == "discard") {
+        gl::set_sink(std::make_shared<DiscardSink>());
+    } else if (name == "file" || name == "async_file") {
+        gl::set_sink(std::make_shared<gl::BufferedFileSink>(fileName));
+        gl::set_async_enabled(name == "async_file");
+    } else {
+        gl::set_sink(nullptr);
+    }
+}
+
+/**
+ * \brief Get names of prefixes.
+ *
+ * \param p Prefixes.
+ * \return Names separated by '|', or "NONE".
+ */
+static std::string prefix_names(gl::prefix p) {
+    static const struct {
+        gl::prefix  p;
+        const char* name;
+    } names[] = {{gl::prefix::FILE, "FILE"}, {gl::prefix::LINE, "LINE"},
+        {gl::prefix::FUNCTION, "FUNCTION"}, {gl::prefix::TIME, "TIME"},
+        {gl::prefix::THREAD, "THREAD"}, {gl::prefix::TYPE_NAME, "TYPE_NAME"}};
+    std::string rv;
+    for (const auto& n : names) {
+        if ((p & n.p) != gl::prefix::NONE) {
+            rv += rv.empty() ? "" : "|";
+            rv += n.name;
+        }
+    }
+    return rv.empty() ? "NONE" : rv;
+}
+
+/**
+ * \brief Run benchmark case on threads that start at the same time.
+ *
+ * \param c          Case.
+ * \param sink       Sink name.
+ * \param threads    Number of threads.
+ * \param iterations Calls per thread.
+ * \return Result.
+ */
+static Result run(const Case& c, const std::string& sink, unsigned threads,
+    uint64_t iterations) {
+    set_sink(sink);
+
+    // Warm up caches, e.g. of call sites and type names
+    c.body(iterations / 100 + 1);
+
+    std::atomic<unsigned>    ready(0);
+    std::atomic<bool>        go(false);
+    std::vector<std::thread> pool;
+    for (unsigned t = 0; t < threads; ++t) {
+        pool.emplace_back([&]() {
+            ready.fetch_add(1);
+            while (!go.load()) {
+                std::this_thread::yield();
+            }
+            c.body(iterations);
+        });
+    }
+    while (ready.load() != threads) {
+        std::this_thread::yield();
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    go.store(true);
+    for (std::thread& t : pool) {
+        t.join();
+    }
+    gl::set_async_enabled(false);
+    auto stop = std::chrono::steady_clock::now();
+
+    double ns = static_cast<double>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start)
+            .count());
+    Result r;
+    r.name        = c.name;
+    r.sink        = sink;
+    r.prefixes    = prefix_names(gl::get_prefixes());
+    r.threads     = threads;
+    r.calls       = iterations * threads;
+    r.nsPerCall   = ns / static_cast<double>(iterations);
+    r.callsPerSec = static_cast<double>(r.calls) * 1e9 / ns;
+    return r;
+}
+
+/**
+ * \brief Write results as JSON.
+ *
+ * \param os      Output stream.
+ * \param opt     Settings.
+ * \param results Results.
+ */
+static void write_report(std::ostream& os, const Options& opt,
+    const std::vector<Result>& results) {
+    os << "{\n  \"build_type\": \"" << GL_BENCH_BUILD_TYPE << "\",\n"
+       << "  \"iterations\": " << opt.iterations << ",\n"
+       << "  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        os << "    {\"name\": \"" << r.name << "\", \"sink\": \"" << r.sink
+           << "\", \"prefixes\": \"" << r.prefixes
+           << "\", \"threads\": " << r.threads << ", \"calls\": " << r.calls
+           << ", \"ns_per_call\": " << r.nsPerCall
+           << ", \"calls_per_sec\": " << r.callsPerSec << '}'
+           << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    os << "  ]\n}" << std::endl;
+}
+
+/**
+ * \brief Create benchmark cases.
+ *
+ * \return Cases.
+ */
+static std::vector<Case> make_cases() {
+    std::vector<Case> cases;
+
+    // Number of variables
+    cases.push_back({"l/1", 1, [](uint64_t n) {
+                         for (uint64_t i = 0; i < n; ++i) {
+                             l(i);
+                         }
+                     }});
+    cases.push_back({"l/4", 1, [](uint64_t n) {
+                         int a = 1, b = 2, c = 3;
+                         for (uint64_t i = 0; i < n; ++i) {
+                             l(i, a, b, c);
+                         }
+                     }});
+    cases.push_back({"l/16", 4, [](uint64_t n) {
+                         int a = 1, b = 2, c = 3, d = 4, e = 5, f = 6, g = 7;
+                         double h = 0.5, j = 1.5, k = 2.5, m = 3.5;
+                         const char* o = "o";
+                         const char* p = "p";
+                         char        q = 'q';
+                         bool        r = true;
+                         for (uint64_t i = 0; i < n; ++i) {
+                             l(i, a, b, c, d, e, f, g, h, j, k, m, o, p, q, r);
+                         }
+                     }});
+
+    // Arrays and matrices of different sizes
+    for (uint64_t len : {16u, 256u, 4096u}) {
+        std::shared_ptr<std::vector<int>> vi(new std::vector<int>(len, 7));
+        std::shared_ptr<std::vector<double>> vd(
+            new std::vector<double>(len, 0.125));
+        cases.push_back({"l_arr/int/" + std::to_string(len), len / 16 + 1u,
+            [vi](uint64_t n) {
+                const int* a = vi->data();
+                for (uint64_t i = 0; i < n; ++i) {
+                    l_arr(a, vi->size());
+                }
+            }});
+        cases.push_back({"l_arr/double/" + std::to_string(len), len / 16 + 1u,
+            [vd](uint64_t n) {
+                const double* a = vd->data();
+                for (uint64_t i = 0; i < n; ++i) {
+                    l_arr(a, vd->size());
+                }
+            }});
+    }
+    for (uint64_t dim : {4u, 64u}) {
+        std::shared_ptr<std::vector<int>> storage(
+            new std::vector<int>(dim * dim, 3));
+        std::shared_ptr<std::vector<const int*>> rows(
+            new std::vector<const int*>(dim));
+        for (size_t r = 0; r < dim; ++r) {
+            (*rows)[r] = storage->data() + r * dim;
+        }
+        cases.push_back({"l_mat/int/" + std::to_string(dim), dim * dim / 16,
+            [storage, rows, dim](uint64_t n) {
+                const int* const* m = rows->data();
+                for (uint64_t i = 0; i < n; ++i) {
+                    l_mat(m, dim, dim);
+                }
+            }});
+        cases.push_back({"l_mat_flat/int/" + std::to_string(dim),
+            dim * dim / 16, [storage, dim](uint64_t n) {
+                const int* m = storage->data();
+                for (uint64_t i = 0; i < n; ++i) {
+                    l_mat_flat(m, dim, dim, dim, gl::layout::ROW_MAJOR);
+                }
+            }});
+        cases.push_back({"l_mat_flat/int/grid/" + std::to_string(dim),
+            dim * dim / 16, [storage, dim](uint64_t n) {
+                const int* m = storage->data();
+                gl::set_matrix_format(gl::matrix_format::GRID);
+                for (uint64_t i = 0; i < n; ++i) {
+                    l_mat_flat(m, dim, dim, dim, gl::layout::ROW_MAJOR);
+                }
+                gl::set_matrix_format(gl::matrix_format::INDEXED);
+            }});
+    }
+
+    // Packet buffers
+    std::shared_ptr<std::vector<unsigned char>> frame(
+        new std::vector<unsigned char>(65536));
+    for (size_t i = 0; i < frame->size(); ++i) {
+        (*frame)[i] = static_cast<unsigned char>(i * 7);
+    }
+    cases.push_back({"l_hex/65536", 4096, [frame](uint64_t n) {
+                         const unsigned char* p = frame->data();
+                         for (uint64_t i = 0; i < n; ++i) {
+                             l_hex(p, frame->size());
+                         }
+                     }});
+    cases.push_back({"l_bytes/65536", 4096, [frame](uint64_t n) {
+                         const unsigned char* p = frame->data();
+                         for (uint64_t i = 0; i < n; ++i) {
+                             l_bytes(p, frame->size());
+                         }
+                     }});
+
+    // Scoped timing
+    cases.push_back({"l_scope", 1, [](uint64_t n) {
+                         for (uint64_t i = 0; i < n; ++i) {
+                             l_scope("scope");
+                         }
+                     }});
+    cases.push_back({"l_timer", 1, [](uint64_t n) {
+                         for (uint64_t i = 0; i < n; ++i) {
+                             l_timer("timer", 1u << 20);
+                         }
+                     }});
+
+    // Expensive formatters
+    cases.push_back({"l/map", 4, [](uint64_t n) {
+                         std::map<int, std::string> m;
+                         for (int i = 0; i < 16; ++i) {
+                             m[i] = "value";
+                         }
+                         for (uint64_t i = 0; i < n; ++i) {
+                             l(m);
+                         }
+                     }});
+    cases.push_back({"l/wstring", 1, [](uint64_t n) {
+                         std::wstring ws(L"wide string of some length");
+                         for (uint64_t i = 0; i < n; ++i) {
+                             l(ws);
+                         }
+                     }});
+    cases.push_back({"l/tm", 1, [](uint64_t n) {
+                         std::time_t t  = 0;
+                         std::tm     tm = *std::gmtime(&t);
+                         for (uint64_t i = 0; i < n; ++i) {
+                             l(tm);
+                         }
+                     }});
+
+    return cases;
+}
+
+/**
+ * \brief Benchmark entry point.
+ *
+ * \param argc Number of arguments.
+ * \param argv Arguments.
+ * \return EXIT_SUCCESS if success.
+ */
+int main(int argc, const char** argv) {
+    Options opt;
+    unsigned hw = std::thread::hardware_concurrency();
+    opt.maxThreads = hw == 0 ? opt.maxThreads : hw;
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        if (a == "--iterations" && i + 1 < argc) {
+            opt.iterations = std::strtoull(argv[++i], nullptr, 10);
+        } else if (a == "--threads" && i + 1 < argc) {
+            opt.maxThreads = static_cast<unsigned>(std::atoi(argv[++i]));
+        } else if (a == "--filter" && i + 1 < argc) {
+            opt.filter = argv[++i];
+        } else if (a == "--report" && i + 1 < argc) {
+            opt.report = argv[++i];
+        } else {
+            std::cerr << "Usage: " << *argv
+                      << " [--iterations N] [--threads N] [--filter NAME]"
+                      << " [--report FILE]" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+    if (opt.iterations == 0 || opt.maxThreads == 0) {
+        std::cerr << "Iterations and threads must be positive" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::vector<Result> results;
+    std::vector<Case>   cases = make_cases();
+    const char* sinks[] = {"null", "discard", "file", "async_file", "stdout"};
+    auto selected       = [&](const std::string& name) {
+        return name.find(opt.filter) != std::string::npos;
+    };
+
+    // Every case against every sink, with 1..N threads
+    gl::set_prefixes(gl::prefix::FILE | gl::prefix::LINE);
+    for (const Case& c : cases) {
+        if (!selected(c.name)) {
+            continue;
+        }
+        for (const char* s : sinks) {
+            // Keep stdout for the report
+            if (opt.report.empty() && std::string(s) == "stdout") {
+                continue;
+            }
+            for (unsigned t = 1; t <= opt.maxThreads; t *= 2) {
+                results.push_back(
+                    run(c, s, t, opt.iterations / c.scale + 1));
+                std::cerr << results.back().name << ' ' << s << ' ' << t
+                          << ": " << results.back().nsPerCall << " ns/call"
+                          << std::endl;
+            }
+        }
+    }
+
+    // Every prefix combination, formatted but discarded
+    if (selected("prefix")) {
+        for (uint32_t bits = 0; bits < 64; ++bits) {
+            gl::set_prefixes(static_cast<gl::prefix>(bits));
+            Case c = cases.front();
+            c.name = "prefix/l/1";
+            results.push_back(run(c, "discard", 1, opt.iterations));
+        }
+        gl::set_prefixes(gl::prefix::FILE | gl::prefix::LINE);
+    }
+
+    set_sink("stdout");
+    std::remove(fileName);
+
+    if (opt.report.empty()) {
+        write_report(std::cout, opt, results);
+    } else {
+        std::ofstream f(opt.report);
+        write_report(f, opt, results);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,58 @@
+#include "goinglogging.h"
+#include "test/test.h"
+#include <cstdint>
+#include <iostream>
+
+/**
+ * \file
+ * Test asynchronous output.
+ */
+
+using namespace gl::test;
+
+/**
+ * \brief Test entry point.
+ *
+ * \param argc Number of arguments.
+ * \param argv Arguments.
+ * \return EXIT_SUCCESS if success.
+ */
+int main(int argc, const char** argv) {
+    // Check number of arguments
+    if (argc != 1) {
+        std::cout << "Usage: " << *argv << std::endl;
+        return EXIT_SUCCESS;
+    }
+
+    // Disable prefixes for easier output comparison.
+    gl::set_prefixes(gl::prefix::NONE);
+
+    Test t;
+    t.setup(__FILE__);
+
+    // Small queue, so that producer has to wait for writer thread
+    gl::set_async_capacity(4);
+    gl::set_async_overflow(gl::overflow::BLOCK);
+    gl::set_async_enabled(true);
+    if (!gl::is_async_enabled()) {
+        std::cout << "Failed to enable asynchronous output" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    int a[2]    = {0, 1};
+    int m[2][2] = {{0, 1}, {2, 3}};
+    for (int i = 0; i < 100; ++i) {
+        l(i);
+    }
+    l_arr(a, 2);
+    l_mat(m, 2, 2);
+
+    // Write everything in queue
+    gl::set_async_enabled(false);
+
+    uint64_t dropped = gl::get_dropped_count();
+    l(dropped);
+
+    // Compare output
+    return t.compare_output(Test::ComparisonMode::EXACT);
+}
@@ -0,0 +1,173 @@
+#include "goinglogging.h"
+#include "test/test.h"
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * \file
+ * Test binary output and decoding of it.
+ */
+
+using namespace gl::test;
+
+/**
+ * \brief Log variables of all types that binary output represents, and some
+ * that it formats when logged.
+ */
+void log_all() {
+    int                i   = -1;
+    unsigned int       u   = 2;
+    short              sh  = -3;
+    long long          ll  = 4;
+    bool               b   = true;
+    char               c   = 'c';
+    signed char        sc  = 's';
+    unsigned char      uc  = 'u';
+    float              f   = 1.5f;
+    double             d   = 0.1;
+    long double        ld  = 2.5;
+    char16_t           c16 = u'a';
+    char32_t           c32 = U'b';
+    wchar_t            wc  = L'w';
+    const char*        s   = "s";
+    std::string        str = "str";
+    std::vector<int>   vec = {1, 2};
+    int                a[3]    = {0, 1, 2};
+    int                m[2][2] = {{0, 1}, {2, 3}};
+
+    l(i, u, sh, ll);
+    l(b, c, sc, uc);
+    l(f, d, ld);
+    l(c16, c32, wc);
+    l(s, str);
+    l(vec);
+    l_arr(a, 3);
+    l_mat(m, 2, 2);
+}
+
+/**
+ * \brief Log a few variables.
+ */
+void log_some() {
+    int    i    = 1;
+    double d    = 0.5;
+    int    a[2] = {0, 1};
+    l(i, d);
+    l_arr(a, 2);
+}
+
+/**
+ * \brief Sink that is slow to write, so that the asynchronous queue fills.
+ */
+class SlowSink : public gl::Sink {
+  public:
+    /**
+     * \brief Constructor.
+     *
+     * \param os Stream to write to.
+     */
+    explicit SlowSink(std::ostream& os) : m_os(os) {
+    }
+
+    /**
+     * \brief Write after a pause.
+     *
+     * \param data Characters [\p len].
+     * \param len  Number of characters.
+     */
+    void write(const char* data, size_t len) override {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        m_os.write(data, static_cast<std::streamsize>(len));
+    }
+
+  private:
+    std::ostream& m_os; /**< Stream to write to. */
+};
+
+/**
+ * \brief Test entry point.
+ *
+ * \param argc Number of arguments.
+ * \param argv Arguments.
+ * \return EXIT_SUCCESS if success.
+ */
+int main(int argc, const char** argv) {
+    // Check number of arguments
+    if (argc != 1) {
+        std::cout << "Usage: " << *argv << std::endl;
+        return EXIT_SUCCESS;
+    }
+
+    Test t;
+    t.setup(__FILE__);
+
+    // Text, then binary decoded to the same text
+    std::stringstream bin;
+    log_all();
+    gl::set_sink(std::make_shared<gl::OstreamSink>(bin));
+    gl::set_format(gl::format::BINARY);
+    if (gl::get_format() != gl::format::BINARY) {
+        std::cout << "Failed to set format" << std::endl;
+        return EXIT_FAILURE;
+    }
+    log_all();
+    gl::set_sink(nullptr);
+    gl::set_format(gl::format::TEXT);
+    gl::decode_binary(bin, std::cout);
+
+    // Call sites are announced again in a new sink
+    const gl::prefix p = gl::prefix::LINE | gl::prefix::FUNCTION |
+                         gl::prefix::TIME | gl::prefix::THREAD |
+                         gl::prefix::TYPE_NAME;
+    gl::set_prefixes(p);
+    log_some();
+    std::stringstream bin2;
+    gl::set_sink(std::make_shared<gl::OstreamSink>(bin2));
+    gl::set_format(gl::format::BINARY);
+    log_some();
+    gl::set_sink(nullptr);
+    gl::set_format(gl::format::TEXT);
+    gl::decode_binary(bin2, std::cout, p);
+
+    // Records announcing call sites aren't dropped when the queue is full
+    for (gl::overflow o :
+        {gl::overflow::DROP_NEWEST, gl::overflow::DROP_OLDEST}) {
+        std::stringstream bin3;
+        gl::set_sink(std::make_shared<SlowSink>(bin3));
+        gl::set_format(gl::format::BINARY);
+        gl::set_async_capacity(2);
+        gl::set_async_overflow(o);
+        gl::set_async_enabled(true);
+        for (int k = 0; k < 20; ++k) {
+            log_some();
+            log_all();
+        }
+        gl::set_async_enabled(false);
+        gl::set_sink(nullptr);
+        gl::set_format(gl::format::TEXT);
+        std::ostringstream text;
+        try {
+            gl::decode_binary(bin3, text);
+        } catch (const std::runtime_error& e) {
+            std::cout << "Dropped announcement: " << e.what() << std::endl;
+        }
+    }
+
+    // Malformed input
+    std::stringstream bad("X");
+    try {
+        gl::decode_binary(bad, std::cout);
+        std::cout << "Malformed input accepted" << std::endl;
+    } catch (const std::runtime_error& e) {
+        std::cout << e.what() << std::endl;
+    }
+
+    // Compare output
+    return t.compare_output(Test::ComparisonMode::REGEX);
+}
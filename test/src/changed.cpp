@@ -0,0 +1,116 @@
+#include "goinglogging.h"
+#include "test/test.h"
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * \file
+ * Test logging of changed variables.
+ */
+
+using namespace gl::test;
+
+/**
+ * \brief Not hashable by value, so hashed by its formatted form.
+ */
+struct Mode {
+    int m; /**< Mode. */
+};
+
+/**
+ * \brief Insert into stream.
+ *
+ * \param os Output stream.
+ * \param m  Mode.
+ * \return   Output stream.
+ */
+std::ostream& operator<<(std::ostream& os, const Mode& m) {
+    return os << (m.m == 0 ? "idle" : "busy");
+}
+
+/** Number of calls to next(). */
+static int calls = 0;
+
+/**
+ * \brief Count calls.
+ *
+ * \return Number of calls before this one, divided by two.
+ */
+int next() {
+    return calls++ / 2;
+}
+
+/**
+ * \brief Log a state machine every tick.
+ */
+void log_ticks() {
+    int                        state = 0;
+    Mode                       mode  = {0};
+    std::vector<int>           v;
+    std::map<int, std::string> m;
+    for (int tick = 0; tick < 8; ++tick) {
+        state = tick / 3;
+        mode.m = tick % 5 == 4 ? 1 : 0;
+        if (tick % 4 == 1) {
+            v.push_back(tick);
+        }
+        m[tick % 2] = tick < 6 ? "a" : "b";
+        l_changed(state);
+        l_changed(mode, state);
+        l_changed(v);
+        l_changed(m);
+    }
+}
+
+/**
+ * \brief Test entry point.
+ *
+ * \param argc Number of arguments.
+ * \param argv Arguments.
+ * \return EXIT_SUCCESS if success.
+ */
+int main(int argc, const char** argv) {
+    // Check number of arguments
+    if (argc != 1) {
+        std::cout << "Usage: " << *argv << std::endl;
+        return EXIT_SUCCESS;
+    }
+
+    // Disable prefixes for easier output comparison.
+    gl::set_prefixes(gl::prefix::NONE);
+
+    Test t;
+    t.setup(__FILE__);
+
+    log_ticks();
+
+    // Same call sites, with previous values
+    gl::set_previous_values_enabled(true);
+    if (!gl::is_previous_values_enabled()) {
+        std::cout << "Failed to enable previous values" << std::endl;
+        return EXIT_FAILURE;
+    }
+    gl::set_suppressed_summary_enabled(true);
+    log_ticks();
+
+    // Expressions are evaluated once per call
+    for (int i = 0; i < 6; ++i) {
+        l_changed(next());
+    }
+    if (calls != 6) {
+        std::cout << "Evaluated " << calls << " times" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Strings of different lengths
+    std::string s = "ab";
+    for (int i = 0; i < 3; ++i) {
+        l_changed(s, std::string("c"));
+        s = "a";
+    }
+
+    // Compare output
+    return t.compare_output(Test::ComparisonMode::EXACT);
+}
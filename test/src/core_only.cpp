@@ -0,0 +1,69 @@
+#define GL_CORE_ONLY
+#include "goinglogging.h"
+#include "goinglogging_containers.h"
+#include "test/test.h"
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * \file
+ * Test the core header with one opt-in header, linked to the library of
+ * explicit instantiations.
+ */
+
+using namespace gl::test;
+
+/**
+ * \brief Test entry point.
+ *
+ * \param argc Number of arguments.
+ * \param argv Arguments.
+ * \return EXIT_SUCCESS if success.
+ */
+int main(int argc, const char** argv) {
+    // Check number of arguments
+    if (argc != 1) {
+        std::cout << "Usage: " << *argv << std::endl;
+        return EXIT_SUCCESS;
+    }
+
+    // Disable prefixes for easier output comparison.
+    gl::set_prefixes(gl::prefix::NONE);
+
+    Test t;
+    t.setup(__FILE__);
+
+    // Instantiated by the library
+    bool              b = true;
+    char              c = 'c';
+    int               i = -1;
+    const unsigned    u = 2;
+    double            d = 0.5;
+    std::string       s = "s";
+    const char* const p = "p";
+    l(b);
+    l(c);
+    l(i);
+    l(u);
+    l(d);
+    l(s);
+    l(p);
+    l(i, d, s);
+
+    // Instantiated here
+    short                      h = 3;
+    std::vector<int>           v = {1, 2};
+    std::map<std::string, int> m = {{"a", 1}};
+    l(h, v, m);
+
+    // Structured output
+    gl::set_format(gl::format::JSON);
+    l(i);
+    l(s, v);
+    gl::set_format(gl::format::TEXT);
+
+    // Compare output
+    return t.compare_output(Test::ComparisonMode::EXACT);
+}
@@ -112,6 +112,18 @@ void log_stringstreams() {
     l(woss);
     l(ss);
     l(wss);
+
+    // Whole buffer, regardless of read and write positions
+    std::string word;
+    ss << "s and more";
+    ss >> word;
+    oss.seekp(1);
+    oss << 'S';
+    wss.seekp(0);
+    wss << L"W";
+    l(ss, word);
+    l(oss);
+    l(wss);
 }
 
 /**
@@ -146,6 +158,18 @@ void log_strings() {
     l(str16);
     l(str32);
     l(strw);
+
+    // Non-ASCII, longer than the ASCII fast path, and invalid surrogates
+    std::u16string utf16 = u"\u00e5\u00e4\u00f6 \u20ac \U0001F600 ascii text";
+    std::u32string utf32 = U"\u00e5\u00e4\u00f6 \u20ac \U0001F600 ascii text";
+    std::wstring   wide  = L"\u00e5\u00e4\u00f6 \u20ac \U0001F600 ascii text";
+    std::u16string lone  = {u'a', char16_t(0xD800), u'b', char16_t(0xDC00)};
+    std::u32string large = {U'a', char32_t(0x110000), U'b'};
+    l(utf16);
+    l(utf32);
+    l(wide);
+    l(lone);
+    l(large);
 }
 
 /**
@@ -173,7 +197,7 @@ void log_containers() {
     pque.push(0);
     pque.push(1);
     pque.push(2);
-    std::map<const char*, std::vector<std::pair<float, std::string>>> adv = {
+    std::map<std::string, std::vector<std::pair<float, std::string>>> adv = {
         {"a", {{1.0, "1"}, {2.0, "2"}, {3.0, "3"}}},
         {"b", {{1.0, "1"}, {2.0, "2"}, {3.0, "3"}}}};
 
@@ -1,5 +1,6 @@
 #include "goinglogging.h"
 #include "test/test.h"
+#include <ios>
 #include <ostream>
 
 /**
@@ -41,6 +42,25 @@ std::ostream& operator<<(std::ostream& os, const CustInsOp& c) {
     return os << "<CustInsOp: " << c.m_i << '>';
 }
 
+/**
+ * \brief Outputs in hexadecimal.
+ */
+struct Hex {
+    int i; /**< Test value. */
+};
+
+/**
+ * \brief Insert into stream, leaving std::hex set.
+ *
+ * \param os Output stream.
+ * \param h  Hexadecimal object.
+ * \return   Output stream.
+ *
+ */
+std::ostream& operator<<(std::ostream& os, const Hex& h) {
+    return os << std::hex << h.i;
+}
+
 /**
  * \brief Test entry point.
  *
@@ -65,6 +85,17 @@ int main(int argc, const char** argv) {
     CustInsOp c(5);
     l(c);
 
+    // Manipulators apply to the rest of the message only
+    Hex h{255};
+    int i = 255;
+    l(h, i);
+    l(i);
+
+    // Formatting of std::cout is not used
+    std::cout << std::hex;
+    l(i);
+    std::cout << std::dec;
+
     // Compare output
     return t.compare_output(Test::ComparisonMode::EXACT);
 }
\ No newline at end of file
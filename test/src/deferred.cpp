@@ -0,0 +1,199 @@
+#include "goinglogging.h"
+#include "test/test.h"
+#include <array>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * \file
+ * Test formatting of variables by the writer thread.
+ */
+
+using namespace gl::test;
+
+/**
+ * \brief Copyable point.
+ */
+struct Point {
+    int x; /**< X coordinate. */
+    int y; /**< Y coordinate. */
+};
+
+/** Thread that last formatted a Point. */
+static std::thread::id pointThread;
+
+/**
+ * \brief Insert into stream.
+ *
+ * \param os Output stream.
+ * \param p  Point.
+ * \return   Output stream.
+ */
+std::ostream& operator<<(std::ostream& os, const Point& p) {
+    pointThread = std::this_thread::get_id();
+    return os << '(' << p.x << ", " << p.y << ')';
+}
+
+/** Points may be deferred. */
+template<>
+struct gl::is_deferrable<Point> : std::true_type {};
+
+/**
+ * \brief Deferrable, but larger than the largest record.
+ */
+struct Big {
+    std::array<int, 512> v; /**< Values. */
+};
+
+/** Thread that last formatted a Big. */
+static std::thread::id bigThread;
+
+/**
+ * \brief Insert into stream.
+ *
+ * \param os Output stream.
+ * \param b  Big.
+ * \return   Output stream.
+ */
+std::ostream& operator<<(std::ostream& os, const Big& b) {
+    bigThread = std::this_thread::get_id();
+    return os << "<Big: " << b.v[0] << '>';
+}
+
+/** Bigs may be deferred. */
+template<>
+struct gl::is_deferrable<Big> : std::true_type {};
+
+/**
+ * \brief Not deferrable, since it refers to other memory.
+ */
+struct Ref {
+    const int* p; /**< Referred value. */
+};
+
+/**
+ * \brief Insert into stream.
+ *
+ * \param os Output stream.
+ * \param r  Reference.
+ * \return   Output stream.
+ */
+std::ostream& operator<<(std::ostream& os, const Ref& r) {
+    return os << "<Ref: " << *r.p << '>';
+}
+
+/**
+ * \brief Log many messages.
+ *
+ * \param n Number of messages.
+ */
+void log_many(int n) {
+    std::string s = "s";
+    for (int i = 0; i < n; ++i) {
+        l(i, s);
+    }
+}
+
+/**
+ * \brief Test entry point.
+ *
+ * \param argc Number of arguments.
+ * \param argv Arguments.
+ * \return EXIT_SUCCESS if success.
+ */
+int main(int argc, const char** argv) {
+    // Check number of arguments
+    if (argc != 1) {
+        std::cout << "Usage: " << *argv << std::endl;
+        return EXIT_SUCCESS;
+    }
+
+    // Disable prefixes for easier output comparison.
+    gl::set_prefixes(gl::prefix::NONE);
+    gl::set_suppressed_summary_enabled(true);
+
+    Test t;
+    t.setup(__FILE__);
+
+    gl::set_deferred_enabled(true);
+    if (!gl::is_deferred_enabled()) {
+        std::cout << "Failed to enable deferred formatting" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Formatted when logged, since writer thread isn't running
+    int i = 1;
+    l(i);
+
+    gl::set_async_enabled(true);
+
+    // Copies are formatted, not the variables as they are later
+    std::string                s = "before";
+    std::vector<int>           v = {1, 2, 3};
+    std::map<int, std::string> m = {{1, "a"}};
+    char                       buf[16];
+    std::strcpy(buf, "before");
+    const char* p  = buf;
+    const char* np = nullptr;
+    char*       nc = nullptr;
+    Point       pt = {1, 2};
+    l(s, v, m);
+    l(p, np, nc, pt);
+    s = "after";
+    v.push_back(4);
+    m[2] = "b";
+    std::strcpy(buf, "after");
+    pt.x = 3;
+    l(s, v, m, p, pt);
+
+    // Formatted when logged
+    int r    = 5;
+    Ref rf   = {&r};
+    int a[2] = {7, 8};
+    l(i, rf);
+    l_arr(a, 2);
+    for (int k = 0; k < 3; ++k) {
+        l_every_n(2, k);
+    }
+
+    // Formatted when logged, since the copy doesn't fit in a record
+    Big big{};
+    big.v[0] = 9;
+    l(big);
+    if (bigThread != std::this_thread::get_id()) {
+        std::cout << "Big not formatted when logged" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Memory of records is recycled, also across threads
+    std::stringstream many;
+    gl::set_sink(std::make_shared<gl::OstreamSink>(many));
+    std::thread t1(log_many, 5000);
+    std::thread t2(log_many, 5000);
+    t1.join();
+    t2.join();
+    gl::set_async_enabled(false);
+    gl::set_sink(nullptr);
+    std::string line;
+    int         n = 0;
+    while (std::getline(many, line)) {
+        ++n;
+    }
+    l(n);
+
+    if (pointThread == std::this_thread::get_id()) {
+        std::cout << "Point not formatted by writer thread" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    gl::set_deferred_enabled(false);
+
+    // Compare output
+    return t.compare_output(Test::ComparisonMode::EXACT);
+}
@@ -0,0 +1,89 @@
+#include "goinglogging.h"
+#include "test/test.h"
+#include <iostream>
+#include <memory>
+#include <sstream>
+
+/**
+ * \file
+ * Test sinks added by gl::add_sink().
+ */
+
+using namespace gl::test;
+
+/**
+ * \brief Log variables.
+ *
+ * \param i Integer.
+ * \param a Array.
+ * \param m Matrix.
+ */
+void log(int i, int a[2], int m[2][2]) {
+    l(i);
+    l_arr(a, 2);
+    l_mat(m, 2, 2);
+}
+
+/**
+ * \brief Test entry point.
+ *
+ * \param argc Number of arguments.
+ * \param argv Arguments.
+ * \return EXIT_SUCCESS if success.
+ */
+int main(int argc, const char** argv) {
+    // Check number of arguments
+    if (argc != 1) {
+        std::cout << "Usage: " << *argv << std::endl;
+        return EXIT_SUCCESS;
+    }
+
+    // Disable prefixes for easier output comparison.
+    gl::set_prefixes(gl::prefix::NONE);
+
+    Test t;
+    t.setup(__FILE__);
+
+    int i       = 0;
+    int a[2]    = {0, 1};
+    int m[2][2] = {{0, 1}, {2, 3}};
+
+    // Own prefixes and color per added sink, main sink unchanged
+    std::ostringstream plain;
+    std::ostringstream colored;
+    auto plainSink   = std::make_shared<gl::OstreamSink>(plain);
+    auto coloredSink = std::make_shared<gl::OstreamSink>(colored);
+    gl::add_sink(plainSink, gl::prefix::FUNCTION);
+    gl::add_sink(coloredSink, gl::prefix::NONE, true);
+    log(i, a, m);
+
+    // Added sinks keep output enabled without main sink
+    gl::set_sink(std::make_shared<gl::NullSink>());
+    i++;
+    log(i, a, m);
+    gl::set_sink(nullptr);
+
+    // Asynchronous and deferred main sink
+    gl::set_async_enabled(true);
+    gl::set_deferred_enabled(true);
+    i++;
+    log(i, a, m);
+    gl::set_async_enabled(false);
+    gl::set_deferred_enabled(false);
+
+    // Removed sink gets no more output
+    gl::remove_sink(coloredSink);
+    i++;
+    l(i);
+    gl::remove_sink(plainSink);
+    i++;
+    l(i);
+
+    std::cout << plain.str() << colored.str();
+    if (gl::get_dropped_count() != 0) {
+        std::cout << "Dropped messages" << std::endl;
+    }
+
+    // Compare output
+    return t.compare_output(Test::ComparisonMode::EXACT);
+}
@@ -0,0 +1,99 @@
+#include "goinglogging.h"
+#include "test/test.h"
+#include <iostream>
+
+/**
+ * \file
+ * Test filtering of call sites by file and function.
+ */
+
+using namespace gl::test;
+
+/** Number of times count() has been called. */
+static int nCalls = 0;
+
+/**
+ * \brief Count calls.
+ *
+ * \return Number of calls so far.
+ */
+int count() {
+    return ++nCalls;
+}
+
+/**
+ * \brief Log with all macros.
+ */
+void motor_update() {
+    int a[2]    = {1, 2};
+    int m[1][1] = {{3}};
+    l(count());
+    l_arr(a, 2);
+    l_mat(m, 1, 1);
+    l_info(count());
+    l_every_n(1, count());
+}
+
+/**
+ * \brief Log a variable.
+ */
+void run() {
+    l(count());
+}
+
+/**
+ * \brief Log in all functions.
+ */
+void log_all() {
+    std::cout << gl::get_filter() << std::endl;
+    motor_update();
+    run();
+}
+
+/**
+ * \brief Test entry point.
+ *
+ * \param argc Number of arguments.
+ * \param argv Arguments.
+ * \return EXIT_SUCCESS if success.
+ */
+int main(int argc, const char** argv) {
+    // Check number of arguments
+    if (argc != 1) {
+        std::cout << "Usage: " << *argv << std::endl;
+        return EXIT_SUCCESS;
+    }
+
+    // Disable prefixes for easier output comparison.
+    gl::set_prefixes(gl::prefix::NONE);
+
+    Test t;
+    t.setup(__FILE__);
+
+    // Everything
+    log_all();
+
+    // One function
+    gl::set_filter("filter.cpp:motor_*");
+    log_all();
+
+    // Cached verdict of sites is updated when filter changes
+    gl::set_filter("f?lter.*:run");
+    log_all();
+
+    // Any of several, with file only
+    gl::set_filter("other.cpp:*, *.cpp");
+    log_all();
+
+    // Nothing, and arguments aren't evaluated
+    gl::set_filter("other.cpp, filter.cpp:main");
+    log_all();
+    l(nCalls);
+
+    // Everything again
+    gl::set_filter("");
+    log_all();
+
+    // Compare output
+    return t.compare_output(Test::ComparisonMode::EXACT);
+}
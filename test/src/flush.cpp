@@ -0,0 +1,191 @@
+#include "goinglogging.h"
+#include "test/test.h"
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#ifndef _WIN32
+#include <csignal>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif // _WIN32
+
+/**
+ * \file
+ * Test flush policy.
+ */
+
+using namespace gl::test;
+
+/** File written by crashing child process. */
+static const char* fileName = "tmp_flush_file.txt";
+
+/**
+ * \brief Sink counting flushes.
+ */
+class CountingSink : public gl::Sink {
+  public:
+    /**
+     * \brief Constructor.
+     */
+    CountingSink() : m_mutex(), m_text(), m_flushed(), m_flushes(0) {
+    }
+
+    /**
+     * \brief Write to buffer.
+     *
+     * \param data Characters [\p len].
+     * \param len  Number of characters.
+     */
+    void write(const char* data, size_t len) override {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_text.append(data, len);
+    }
+
+    /**
+     * \brief Count flush.
+     */
+    void flush() override {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_flushed = m_text;
+        ++m_flushes;
+    }
+
+    /**
+     * \return Number of flushes.
+     */
+    int get_flushes() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_flushes;
+    }
+
+    /**
+     * \return Number of lines written when last flushed.
+     */
+    size_t get_flushed_lines() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        size_t n = 0;
+        for (char c : m_flushed) {
+            n += c == '\n' ? 1 : 0;
+        }
+        return n;
+    }
+
+  private:
+    std::mutex  m_mutex;   /**< Protects members. */
+    std::string m_text;    /**< Written text. */
+    std::string m_flushed; /**< Text when last flushed. */
+    int         m_flushes; /**< Number of flushes. */
+};
+
+#ifndef _WIN32
+/**
+ * \brief Log to a large file buffer in a child process that aborts.
+ *
+ * \return Contents of file.
+ */
+std::string crash_child() {
+    std::remove(fileName);
+    pid_t pid = fork();
+    if (pid == 0) {
+        gl::set_sink(std::make_shared<gl::BufferedFileSink>(fileName));
+        gl::set_crash_flush_enabled(true);
+        int crash = 1;
+        l(crash);
+        std::abort();
+    }
+    int status = 0;
+    waitpid(pid, &status, 0);
+    if (!WIFSIGNALED(status) || WTERMSIG(status) != SIGABRT) {
+        return "Child did not abort";
+    }
+    std::ifstream     f(fileName);
+    std::stringstream ss;
+    ss << f.rdbuf();
+    f.close();
+    std::remove(fileName);
+    return ss.str();
+}
+#endif // _WIN32
+
+/**
+ * \brief Test entry point.
+ *
+ * \param argc Number of arguments.
+ * \param argv Arguments.
+ * \return EXIT_SUCCESS if success.
+ */
+int main(int argc, const char** argv) {
+    // Check number of arguments
+    if (argc != 1) {
+        std::cout << "Usage: " << *argv << std::endl;
+        return EXIT_SUCCESS;
+    }
+
+    // Disable prefixes for easier output comparison.
+    gl::set_prefixes(gl::prefix::NONE);
+
+    Test t;
+    t.setup(__FILE__);
+
+#ifndef _WIN32
+    // Before any thread is started
+    std::string crashed = crash_child();
+    if (crashed != "crash = 1\n") {
+        std::cout << "Not flushed on crash: " << crashed << std::endl;
+        return EXIT_FAILURE;
+    }
+#endif // _WIN32
+
+    auto s = std::make_shared<CountingSink>();
+    gl::set_sink(s);
+    const int initial = s->get_flushes();
+
+    // Not flushed by default
+    for (int i = 0; i < 8; ++i) {
+        l(i);
+    }
+    const int unflushed = s->get_flushes() - initial;
+
+    // Flushed when 20 bytes are pending, i.e. after each 4th message
+    gl::set_flush_bytes(20);
+    for (int i = 0; i < 8; ++i) {
+        l(i);
+    }
+    const int bytes = s->get_flushes() - initial;
+
+    // Flushed when the interval has passed
+    gl::set_flush_bytes(0);
+    gl::set_flush_interval(10);
+    l(unflushed, bytes);
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (s->get_flushes() - initial == bytes &&
+           std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    const int interval = s->get_flushes() - initial - bytes;
+
+    // Explicit flush waits for asynchronous output
+    gl::set_flush_interval(0);
+    gl::set_flush_bytes(1024 * 1024);
+    gl::set_async_enabled(true);
+    for (int i = 0; i < 100; ++i) {
+        l(i);
+    }
+    gl::flush();
+    const size_t lines = s->get_flushed_lines();
+    gl::set_async_enabled(false);
+    gl::set_flush_bytes(0);
+
+    gl::set_sink(nullptr);
+    l(unflushed, bytes, interval, lines);
+    l(gl::get_flush_bytes(), gl::get_flush_interval());
+
+    // Compare output
+    return t.compare_output(Test::ComparisonMode::EXACT);
+}
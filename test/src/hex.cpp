@@ -0,0 +1,90 @@
+#include "goinglogging.h"
+#include "test/test.h"
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+/**
+ * \file
+ * Test logging of bytes.
+ */
+
+using namespace gl::test;
+
+/**
+ * \brief Test entry point.
+ *
+ * \param argc Number of arguments.
+ * \param argv Arguments.
+ * \return EXIT_SUCCESS if success.
+ */
+int main(int argc, const char** argv) {
+    // Check number of arguments
+    if (argc != 1) {
+        std::cout << "Usage: " << *argv << std::endl;
+        return EXIT_SUCCESS;
+    }
+
+    // Disable prefixes for easier output comparison.
+    gl::set_prefixes(gl::prefix::NONE);
+
+    Test t;
+    t.setup(__FILE__);
+
+    const char buf[] = "Hello, world";
+    l_hex(buf, sizeof(buf));
+    l_bytes(buf, sizeof(buf));
+
+    // All byte values, more than one block of 16
+    std::vector<unsigned char> all(256);
+    for (size_t i = 0; i < all.size(); ++i) {
+        all[i] = static_cast<unsigned char>(i);
+    }
+    l_hex(all.data(), 40);
+    l_bytes(all.data() + 120, 20);
+    l_bytes(all.data(), 0);
+    l_hex(all.data(), 0);
+
+    // Width
+    gl::set_hex_width(8);
+    if (gl::get_hex_width() != 8) {
+        std::cout << "Failed to set width" << std::endl;
+        return EXIT_FAILURE;
+    }
+    l_hex(buf, sizeof(buf));
+    gl::set_hex_width(0);
+    if (gl::get_hex_width() != 16) {
+        std::cout << "Failed to set default width" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Truncation keeps whole lines
+    gl::set_max_bytes(40);
+    if (gl::get_max_bytes() != 40) {
+        std::cout << "Failed to set maximum number of bytes" << std::endl;
+        return EXIT_FAILURE;
+    }
+    l_hex(all.data(), all.size());
+    l_bytes(all.data(), 100);
+    l_hex(all.data(), 41);
+    gl::set_max_bytes(0);
+
+    // As JSON
+    gl::set_format(gl::format::JSON);
+    l_bytes(buf, 4);
+    l_hex(buf, 4);
+    gl::set_format(gl::format::TEXT);
+
+    // Arguments aren't evaluated if not output
+    int calls = 0;
+    gl::set_output_enabled(false);
+    l_hex((++calls, buf), sizeof(buf));
+    gl::set_output_enabled(true);
+    if (calls != 0) {
+        std::cout << "Evaluated arguments" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Compare output
+    return t.compare_output(Test::ComparisonMode::EXACT);
+}
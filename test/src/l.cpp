@@ -1,5 +1,6 @@
 #include "goinglogging.h"
 #include "test/test.h"
+#include <algorithm>
 
 /**
  * \file
@@ -62,6 +63,18 @@ int main(int argc, const char** argv) {
     l(i0, i1, i2, i3, i4, i5, i6, i7, i8, i9, i10, i11, i12, i13, i14);
     l(i0, i1, i2, i3, i4, i5, i6, i7, i8, i9, i10, i11, i12, i13, i14, i15);
 
+    // More than 16 variables
+    int i16 = 16;
+    l(i0, i1, i2, i3, i4, i5, i6, i7, i8, i9, i10, i11, i12, i13, i14, i15,
+        i16);
+    l(i0, i1, i2, i3, i4, i5, i6, i7, i8, i9, i10, i11, i12, i13, i14, i15,
+        i16, i0, i1, i2, i3, i4, i5, i6, i7, i8, i9, i10, i11, i12, i13, i14,
+        i15, i16);
+
+    // Names with commas and white space
+    int arr[2] = {5, 6};
+    l(arr[0], std::max(i1, i2), "a, (b)",   arr[1]);
+
     const char* s1 = "s1";
     const char* s2 = "s2";
 
@@ -2,6 +2,7 @@
 #include "test/test.h"
 #include <iostream>
 #include <ostream>
+#include <vector>
 
 /**
  * \file
@@ -39,6 +40,19 @@ int main(int argc, const char** argv) {
     l_arr(a, 3);
     l_arr(b, 3);
 
+    // Numbers
+    double c[3] = {0.5, -1.25, 1e20};
+    long   d[3] = {-1, 0, 1234567890};
+    l_arr(c, 3);
+    l_arr(d, 3);
+
+    // More values than fit in one formatting block
+    std::vector<int> e(1000);
+    for (size_t i = 0; i < e.size(); ++i) {
+        e[i] = static_cast<int>(i) - 500;
+    }
+    l_arr(e, e.size());
+
     // Compare output
     return t.compare_output(Test::ComparisonMode::EXACT);
 }
\ No newline at end of file
@@ -42,6 +42,15 @@ int main(int argc, const char** argv) {
     l_mat(a, 2, 2);
     l_mat(b, 2, 2);
 
+    // More values than fit in one formatting block
+    float c[20][20];
+    for (int i = 0; i < 20; ++i) {
+        for (int j = 0; j < 20; ++j) {
+            c[i][j] = static_cast<float>(i) - 0.25F * static_cast<float>(j);
+        }
+    }
+    l_mat(c, 20, 20);
+
     // Compare output
     return t.compare_output(Test::ComparisonMode::EXACT);
 }
\ No newline at end of file
@@ -0,0 +1,74 @@
+#include "goinglogging.h"
+#include "test/test.h"
+#include <iostream>
+#include <ostream>
+#include <vector>
+
+/**
+ * \file
+ * Test output of l_mat_flat() and matrix_format::GRID.
+ */
+
+using namespace gl::test;
+
+/**
+ * \brief Test entry point.
+ *
+ * \param argc Number of arguments.
+ * \param argv Arguments.
+ * \return EXIT_SUCCESS if success.
+ */
+int main(int argc, const char** argv) {
+    // Check number of arguments
+    if (argc != 1) {
+        std::cout << "Usage: " << *argv << std::endl;
+        return EXIT_SUCCESS;
+    }
+
+    // Disable prefixes for easier output comparison.
+    gl::set_prefixes(gl::prefix::NONE);
+
+    Test t;
+    t.setup(__FILE__);
+
+    // Rows of 3 values, padded to 4
+    const float r[] = {0, 1, 2, -1, 3, 4, 5, -1};
+    // Columns of 2 values
+    int                c[] = {0, 3, 1, 4, 2, 5};
+    std::vector<short> v(c, c + 6);
+
+    l_mat_flat(r, 3, 2, 4, gl::layout::ROW_MAJOR);
+    l_mat_flat(c, 3, 2, 2, gl::layout::COLUMN_MAJOR);
+    l_mat_flat(v.data(), 3, 2, 2, gl::layout::COLUMN_MAJOR);
+    l_mat_flat(c, 0, 2, 2, gl::layout::COLUMN_MAJOR);
+
+    gl::set_prefixes(gl::prefix::TYPE_NAME);
+    l_mat_flat(r, 3, 2, 4, gl::layout::ROW_MAJOR);
+    gl::set_prefixes(gl::prefix::NONE);
+
+    // One line per row
+    gl::set_matrix_format(gl::matrix_format::GRID);
+    int         a[2][2] = {{0, 1}, {2, 3}};
+    const char* b[2][2] = {{"a", "b"}, {"c", "d"}};
+    l_mat(a, 2, 2);
+    l_mat(b, 2, 2);
+    l_mat_flat(r, 3, 2, 4, gl::layout::ROW_MAJOR);
+    l_mat_flat(c, 3, 2, 2, gl::layout::COLUMN_MAJOR);
+    l_mat_flat(c, 0, 2, 2, gl::layout::COLUMN_MAJOR);
+
+    // Rows and, if a row alone is too long, columns are left out
+    int d[6][6];
+    for (int i = 0; i < 6; ++i) {
+        for (int j = 0; j < 6; ++j) {
+            d[i][j] = 10 * i + j;
+        }
+    }
+    l_mat_n(d, 6, 6, 12);
+    l_mat_n(d, 6, 6, 4);
+    l_mat_n(d, 6, 1, 4);
+    gl::set_matrix_format(gl::matrix_format::INDEXED);
+    l_mat_n(d, 6, 6, 4);
+
+    // Compare output
+    return t.compare_output(Test::ComparisonMode::EXACT);
+}
@@ -0,0 +1,137 @@
+#include "goinglogging.h"
+#include "test/test.h"
+#include <iostream>
+#include <memory>
+
+/**
+ * \file
+ * Test that no argument of a logging message is evaluated unless the message
+ * is output.
+ */
+
+using namespace gl::test;
+
+/** Number of times an argument has been evaluated. */
+static int nCalls = 0;
+
+/** Array returned by array(). */
+static int a[2] = {1, 2};
+
+/** Matrix returned by matrix(). */
+static int m[2][2] = {{1, 2}, {3, 4}};
+
+/**
+ * \brief Count calls.
+ *
+ * \return Number of calls so far.
+ */
+int count() {
+    return ++nCalls;
+}
+
+/**
+ * \brief Count calls.
+ *
+ * \return 2.
+ */
+size_t two() {
+    ++nCalls;
+    return 2;
+}
+
+/**
+ * \brief Count calls.
+ *
+ * \return Array.
+ */
+int* array() {
+    ++nCalls;
+    return a;
+}
+
+/**
+ * \brief Count calls.
+ *
+ * \return Matrix.
+ */
+int (*matrix())[2] {
+    ++nCalls;
+    return m;
+}
+
+/**
+ * \brief Log with all macros, with arguments that count their evaluation.
+ */
+void log_all() {
+    l(count());
+    l(two(), count() > 0);
+    l_arr(array(), two());
+    l_arr_n(array(), two(), two());
+    l_mat(matrix(), two(), two());
+    l_mat_n(matrix(), two(), two(), two());
+    l_info(count());
+    l_arr_info(array(), two());
+    l_mat_info(matrix(), two(), two());
+    l_every_n(two(), count());
+    l_every_ms(two(), count());
+    l_when(two() > 0, count());
+}
+
+/**
+ * \brief Test entry point.
+ *
+ * \param argc Number of arguments.
+ * \param argv Arguments.
+ * \return EXIT_SUCCESS if success.
+ */
+int main(int argc, const char** argv) {
+    // Check number of arguments
+    if (argc != 1) {
+        std::cout << "Usage: " << *argv << std::endl;
+        return EXIT_SUCCESS;
+    }
+
+    // Disable prefixes for easier output comparison.
+    gl::set_prefixes(gl::prefix::NONE);
+
+    Test t;
+    t.setup(__FILE__);
+
+    // Output disabled
+    gl::set_output_enabled(false);
+    log_all();
+    gl::set_output_enabled(true);
+    l(nCalls);
+
+    // Sink discards output
+    gl::set_sink(std::make_shared<gl::NullSink>());
+    log_all();
+    gl::set_sink(nullptr);
+    l(nCalls);
+
+    // Level disabled
+    gl::set_level(gl::level::L_WARNING);
+    for (int i = 0; i < 2; ++i) {
+        l_info(count());
+        l_arr_info(array(), 2);
+        l_mat_info(matrix(), 2, 2);
+    }
+    gl::set_level(gl::level::L_TRACE);
+    l(nCalls);
+
+    // Suppressed by call site state. Only the first message passes.
+    for (int i = 0; i < 3; ++i) {
+        l_every_n(4, count());
+        l_once(count());
+        l_when(i == 0, count());
+    }
+    l(nCalls);
+
+    // Everything evaluated once when output
+    nCalls = 0;
+    log_all();
+    l(nCalls);
+
+    // Compare output
+    return t.compare_output(Test::ComparisonMode::EXACT);
+}
@@ -0,0 +1,110 @@
+#include <iostream>
+
+/** Compile out trace and debug levels */
+#define GL_ACTIVE_LEVEL GL_LEVEL_INFO
+/** Common macros that must not clash with level names */
+#define DEBUG 1
+#define ERROR 0
+#include "goinglogging.h"
+#include "test/test.h"
+
+/**
+ * \file
+ * Test severity levels, both at compile time and at runtime.
+ */
+
+using namespace gl::test;
+
+/** Number of times count() has been called. */
+static int nCalls = 0;
+
+/**
+ * \brief Count calls.
+ *
+ * \return Number of calls so far.
+ */
+int count() {
+    return ++nCalls;
+}
+
+/**
+ * \brief Log variables at all levels.
+ *
+ * \param i Integer.
+ * \param a Array.
+ * \param m Matrix.
+ */
+void log(int i, int a[1], int m[1][1]) {
+    l_trace(i, count());
+    l_debug(i, count());
+    l_info(i);
+    l_warning(i);
+    l_error(i);
+    l_arr_trace(a, 1);
+    l_arr_debug(a, 1);
+    l_arr_info(a, 1);
+    l_arr_warning(a, 1);
+    l_arr_error(a, 1);
+    l_mat_trace(m, 1, 1);
+    l_mat_debug(m, 1, 1);
+    l_mat_info(m, 1, 1);
+    l_mat_warning(m, 1, 1);
+    l_mat_error(m, 1, 1);
+    l(i);
+}
+
+/**
+ * \brief Test entry point.
+ *
+ * \param argc Number of arguments.
+ * \param argv Arguments.
+ * \return EXIT_SUCCESS if success.
+ */
+int main(int argc, const char** argv) {
+    // Check number of arguments
+    if (argc != 1) {
+        std::cout << "Usage: " << *argv << std::endl;
+        return EXIT_SUCCESS;
+    }
+
+    // Disable prefixes for easier output comparison.
+    gl::set_prefixes(gl::prefix::NONE);
+
+    Test t;
+    t.setup(__FILE__);
+
+    int i       = 0;
+    int a[1]    = {0};
+    int m[1][1] = {{0}};
+
+    // Compiled out, even though runtime level allows them
+    gl::set_level(gl::level::L_TRACE);
+    log(i, a, m);
+
+    // Runtime filtering
+    i++;
+    gl::set_level(gl::level::L_ERROR);
+    if (gl::get_level() != gl::level::L_ERROR) {
+        std::cout << "Failed to set level" << std::endl;
+        return EXIT_FAILURE;
+    }
+    log(i, a, m);
+
+    // Only l() remains
+    i++;
+    gl::set_level(gl::level::L_OFF);
+    log(i, a, m);
+
+    // Nothing
+    i++;
+    gl::set_level(gl::level::L_TRACE);
+    gl::set_output_enabled(false);
+    log(i, a, m);
+    gl::set_output_enabled(true);
+
+    // Arguments of compiled out levels shall never be evaluated
+    l(nCalls);
+
+    // Compare output
+    return t.compare_output(Test::ComparisonMode::EXACT);
+}
@@ -0,0 +1,90 @@
+#include "goinglogging.h"
+#include "test/test.h"
+#include <forward_list>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * \file
+ * Test maximum number of elements of containers, arrays and matrices.
+ */
+
+using namespace gl::test;
+
+/**
+ * \brief Log containers, arrays and matrices.
+ */
+void log_all() {
+    std::vector<int>           v  = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    std::forward_list<double>  fl = {0.5, 1.5, 2.5, 3.5, 4.5, 5.5};
+    std::map<int, std::string> m  = {
+        {1, "a"}, {2, "b"}, {3, "c"}, {4, "d"}, {5, "e"}};
+    std::vector<std::string> strs = {"a", "b", "c", "d", "e", "f"};
+    l(v);
+    l(fl);
+    l(m);
+    l(strs);
+
+    int a[10] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    l_arr(a, 10);
+    l_arr_n(a, 10, 0);
+    l_arr_n(a, 10, 3);
+
+    const char* b[4] = {"a", "b", "c", "d"};
+    l_arr(b, 4);
+
+    int mat[3][3] = {{0, 1, 2}, {3, 4, 5}, {6, 7, 8}};
+    l_mat(mat, 3, 3);
+    l_mat_n(mat, 3, 3, 2);
+}
+
+/**
+ * \brief Test entry point.
+ *
+ * \param argc Number of arguments.
+ * \param argv Arguments.
+ * \return EXIT_SUCCESS if success.
+ */
+int main(int argc, const char** argv) {
+    // Check number of arguments
+    if (argc != 1) {
+        std::cout << "Usage: " << *argv << std::endl;
+        return EXIT_SUCCESS;
+    }
+
+    // Disable prefixes for easier output comparison.
+    gl::set_prefixes(gl::prefix::NONE);
+
+    Test t;
+    t.setup(__FILE__);
+
+    // No limit
+    log_all();
+
+    gl::set_max_elements(4);
+    if (gl::get_max_elements() != 4) {
+        std::cout << "Failed to set maximum number of elements" << std::endl;
+        return EXIT_FAILURE;
+    }
+    log_all();
+
+    // Odd number of elements, and only one
+    gl::set_max_elements(5);
+    log_all();
+    gl::set_max_elements(1);
+    log_all();
+
+    // Summary of numbers
+    gl::set_max_elements(4);
+    gl::set_truncation(gl::truncation::SUMMARIZE);
+    if (gl::get_truncation() != gl::truncation::SUMMARIZE) {
+        std::cout << "Failed to set truncation" << std::endl;
+        return EXIT_FAILURE;
+    }
+    log_all();
+
+    // Compare output
+    return t.compare_output(Test::ComparisonMode::EXACT);
+}
@@ -0,0 +1,57 @@
+#include "goinglogging.h"
+#include "test/test.h"
+#include <iostream>
+
+/**
+ * \file
+ * Test that settings are shared by translation units. Linked with
+ * multi_tu_second.cpp.
+ */
+
+using namespace gl::test;
+
+void log_second(int i);
+void configure_second();
+
+/**
+ * \brief Test entry point.
+ *
+ * \param argc Number of arguments.
+ * \param argv Arguments.
+ * \return EXIT_SUCCESS if success.
+ */
+int main(int argc, const char** argv) {
+    // Check number of arguments
+    if (argc != 1) {
+        std::cout << "Usage: " << *argv << std::endl;
+        return EXIT_SUCCESS;
+    }
+
+    // Disable prefixes for easier output comparison.
+    gl::set_prefixes(gl::prefix::NONE);
+
+    Test t;
+    t.setup(__FILE__);
+
+    // Settings from this unit
+    log_second(1);
+    gl::set_output_enabled(false);
+    log_second(2);
+    gl::set_output_enabled(true);
+
+    // Settings from the other unit
+    configure_second();
+    if (gl::get_prefixes() != gl::prefix::LINE ||
+        gl::get_level() != gl::level::L_WARNING) {
+        std::cout << "Settings not shared" << std::endl;
+        return EXIT_FAILURE;
+    }
+    int i = 3;
+    l(i);
+    l_info(i);
+    gl::set_prefixes(gl::prefix::NONE);
+    log_second(4);
+
+    // Compare output
+    return t.compare_output(Test::ComparisonMode::EXACT);
+}
@@ -0,0 +1,24 @@
+#include "goinglogging.h"
+
+/**
+ * \file
+ * Second translation unit of the multi_tu test.
+ */
+
+/**
+ * \brief Log from this translation unit.
+ *
+ * \param i Value to log.
+ */
+void log_second(int i) {
+    l(i);
+    l_info(i);
+}
+
+/**
+ * \brief Change settings from this translation unit.
+ */
+void configure_second() {
+    gl::set_prefixes(gl::prefix::LINE);
+    gl::set_level(gl::level::L_WARNING);
+}
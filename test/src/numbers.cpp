@@ -0,0 +1,103 @@
+#include "goinglogging.h"
+#include "test/test.h"
+#include <cstdint>
+#include <iostream>
+#include <limits>
+
+/**
+ * \file
+ * Test formatting of integer and floating point values.
+ */
+
+using namespace gl::test;
+
+/**
+ * \brief Log integer values.
+ */
+void log_integers() {
+    int i0 = 0;
+    int i1 = 7;
+    int i2 = -42;
+    int i3 = 100;
+    int i4 = -1000001;
+    l(i0, i1, i2, i3, i4);
+
+    short          s_min = std::numeric_limits<short>::min();
+    unsigned short us_max = std::numeric_limits<unsigned short>::max();
+    l(s_min, us_max);
+
+    int32_t  i32_min = std::numeric_limits<int32_t>::min();
+    int32_t  i32_max = std::numeric_limits<int32_t>::max();
+    uint32_t u32_max = std::numeric_limits<uint32_t>::max();
+    l(i32_min, i32_max, u32_max);
+
+    int64_t  i64_min = std::numeric_limits<int64_t>::min();
+    int64_t  i64_max = std::numeric_limits<int64_t>::max();
+    uint64_t u64_max = std::numeric_limits<uint64_t>::max();
+    l(i64_min, i64_max, u64_max);
+
+    // Around 13 and 17 digits, converted 16 digits at a time with SSE2
+    uint64_t e12_m1 = 999999999999u;
+    uint64_t e12    = 1000000000000u;
+    uint64_t e16_m1 = 9999999999999999u;
+    uint64_t e16    = 10000000000000000u;
+    int64_t  ns     = -1760000000123456789;
+    l(e12_m1, e12, e16_m1, e16, ns);
+}
+
+/**
+ * \brief Log floating point values.
+ */
+void log_floating() {
+    double d0 = 0.0;
+    double d1 = -0.0;
+    double d2 = 0.1;
+    double d3 = 1.0 / 3.0;
+    double d4 = 1e20;
+    double d5 = -2.5e-300;
+    l(d0, d1, d2, d3, d4, d5);
+
+    float f0 = 0.1F;
+    float f1 = 16777216.0F;
+    float f2 = 1.0F / 3.0F;
+    l(f0, f1, f2);
+
+    double inf     = std::numeric_limits<double>::infinity();
+    double neg_inf = -inf;
+    l(inf, neg_inf);
+}
+
+/**
+ * \brief Test entry point.
+ *
+ * \param argc Number of arguments.
+ * \param argv Arguments.
+ * \return EXIT_SUCCESS if success.
+ */
+int main(int argc, const char** argv) {
+    // Check number of arguments
+    if (argc != 1) {
+        std::cout << "Usage: " << *argv << std::endl;
+        return EXIT_SUCCESS;
+    }
+
+    // Disable prefixes for easier output comparison.
+    gl::set_prefixes(gl::prefix::NONE);
+
+    Test t;
+    t.setup(__FILE__);
+
+    log_integers();
+    log_floating();
+
+    // Shortest output that reads back to the same value
+    gl::set_float_format(gl::float_format::ROUND_TRIP);
+    if (gl::get_float_format() != gl::float_format::ROUND_TRIP) {
+        std::cout << "Failed to set float format" << std::endl;
+        return EXIT_FAILURE;
+    }
+    log_floating();
+
+    // Compare output
+    return t.compare_output(Test::ComparisonMode::EXACT);
+}
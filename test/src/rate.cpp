@@ -0,0 +1,81 @@
+#include "goinglogging.h"
+#include "test/test.h"
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+/**
+ * \file
+ * Test rate limited logging.
+ */
+
+using namespace gl::test;
+
+/**
+ * \brief Log with every rate limiting macro.
+ *
+ * \param n Number of iterations.
+ */
+void log_rates(int n) {
+    for (int i = 0; i < n; ++i) {
+        l_every_n(4, i);
+    }
+    for (int i = 0; i < n; ++i) {
+        l_once(i);
+    }
+    for (int i = 0; i < n; ++i) {
+        l_when(i % 3 == 2, i);
+    }
+    for (int i = 0; i < n; ++i) {
+        // Long enough interval to only pass once
+        l_every_ms(1000000, i);
+    }
+}
+
+/**
+ * \brief Test entry point.
+ *
+ * \param argc Number of arguments.
+ * \param argv Arguments.
+ * \return EXIT_SUCCESS if success.
+ */
+int main(int argc, const char** argv) {
+    // Check number of arguments
+    if (argc != 1) {
+        std::cout << "Usage: " << *argv << std::endl;
+        return EXIT_SUCCESS;
+    }
+
+    // Disable prefixes for easier output comparison.
+    gl::set_prefixes(gl::prefix::NONE);
+
+    Test t;
+    t.setup(__FILE__);
+
+    log_rates(10);
+
+    // Same call sites, with number of suppressed messages
+    gl::set_suppressed_summary_enabled(true);
+    if (!gl::is_suppressed_summary_enabled()) {
+        std::cout << "Failed to enable summary" << std::endl;
+        return EXIT_FAILURE;
+    }
+    log_rates(10);
+
+    // Interval passes
+    for (int i = 0; i < 3; ++i) {
+        l_every_ms(100, i);
+        if (i == 1) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(150));
+        }
+    }
+
+    // Multiple variables, and an interval of 0
+    int j = 0;
+    for (int i = 0; i < 2; ++i) {
+        l_every_n(0, i, j);
+    }
+
+    // Compare output
+    return t.compare_output(Test::ComparisonMode::EXACT);
+}
@@ -0,0 +1,95 @@
+#include "goinglogging.h"
+#include "test/test.h"
+#include <csignal>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/**
+ * \file
+ * Test memory mapped ring buffer sink.
+ */
+
+using namespace gl::test;
+
+/** File written by ring sink. */
+static const char* fileName = "tmp_ring_file.bin";
+
+/**
+ * \brief Write contents of ring file to std::cout.
+ */
+void read() {
+    std::ifstream f(fileName, std::ios_base::binary);
+    gl::read_ring(f, std::cout);
+}
+
+/**
+ * \brief Test entry point.
+ *
+ * \param argc Number of arguments.
+ * \param argv Arguments.
+ * \return EXIT_SUCCESS if success.
+ */
+int main(int argc, const char** argv) {
+    // Check number of arguments
+    if (argc != 1) {
+        std::cout << "Usage: " << *argv << std::endl;
+        return EXIT_SUCCESS;
+    }
+
+    // Disable prefixes for easier output comparison.
+    gl::set_prefixes(gl::prefix::NONE);
+
+    Test t;
+    t.setup(__FILE__);
+
+    // Ring that doesn't wrap
+    gl::set_sink(std::make_shared<gl::RingFileSink>(fileName, 1024));
+    for (int i = 0; i < 3; ++i) {
+        l(i);
+    }
+    gl::set_sink(nullptr);
+    read();
+
+    // Ring that wraps several times. Read while still mapped.
+    gl::set_sink(std::make_shared<gl::RingFileSink>(fileName, 32));
+    for (int i = 0; i < 20; ++i) {
+        l(i);
+    }
+    read();
+    gl::set_sink(nullptr);
+
+    // Output survives a crash of the logging process
+    std::cout.flush();
+    pid_t pid = fork();
+    if (pid == 0) {
+        gl::set_sink(std::make_shared<gl::RingFileSink>(fileName, 1024));
+        int crash = 1;
+        l(crash);
+        std::raise(SIGKILL);
+    }
+    int status = 0;
+    waitpid(pid, &status, 0);
+    read();
+
+    // Other files are rejected
+    std::remove(fileName);
+    {
+        std::ofstream f(fileName);
+        f << "Not a ring";
+    }
+    try {
+        read();
+        std::cout << "Invalid file accepted" << std::endl;
+    } catch (const std::runtime_error& e) {
+        std::cout << e.what() << std::endl;
+    }
+    std::remove(fileName);
+
+    // Compare output
+    return t.compare_output(Test::ComparisonMode::EXACT);
+}
@@ -0,0 +1,92 @@
+#include "goinglogging.h"
+#include "test/test.h"
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+/**
+ * \file
+ * Test l_scope(), l_timer() and log_timers().
+ */
+
+using namespace gl::test;
+
+/**
+ * \brief Sleep, and log the time spent.
+ *
+ * \param ms Milliseconds.
+ */
+void nap(int ms) {
+    l_scope("nap");
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+/**
+ * \brief Count the time of a cheap call.
+ *
+ * \param n Calls per summary.
+ * \return Argument.
+ */
+int step(int n) {
+    l_timer("step", n);
+    return n;
+}
+
+/**
+ * \brief Test entry point.
+ *
+ * \param argc Number of arguments.
+ * \param argv Arguments.
+ * \return EXIT_SUCCESS if success.
+ */
+int main(int argc, const char** argv) {
+    // Check number of arguments
+    if (argc != 1) {
+        std::cout << "Usage: " << *argv << std::endl;
+        return EXIT_SUCCESS;
+    }
+
+    // Disable prefixes for easier output comparison.
+    gl::set_prefixes(gl::prefix::NONE);
+
+    Test t;
+    t.setup(__FILE__);
+
+    // Elapsed time
+    nap(2);
+    {
+        l_scope("empty");
+    }
+
+    // Nothing is measured if output is disabled on entry
+    gl::set_output_enabled(false);
+    nap(0);
+    gl::set_output_enabled(true);
+
+    // Summary every 4th call, then on demand
+    for (int i = 0; i < 10; ++i) {
+        step(4);
+    }
+    gl::log_timers();
+    gl::log_timers();
+
+    // Summaries on demand only
+    for (int i = 0; i < 10; ++i) {
+        step(0);
+    }
+    l(step(0));
+    gl::log_timers();
+
+    // Prefixes apply
+    gl::set_prefixes(gl::prefix::FUNCTION);
+    nap(0);
+
+    // Structured output
+    gl::set_prefixes(gl::prefix::NONE);
+    gl::set_format(gl::format::JSON);
+    nap(0);
+    gl::set_format(gl::format::TEXT);
+
+    // Compare output
+    return t.compare_output(Test::ComparisonMode::REGEX);
+}
@@ -0,0 +1,89 @@
+#include "goinglogging.h"
+#include "test/test.h"
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+
+/**
+ * \file
+ * Test configurable output sinks.
+ */
+
+using namespace gl::test;
+
+/** File written by file sink. */
+static const char* fileName = "tmp_sink_file.txt";
+
+/**
+ * \brief Log variables.
+ *
+ * \param i Integer.
+ * \param a Array.
+ * \param m Matrix.
+ */
+void log(int i, int a[2], int m[2][2]) {
+    l(i);
+    l_arr(a, 2);
+    l_mat(m, 2, 2);
+}
+
+/**
+ * \brief Test entry point.
+ *
+ * \param argc Number of arguments.
+ * \param argv Arguments.
+ * \return EXIT_SUCCESS if success.
+ */
+int main(int argc, const char** argv) {
+    // Check number of arguments
+    if (argc != 1) {
+        std::cout << "Usage: " << *argv << std::endl;
+        return EXIT_SUCCESS;
+    }
+
+    // Disable prefixes for easier output comparison.
+    gl::set_prefixes(gl::prefix::NONE);
+
+    Test t;
+    t.setup(__FILE__);
+
+    int i       = 0;
+    int a[2]    = {0, 1};
+    int m[2][2] = {{0, 1}, {2, 3}};
+
+    // Default sink
+    log(i, a, m);
+
+    // Discard, without disabling output
+    gl::set_sink(std::make_shared<gl::NullSink>());
+    if (!gl::is_output_enabled()) {
+        std::cout << "Null sink disabled output" << std::endl;
+        return EXIT_FAILURE;
+    }
+    i++;
+    log(i, a, m);
+
+    // Small buffer, so that file sink has to write more than once
+    gl::set_sink(std::make_shared<gl::BufferedFileSink>(fileName, 16));
+    i++;
+    log(i, a, m);
+
+    // Back to std::cout. This also closes the file.
+    gl::set_sink(nullptr);
+    i++;
+    log(i, a, m);
+
+    // Copy file contents to std::cout
+    {
+        std::ifstream f(fileName);
+        std::stringstream ss;
+        ss << f.rdbuf();
+        std::cout << ss.str();
+    }
+    std::remove(fileName);
+
+    // Compare output
+    return t.compare_output(Test::ComparisonMode::EXACT);
+}
@@ -0,0 +1,99 @@
+#include "goinglogging.h"
+#include "test/test.h"
+#include <iostream>
+#include <thread>
+
+/**
+ * \file
+ * Test counting of logging.
+ */
+
+using namespace gl::test;
+
+/**
+ * \brief Log a variable a number of times.
+ *
+ * \param n Number of times.
+ */
+void log_many(int n) {
+    for (int i = 0; i < n; ++i) {
+        l(i);
+    }
+}
+
+/**
+ * \brief Output counters, without time since it differs between runs.
+ */
+void output_stats() {
+    gl::Stats st = gl::get_stats();
+    std::cout << "calls = " << st.calls << ", bytes = " << st.bytes
+              << ", dropped = " << st.dropped
+              << ", suppressed = " << st.suppressed << std::endl;
+    for (const gl::SiteStats& s : st.sites) {
+        std::cout << s.file << ':' << s.line << ' ' << s.function
+                  << ": calls = " << s.calls << ", bytes = " << s.bytes
+                  << std::endl;
+    }
+}
+
+/**
+ * \brief Test entry point.
+ *
+ * \param argc Number of arguments.
+ * \param argv Arguments.
+ * \return EXIT_SUCCESS if success.
+ */
+int main(int argc, const char** argv) {
+    // Check number of arguments
+    if (argc != 1) {
+        std::cout << "Usage: " << *argv << std::endl;
+        return EXIT_SUCCESS;
+    }
+
+    // Disable prefixes for easier output comparison.
+    gl::set_prefixes(gl::prefix::NONE);
+
+    Test t;
+    t.setup(__FILE__);
+
+    // Not counted
+    log_many(2);
+    output_stats();
+
+    gl::set_stats_enabled(true);
+    if (!gl::is_stats_enabled()) {
+        std::cout << "Failed to enable stats" << std::endl;
+        return EXIT_FAILURE;
+    }
+    log_many(3);
+    int a[3] = {1, 2, 3};
+    l_arr(a, 3);
+    int m[2][2] = {{1, 2}, {3, 4}};
+    l_mat(m, 2, 2);
+    for (int i = 0; i < 4; ++i) {
+        l_every_n(2, i);
+    }
+    output_stats();
+
+    // Counters of exited threads remain, also when reused by a new thread
+    std::thread t1(log_many, 4);
+    t1.join();
+    std::thread t2(log_many, 1);
+    t2.join();
+    output_stats();
+
+    gl::Stats st = gl::get_stats();
+    if (st.nanoseconds == 0 || st.maxNanoseconds == 0 ||
+        st.maxNanoseconds > st.nanoseconds) {
+        std::cout << "Unexpected time spent logging" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Not counted
+    gl::set_stats_enabled(false);
+    log_many(2);
+    output_stats();
+
+    // Compare output
+    return t.compare_output(Test::ComparisonMode::EXACT);
+}
@@ -0,0 +1,95 @@
+#include "goinglogging.h"
+#include "test/test.h"
+#include <iostream>
+#include <limits>
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * \file
+ * Test JSON and CSV output.
+ */
+
+using namespace gl::test;
+
+/**
+ * \brief Log variables of many types.
+ */
+void log_all() {
+    int                i = -1;
+    unsigned long      u = 2;
+    double             d = 0.5;
+    double             n = std::numeric_limits<double>::infinity();
+    bool               b = true;
+    char               c = 'c';
+    const char*        p = "p";
+    char               t[] = "t";
+    std::string        s = "a \"b\", c\\\n";
+    std::vector<int>   v = {1, 2};
+    int                a[3]    = {1, 2, 3};
+    int                m[2][2] = {{1, 2}, {3, 4}};
+    std::map<int, int> mp      = {{1, 2}};
+    l(i, u, d, n, b);
+    l(c, p, t, "q", s);
+    l(v, mp["x"[0] - 'x']);
+    l_arr(a, 3);
+    l_mat(m, 2, 2);
+    for (int k = 0; k < 3; ++k) {
+        l_every_n(2, k);
+    }
+}
+
+/**
+ * \brief Test entry point.
+ *
+ * \param argc Number of arguments.
+ * \param argv Arguments.
+ * \return EXIT_SUCCESS if success.
+ */
+int main(int argc, const char** argv) {
+    // Check number of arguments
+    if (argc != 1) {
+        std::cout << "Usage: " << *argv << std::endl;
+        return EXIT_SUCCESS;
+    }
+
+    gl::set_prefixes(gl::prefix::FILE | gl::prefix::LINE |
+                     gl::prefix::FUNCTION | gl::prefix::TYPE_NAME);
+    gl::set_suppressed_summary_enabled(true);
+
+    Test t;
+    t.setup(__FILE__);
+
+    gl::set_format(gl::format::JSON);
+    if (gl::get_format() != gl::format::JSON) {
+        std::cout << "Failed to set format" << std::endl;
+        return EXIT_FAILURE;
+    }
+    log_all();
+
+    gl::set_format(gl::format::CSV);
+    log_all();
+
+    // Without prefixes
+    gl::set_prefixes(gl::prefix::NONE);
+    gl::set_format(gl::format::JSON);
+    log_all();
+    gl::set_format(gl::format::CSV);
+    log_all();
+
+    // Null C strings are empty strings
+    const char* np = nullptr;
+    char*       nc = nullptr;
+    int         i  = 1;
+    gl::set_format(gl::format::JSON);
+    l(np, nc, i);
+    gl::set_format(gl::format::CSV);
+    l(np, nc, i);
+    l(i);
+
+    gl::set_format(gl::format::TEXT);
+
+    // Compare output
+    return t.compare_output(Test::ComparisonMode::EXACT);
+}
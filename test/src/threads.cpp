@@ -0,0 +1,62 @@
+#include "goinglogging.h"
+#include "test/test.h"
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * \file
+ * Test that logging messages from concurrent threads don't interleave.
+ */
+
+using namespace gl::test;
+
+/** Number of logging threads. */
+static const int nThreads = 4;
+
+/** Number of messages per thread. */
+static const int nMessages = 50;
+
+/**
+ * \brief Log a long string a number of times.
+ */
+void log_many() {
+    std::string s(200, 'x');
+    for (int i = 0; i < nMessages; ++i) {
+        l(s);
+    }
+}
+
+/**
+ * \brief Test entry point.
+ *
+ * \param argc Number of arguments.
+ * \param argv Arguments.
+ * \return EXIT_SUCCESS if success.
+ */
+int main(int argc, const char** argv) {
+    // Check number of arguments
+    if (argc != 1) {
+        std::cout << "Usage: " << *argv << std::endl;
+        return EXIT_SUCCESS;
+    }
+
+    // Thread ID differs between runs, so compare it with regex. Type names
+    // are looked up concurrently.
+    gl::set_prefixes(gl::prefix::THREAD | gl::prefix::TYPE_NAME);
+
+    Test t;
+    t.setup(__FILE__);
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < nThreads; ++i) {
+        threads.emplace_back(log_many);
+    }
+    for (std::thread& th : threads) {
+        th.join();
+    }
+
+    // Compare output
+    return t.compare_output(Test::ComparisonMode::REGEX);
+}
@@ -0,0 +1,80 @@
+#include "goinglogging.h"
+#include "test/test.h"
+#include <iomanip>
+#include <iostream>
+#include <ostream>
+
+/**
+ * \file
+ * Test formats of time prefix.
+ */
+
+using namespace gl::test;
+
+/**
+ * \brief Value output with a width.
+ */
+struct Padded {
+    int v; /**< Value. */
+};
+
+/**
+ * \brief Insert into stream, padded to 3 characters.
+ *
+ * \param os Output stream.
+ * \param p  Padded value.
+ * \return   Output stream.
+ */
+std::ostream& operator<<(std::ostream& os, const Padded& p) {
+    return os << std::setw(3) << p.v;
+}
+
+/**
+ * \brief Test entry point.
+ *
+ * \param argc Number of arguments.
+ * \param argv Arguments.
+ * \return EXIT_SUCCESS if success.
+ */
+int main(int argc, const char** argv) {
+    // Check number of arguments
+    if (argc != 1) {
+        std::cout << "Usage: " << *argv << std::endl;
+        return EXIT_SUCCESS;
+    }
+
+    Test t;
+    t.setup(__FILE__);
+
+    int i = 0;
+
+    // Log each format twice, so that the cached second is used
+    gl::set_prefixes(gl::prefix::TIME);
+    for (gl::time_format f : {gl::time_format::LOCAL_MILLISECONDS,
+             gl::time_format::LOCAL_MICROSECONDS,
+             gl::time_format::MONOTONIC}) {
+        gl::set_time_format(f);
+        if (gl::get_time_format() != f) {
+            std::cout << "Failed to set time format" << std::endl;
+            return EXIT_FAILURE;
+        }
+        l(i);
+        l(i);
+    }
+
+    // Together with other prefixes
+    gl::set_time_format(gl::time_format::LOCAL_MILLISECONDS);
+    gl::set_prefixes(gl::prefix::LINE | gl::prefix::TIME | gl::prefix::THREAD);
+    l(i);
+
+    // Fill character of time shall not leak into formatting of values, nor
+    // fill and width of std::cout into time
+    Padded w = {7};
+    gl::set_prefixes(gl::prefix::TIME);
+    std::cout << std::setfill('*') << std::setw(20);
+    l(w);
+    std::cout << std::setfill(' ') << std::setw(0);
+
+    // Compare output
+    return t.compare_output(Test::ComparisonMode::REGEX);
+}
@@ -0,0 +1,80 @@
+#include "goinglogging.h"
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+/**
+ * \file
+ * Render binary logging output as text. See gl::set_format().
+ */
+
+/**
+ * \brief Parse name of prefix.
+ *
+ * \param name Name, e.g. "line".
+ * \param p    Output prefix.
+ * \return \c true if name is valid.
+ */
+static bool parse_prefix(const char* name, gl::prefix& p) {
+    static const struct {
+        const char* name;
+        gl::prefix  p;
+    } prefixes[] = {{"file", gl::prefix::FILE}, {"line", gl::prefix::LINE},
+        {"function", gl::prefix::FUNCTION}, {"time", gl::prefix::TIME},
+        {"thread", gl::prefix::THREAD}, {"type_name", gl::prefix::TYPE_NAME}};
+    for (const auto& e : prefixes) {
+        if (std::strcmp(name, e.name) == 0) {
+            p = e.p;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * \brief Tool entry point.
+ *
+ * \param argc Number of arguments.
+ * \param argv Arguments.
+ * \return EXIT_SUCCESS if success.
+ */
+int main(int argc, const char** argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << *argv << " FILE [PREFIX...]\n"
+                  << "Prefixes: file line function time thread type_name. "
+                  << "Defaults to file line." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Prefixes
+    gl::prefix p = gl::prefix::FILE | gl::prefix::LINE;
+    if (argc > 2) {
+        p = gl::prefix::NONE;
+        for (int i = 2; i < argc; ++i) {
+            gl::prefix q = gl::prefix::NONE;
+            if (!parse_prefix(argv[i], q)) {
+                std::cerr << "Unknown prefix '" << argv[i] << '\'' << std::endl;
+                return EXIT_FAILURE;
+            }
+            p |= q;
+        }
+    }
+
+    std::ifstream in(argv[1], std::ios_base::binary);
+    if (!in) {
+        std::cerr << "Failed to open '" << argv[1] << '\'' << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    try {
+        gl::decode_binary(in, std::cout, p);
+    } catch (const std::runtime_error& e) {
+        std::cout.flush();
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,39 @@
+#include "goinglogging.h"
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+/**
+ * \file
+ * Write output of a gl::RingFileSink in order, oldest first.
+ */
+
+/**
+ * \brief Tool entry point.
+ *
+ * \param argc Number of arguments.
+ * \param argv Arguments.
+ * \return EXIT_SUCCESS if success.
+ */
+int main(int argc, const char** argv) {
+    if (argc != 2) {
+        std::cerr << "Usage: " << *argv << " FILE" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::ifstream in(argv[1], std::ios_base::binary);
+    if (!in) {
+        std::cerr << "Failed to open '" << argv[1] << '\'' << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    try {
+        gl::read_ring(in, std::cout);
+    } catch (const std::runtime_error& e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}